@@ -54,9 +54,47 @@ namespace xt
             }
         }
 
+        void randn_assign_xtensor(benchmark::State& state)
+        {
+            for (auto _ : state)
+            {
+                xtensor<double, 1> result = xt::random::randn<double>({100000});
+                benchmark::DoNotOptimize(result.data());
+            }
+        }
+
+        void randn_assign_philox(benchmark::State& state)
+        {
+            xt::random::philox4x32 engine(0);
+            for (auto _ : state)
+            {
+                xtensor<double, 1> result = xt::random::randn<double>({100000}, 0., 1., engine);
+                benchmark::DoNotOptimize(result.data());
+            }
+        }
+
+        void randn_assign_forloop(benchmark::State& state)
+        {
+            for (auto _ : state)
+            {
+                xtensor<double, 1> result;
+                result.resize({100000});
+                std::normal_distribution<double> dist(0, 1);
+                auto& engine = xt::random::get_default_random_engine();
+                for (auto& el : result.storage())
+                {
+                    el = dist(engine);
+                }
+                benchmark::DoNotOptimize(result.data());
+            }
+        }
+
         BENCHMARK(random_assign_xarray);
         BENCHMARK(random_assign_xtensor);
         BENCHMARK(random_assign_forloop);
+        BENCHMARK(randn_assign_xtensor);
+        BENCHMARK(randn_assign_philox);
+        BENCHMARK(randn_assign_forloop);
     }
 }
 
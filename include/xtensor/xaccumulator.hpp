@@ -10,11 +10,19 @@
 #define XTENSOR_ACCUMULATOR_HPP
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <functional>
 #include <numeric>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "xexpression.hpp"
+#include "xiterable.hpp"
+#include "xiterator.hpp"
+#include "xparallel.hpp"
+#include "xstorage.hpp"
 #include "xstrides.hpp"
 #include "xtensor_forward.hpp"
 
@@ -23,6 +31,10 @@ namespace xt
 
 #define DEFAULT_STRATEGY_ACCUMULATORS evaluation_strategy::immediate
 
+    // Defined in xmanipulation.hpp
+    template <layout_type L, class E>
+    auto ravel(E&& e);
+
     /**************
      * accumulate *
      **************/
@@ -68,20 +80,274 @@ namespace xt
         return accumulator_type(std::forward<RF>(accumulate_func), std::forward<IF>(init_func));
     }
 
-    namespace detail
+    /***************************
+     * accumulator_scan_traits *
+     ***************************/
+
+    /**
+     * Traits class telling if an accumulation functor is associative.
+     * Specializations derive from std::true_type and provide the identity
+     * element of the functor as a static identity method, and a merge_functor
+     * type combining the accumulated values of two consecutive ranges.
+     * Accumulations of such functors are computed with blocked prefix scans,
+     * whose blocks are processed in parallel on long axes when a parallel
+     * backend is enabled. Since the operations are reassociated, floating
+     * point results may differ in the last bits from a sequential accumulation.
+     */
+    template <class F>
+    struct accumulator_scan_traits : std::false_type
+    {
+    };
+
+    template <class T>
+    struct accumulator_scan_traits<std::plus<T>> : std::true_type
     {
-        template <class F, class E, class EVS>
-        xarray<typename std::decay_t<E>::value_type> accumulator_impl(F&&, E&&, std::size_t, EVS)
+        using merge_functor = std::plus<T>;
+
+        static constexpr T identity()
         {
-            static_assert(!std::is_same<evaluation_strategy::lazy, EVS>::value, "Lazy accumulators not yet implemented.");
+            return T(0);
         }
+    };
+
+    template <class T>
+    struct accumulator_scan_traits<std::multiplies<T>> : std::true_type
+    {
+        using merge_functor = std::multiplies<T>;
 
-        template <class F, class E, class EVS>
-        xarray<typename std::decay_t<E>::value_type> accumulator_impl(F&&, E&&, EVS)
+        static constexpr T identity()
         {
-            static_assert(!std::is_same<evaluation_strategy::lazy, EVS>::value, "Lazy accumulators not yet implemented.");
+            return T(1);
         }
+    };
+
+    /*************************
+     * xaccumulator extension *
+     *************************/
+
+    namespace extension
+    {
+        template <class Tag, class F, class CT>
+        struct xaccumulator_base_impl;
+
+        template <class F, class CT>
+        struct xaccumulator_base_impl<xtensor_expression_tag, F, CT>
+        {
+            using type = xtensor_empty_base;
+        };
+
+        template <class F, class CT>
+        struct xaccumulator_base
+            : xaccumulator_base_impl<xexpression_tag_t<CT>, F, CT>
+        {
+        };
+
+        template <class F, class CT>
+        using xaccumulator_base_t = typename xaccumulator_base<F, CT>::type;
+    }
+
+    /****************
+     * xaccumulator *
+     ****************/
+
+    template <class F, class CT>
+    class xaccumulator;
+
+    template <class F, class CT>
+    class xaccumulator_stepper;
+
+    template <class F, class CT>
+    struct xiterable_inner_types<xaccumulator<F, CT>>
+    {
+        using xexpression_type = std::decay_t<CT>;
+        using inner_shape_type = std::decay_t<decltype(std::declval<xexpression_type>().shape())>;
+        using const_stepper = xaccumulator_stepper<F, CT>;
+        using stepper = const_stepper;
+    };
+
+    /**
+     * @class xaccumulator
+     * @brief Lazy accumulation of an expression along an axis.
+     *
+     * The xaccumulator class implements an \ref xexpression whose elements
+     * are the cumulative results of an accumulating function along an axis
+     * of an \ref xexpression. It is returned by the accumulating functions
+     * called with evaluation_strategy::lazy, and has the shape of the
+     * accumulated expression.
+     *
+     * Nothing is computed before the elements are accessed. The steppers
+     * keep the accumulated value of their current position, so that an
+     * assignment moving along the accumulation axis costs a single call to
+     * the accumulating function per element, and an assignment moving along
+     * the other axes updates a cached line of accumulated values. An
+     * element accessed alone with operator() or element is accumulated
+     * from the beginning of its lane along the axis only.
+     *
+     * @tparam F a tuple of functors (class \ref xaccumulator_functor or compatible)
+     * @tparam CT the closure type of the \ref xexpression to accumulate
+     *
+     * @sa accumulate
+     */
+    template <class F, class CT>
+    class xaccumulator : public xexpression<xaccumulator<F, CT>>,
+                         public xconst_iterable<xaccumulator<F, CT>>,
+                         public extension::xaccumulator_base_t<F, CT>
+    {
+    public:
+
+        using self_type = xaccumulator<F, CT>;
+        using accumulate_functor_type = typename std::decay_t<F>::accumulate_functor_type;
+        using init_functor_type = typename std::decay_t<F>::init_functor_type;
+        using xexpression_type = std::decay_t<CT>;
+
+        using extension_base = extension::xaccumulator_base_t<F, CT>;
+        using expression_tag = typename extension_base::expression_tag;
+
+        using substepper_type = typename xexpression_type::const_stepper;
+        using value_type = std::decay_t<decltype(std::declval<accumulate_functor_type>()(
+            std::declval<init_functor_type>()(*std::declval<substepper_type>()), *std::declval<substepper_type>()))>;
+        using reference = value_type;
+        using const_reference = value_type;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+
+        using size_type = typename xexpression_type::size_type;
+        using difference_type = typename xexpression_type::difference_type;
+
+        using iterable_base = xconst_iterable<self_type>;
+        using inner_shape_type = typename iterable_base::inner_shape_type;
+        using shape_type = inner_shape_type;
+
+        using stepper = typename iterable_base::stepper;
+        using const_stepper = typename iterable_base::const_stepper;
+
+        static constexpr layout_type static_layout = layout_type::dynamic;
+        static constexpr bool contiguous_layout = false;
+
+        template <class Func, class CTA>
+        xaccumulator(Func&& func, CTA&& e, size_type axis);
+
+        size_type size() const noexcept;
+        size_type dimension() const noexcept;
+        const inner_shape_type& shape() const noexcept;
+        layout_type layout() const noexcept;
+        size_type axis() const noexcept;
+
+        template <class... Args>
+        const_reference operator()(Args... args) const;
+        template <class... Args>
+        const_reference at(Args... args) const;
+        template <class... Args>
+        const_reference unchecked(Args... args) const;
+        template <class S>
+        disable_integral_t<S, const_reference> operator[](const S& index) const;
+        template <class I>
+        const_reference operator[](std::initializer_list<I> index) const;
+        const_reference operator[](size_type i) const;
 
+        template <class It>
+        const_reference element(It first, It last) const;
+
+        const xexpression_type& expression() const noexcept;
+
+        template <class S>
+        bool broadcast_shape(S& shape, bool reuse_cache = false) const;
+
+        template <class S>
+        bool has_linear_assign(const S& strides) const noexcept;
+
+        template <class S>
+        const_stepper stepper_begin(const S& shape) const noexcept;
+        template <class S>
+        const_stepper stepper_end(const S& shape, layout_type) const noexcept;
+
+    private:
+
+        value_type accumulate_back(substepper_type stepper, size_type n) const;
+        template <class L>
+        void accumulate_line(L& line, substepper_type& stepper, size_type first, size_type last,
+                             size_type rows, bool init) const;
+        template <class Func>
+        void walk_line(substepper_type& stepper, size_type first, size_type last, Func&& func) const;
+
+        CT m_e;
+        accumulate_functor_type m_accumulate;
+        init_functor_type m_init;
+        size_type m_axis;
+
+        friend class xaccumulator_stepper<F, CT>;
+    };
+
+    /************************
+     * xaccumulator_stepper *
+     ************************/
+
+    template <class F, class CT>
+    class xaccumulator_stepper
+    {
+    public:
+
+        using self_type = xaccumulator_stepper<F, CT>;
+        using xaccumulator_type = xaccumulator<F, CT>;
+
+        using value_type = typename xaccumulator_type::value_type;
+        using reference = typename xaccumulator_type::value_type;
+        using pointer = typename xaccumulator_type::const_pointer;
+        using size_type = typename xaccumulator_type::size_type;
+        using difference_type = typename xaccumulator_type::difference_type;
+
+        using xexpression_type = typename xaccumulator_type::xexpression_type;
+        using substepper_type = typename xaccumulator_type::substepper_type;
+        using shape_type = typename xaccumulator_type::shape_type;
+        using index_type = xindex_type_t<shape_type>;
+
+        xaccumulator_stepper(const xaccumulator_type& acc, size_type offset, bool end = false,
+                             layout_type l = XTENSOR_DEFAULT_LAYOUT);
+
+        reference operator*() const;
+
+        void step(size_type dim);
+        void step_back(size_type dim);
+        void step(size_type dim, size_type n);
+        void step_back(size_type dim, size_type n);
+        void reset(size_type dim);
+        void reset_back(size_type dim);
+
+        void to_begin();
+        void to_end(layout_type l);
+
+    private:
+
+        bool is_broadcast(size_type dim) const noexcept;
+        void moved(size_type d, size_type old_index, bool stepped) noexcept;
+        bool is_line_dim(size_type d) const noexcept;
+        value_type line_value() const;
+        substepper_type line_stepper(size_type k) const;
+
+        const xaccumulator_type* p_acc;
+        size_type m_offset;
+        substepper_type m_stepper;
+        index_type m_index;
+        mutable value_type m_value;
+        mutable bool m_valid;
+        // The line holds the accumulated values of the elements whose indices
+        // along [m_line_first, m_line_last) vary, the other ones being those of
+        // m_line_index. These dimensions are the ones stepped the most on one
+        // side of the axis, so that traversals moving across the axis reuse
+        // the accumulation of the previous position along the axis.
+        size_type m_line_first;
+        size_type m_line_last;
+        size_type m_last_step;
+        mutable std::vector<value_type> m_line;
+        mutable index_type m_line_index;
+        mutable bool m_line_valid;
+        mutable bool m_line_current;
+        mutable size_type m_line_pos;
+        index_type m_line_strides;
+    };
+
+    namespace detail
+    {
         template <class T, class R>
         struct xaccumulator_return_type
         {
@@ -139,50 +405,211 @@ namespace xt
         template <class T, class R>
         using xaccumulator_linear_return_type_t = typename xaccumulator_linear_return_type<T, R>::type;
 
-        template <class F, class E>
-        inline auto accumulator_init_with_f(F&& f, E& e, std::size_t axis)
+        /****************
+         * prefix scans *
+         ****************/
+
+        template <class T, class It, class F>
+        inline T scan_serial(It in, T* out, std::size_t n, T acc, const F& f)
         {
-            // this function is the equivalent (but hopefully faster) to (if axis == 1)
-            // e[:, 0, :, :, ...] = f(e[:, 0, :, :, ...])
-            // so that all "first" values are initialized in a first pass
+            for (std::size_t i = 0; i < n; ++i, ++in)
+            {
+                acc = f(acc, static_cast<T>(*in));
+                out[i] = acc;
+            }
+            return acc;
+        }
 
-            std::size_t outer_loop_size, inner_loop_size, pos = 0;
-            std::size_t outer_stride, inner_stride;
+        // Accumulates n elements starting from the identity of the functor,
+        // with independent accumulators merged at the end
+        template <class T, class S, class It, class F>
+        inline T scan_total(It in, std::size_t n, const F& f)
+        {
+            typename S::merge_functor merge;
+            std::array<T, 4> acc;
+            acc.fill(S::identity());
+            std::size_t i = 0;
+            for (; i + 4 <= n; i += 4)
+            {
+                for (std::size_t k = 0; k < 4; ++k, ++in)
+                {
+                    acc[k] = f(acc[k], static_cast<T>(*in));
+                }
+            }
+            for (; i < n; ++i, ++in)
+            {
+                acc[0] = f(acc[0], static_cast<T>(*in));
+            }
+            return merge(merge(acc[0], acc[1]), merge(acc[2], acc[3]));
+        }
 
-            auto set_loop_sizes = [&outer_loop_size, &inner_loop_size](auto first, auto last, std::ptrdiff_t ax) {
-                outer_loop_size = std::accumulate(first, first + ax,
-                                                  std::size_t(1), std::multiplies<std::size_t>());
-                inner_loop_size = std::accumulate(first + ax + 1, last,
-                                                  std::size_t(1), std::multiplies<std::size_t>());
-            };
+        // Two-phase parallel scan: the totals of the chunks are computed in
+        // parallel, then every chunk is scanned from its carry.
+        template <class T, class It, class F>
+        inline void parallel_scan_from(It in, T* out, std::size_t n, T acc, const F& f, std::false_type)
+        {
+            scan_serial(in, out, n, acc, f);
+        }
 
-            // Note: add check that strides > 0
-            auto set_loop_strides = [&outer_stride, &inner_stride](auto first, auto last, std::ptrdiff_t ax) {
-                outer_stride = static_cast<std::size_t>(ax == 0 ? 1 : *std::min_element(first, first + ax));
-                inner_stride = static_cast<std::size_t>((ax == std::distance(first, last) - 1) ? 1 : *std::min_element(first + ax + 1, last));
-            };
+        template <class T, class It, class F>
+        inline void parallel_scan_from(It in, T* out, std::size_t n, T acc, const F& f, std::true_type)
+        {
+            using traits = accumulator_scan_traits<F>;
+            std::size_t chunk = balanced_grain(n);
+            std::size_t n_chunks = (n + chunk - 1) / chunk;
+            std::vector<T> carries(n_chunks, acc);
+            parallel_for(0, n_chunks - 1, 1, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    carries[c + 1] = scan_total<T, traits>(in + static_cast<std::ptrdiff_t>(c * chunk), chunk, f);
+                }
+            });
+            typename traits::merge_functor merge;
+            for (std::size_t c = 1; c < n_chunks; ++c)
+            {
+                carries[c] = merge(carries[c - 1], carries[c]);
+            }
+            parallel_for(0, n_chunks, 1, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    std::size_t offset = c * chunk;
+                    scan_serial(in + static_cast<std::ptrdiff_t>(offset), out + offset, std::min(chunk, n - offset),
+                                carries[c], f);
+                }
+            });
+        }
+
+        // Scans the n contiguous elements of a line, the first one being
+        // initialized with the init functor.
+        template <class T, class It, class F>
+        inline void scan_line(It in, T* out, std::size_t n, const F& f, bool parallel)
+        {
+            if (n == 0)
+            {
+                return;
+            }
+            const auto& accumulate_fct = std::get<0>(f);
+            using traits = accumulator_scan_traits<std::decay_t<decltype(accumulate_fct)>>;
+            T acc = std::get<1>(f)(static_cast<T>(*in));
+            out[0] = acc;
+            ++in;
+            if (parallel)
+            {
+                parallel_scan_from(in, out + 1, n - 1, acc, accumulate_fct, traits());
+            }
+            else
+            {
+                scan_serial(in, out + 1, n - 1, acc, accumulate_fct);
+            }
+        }
 
-            set_loop_sizes(e.shape().begin(), e.shape().end(), static_cast<std::ptrdiff_t>(axis));
-            set_loop_strides(e.strides().begin(), e.strides().end(), static_cast<std::ptrdiff_t>(axis));
+        // Scans a row-major block of n rows of inner elements along its first
+        // dimension: out[k, i] = f(out[k - 1, i], in[k, i]) for i in [i0, i1).
+        template <class T, class It, class F>
+        inline void scan_columns(It in, T* out, std::size_t n, std::size_t inner,
+                                 std::size_t i0, std::size_t i1, const F& f)
+        {
+            const auto& accumulate_fct = std::get<0>(f);
+            const auto& init_fct = std::get<1>(f);
+            It it = in + static_cast<std::ptrdiff_t>(i0);
+            for (std::size_t i = i0; i < i1; ++i, ++it)
+            {
+                out[i] = init_fct(static_cast<T>(*it));
+            }
+            for (std::size_t k = 1; k < n; ++k)
+            {
+                const T* prev = out + (k - 1) * inner;
+                T* cur = out + k * inner;
+                it = in + static_cast<std::ptrdiff_t>(k * inner + i0);
+                for (std::size_t i = i0; i < i1; ++i, ++it)
+                {
+                    cur[i] = accumulate_fct(prev[i], static_cast<T>(*it));
+                }
+            }
+        }
 
-            if (e.layout() == layout_type::column_major)
+        // Scans result along axis, reading the elements from the iterator in,
+        // which visits them in the order of the storage of result.
+        template <class F, class It, class R>
+        inline void scan_axis(F&& f, It in, R& result, std::size_t axis, bool parallel_safe)
+        {
+            using value_type = typename R::value_type;
+            const auto& shape = result.shape();
+            std::size_t n = static_cast<std::size_t>(shape[axis]);
+            auto first = shape.cbegin();
+            auto ax = first + static_cast<std::ptrdiff_t>(axis);
+            std::size_t before = std::accumulate(first, ax, std::size_t(1), std::multiplies<std::size_t>());
+            std::size_t after = std::accumulate(ax + 1, shape.cend(), std::size_t(1), std::multiplies<std::size_t>());
+            bool row_major = result.layout() == layout_type::row_major;
+            std::size_t outer = row_major ? before : after;
+            std::size_t inner = row_major ? after : before;
+            std::size_t size = outer * n * inner;
+            if (size == 0)
             {
-                // swap for better memory locality (smaller stride in the inner loop)
-                std::swap(outer_loop_size, inner_loop_size);
-                std::swap(outer_stride, inner_stride);
+                return;
             }
 
-            for (std::size_t i = 0; i < outer_loop_size; ++i)
+            value_type* out = result.data();
+            bool parallel = parallel_safe && use_parallel(size);
+            std::size_t line_size = n * inner;
+            if (inner == 1)
+            {
+                if (!parallel || outer >= num_threads())
+                {
+                    parallel_for(0, outer, parallel ? balanced_grain(outer) : outer, [&](std::size_t o_first, std::size_t o_last)
+                    {
+                        for (std::size_t o = o_first; o < o_last; ++o)
+                        {
+                            scan_line(in + static_cast<std::ptrdiff_t>(o * n), out + o * n, n, f, false);
+                        }
+                    });
+                }
+                else
+                {
+                    for (std::size_t o = 0; o < outer; ++o)
+                    {
+                        scan_line(in + static_cast<std::ptrdiff_t>(o * n), out + o * n, n, f, true);
+                    }
+                }
+            }
+            else
             {
-                pos = i * outer_stride;
-                for (std::size_t j = 0; j < inner_loop_size; ++j)
+                // the inner elements are split in blocks when there are not
+                // enough lines to keep the threads busy
+                std::size_t n_blocks = 1;
+                if (parallel && outer < 4 * num_threads())
                 {
-                    e.storage()[pos] = f(e.storage()[pos]);
-                    pos += inner_stride;
+                    n_blocks = std::min(inner, (4 * num_threads() + outer - 1) / outer);
                 }
+                std::size_t block = (inner + n_blocks - 1) / n_blocks;
+                std::size_t n_tasks = outer * n_blocks;
+                parallel_for(0, n_tasks, parallel ? balanced_grain(n_tasks) : n_tasks, [&](std::size_t t_first, std::size_t t_last)
+                {
+                    for (std::size_t t = t_first; t < t_last; ++t)
+                    {
+                        std::size_t o = t / n_blocks;
+                        std::size_t i0 = (t % n_blocks) * block;
+                        std::size_t offset = o * line_size;
+                        scan_columns(in + static_cast<std::ptrdiff_t>(offset), out + offset, n, inner,
+                                     i0, std::min(inner, i0 + block), f);
+                    }
+                });
             }
         }
 
+        // Checks if the linear iterator of e visits its elements in the
+        // order of a storage with the given layout
+        template <class E>
+        inline bool has_linear_scan_input(const E& e, layout_type l)
+        {
+            using strides_type = svector<std::ptrdiff_t, 4>;
+            strides_type strides = xtl::make_sequence<strides_type>(e.dimension(), std::ptrdiff_t(0));
+            compute_strides(e.shape(), l, strides);
+            return e.has_linear_assign(strides);
+        }
+
         template <class F, class E>
         inline auto accumulator_impl(F&& f, E&& e, std::size_t axis, evaluation_strategy::immediate)
         {
@@ -195,53 +622,18 @@ namespace xt
                 throw std::runtime_error("Axis larger than expression dimension in accumulator.");
             }
 
-            result_type result = e;  // assign + make a copy, we need it anyways
-
-            std::size_t inner_stride = static_cast<std::size_t>(result.strides()[axis]);
-            std::size_t outer_stride = 1;  // this is either going row- or column-wise (strides.back / strides.front)
-            std::size_t outer_loop_size = 0;
-            std::size_t inner_loop_size = 0;
-
-            auto set_loop_sizes = [&outer_loop_size, &inner_loop_size](auto first, auto last, std::ptrdiff_t ax) {
-                outer_loop_size = std::accumulate(first,
-                                                  first + ax,
-                                                  std::size_t(1), std::multiplies<std::size_t>());
-
-                inner_loop_size = std::accumulate(first + ax,
-                                                  last,
-                                                  std::size_t(1), std::multiplies<std::size_t>());
-            };
-
-            if (result_type::static_layout == layout_type::row_major)
+            result_type result;
+            result.resize(e.shape(), uninitialized);
+            if (has_linear_scan_input(e, result.layout()))
             {
-                set_loop_sizes(result.shape().cbegin(), result.shape().cend(), static_cast<std::ptrdiff_t>(axis));
+                // the copy of the input is fused in the scan
+                scan_axis(f, linear_begin(e), result, axis, is_parallel_safe<std::decay_t<E>>::value);
             }
             else
             {
-                set_loop_sizes(result.shape().cbegin(), result.shape().cend(), static_cast<std::ptrdiff_t>(axis + 1));
-                std::swap(inner_loop_size, outer_loop_size);
-            }
-
-            std::size_t pos = 0;
-
-            inner_loop_size = inner_loop_size - inner_stride;
-
-            // activate the init loop if we have an init function other than identity
-            if (!std::is_same<decltype(std::get<1>(f)), xtl::identity>::value)
-            {
-                accumulator_init_with_f(std::get<1>(f), result, axis);
-            }
-
-            pos = 0;
-            for (std::size_t i = 0; i < outer_loop_size; ++i)
-            {
-                for (std::size_t j = 0; j < inner_loop_size; ++j)
-                {
-                    result.storage()[pos + inner_stride] = std::get<0>(f)(result.storage()[pos],
-                                                                          result.storage()[pos + inner_stride]);
-                    pos += outer_stride;
-                }
-                pos += inner_stride;
+                result.assign_xexpression(e);
+                const function_return_type* in = result.data();
+                scan_axis(f, in, result, axis, true);
             }
             return result;
         }
@@ -254,31 +646,50 @@ namespace xt
 
             using result_type = xaccumulator_linear_return_type_t<std::decay_t<E>, T>;
             std::size_t sz = e.size();
-            auto result = result_type::from_shape({sz});
-
-            auto it = e.template begin<XTENSOR_DEFAULT_LAYOUT>();
+            auto result = result_type::from_shape({sz}, uninitialized);
 
-            result.storage()[0] = std::get<1>(f)(*it);
-            ++it;
-
-            for (std::size_t idx = 0; it != e.template end<XTENSOR_DEFAULT_LAYOUT>(); ++it)
+            bool parallel = is_parallel_safe<std::decay_t<E>>::value && use_parallel(sz);
+            if (has_linear_scan_input(e, XTENSOR_DEFAULT_LAYOUT))
+            {
+                scan_line(linear_begin(e), result.data(), sz, f, parallel);
+            }
+            else
             {
-                result.storage()[idx + 1] = std::get<0>(f)(result.storage()[idx], *it);
-                ++idx;
+                scan_line(e.template cbegin<XTENSOR_DEFAULT_LAYOUT>(), result.data(), sz, f, parallel);
             }
             return result;
         }
+
+        template <class F, class E>
+        inline auto accumulator_impl(F&& f, E&& e, std::size_t axis, evaluation_strategy::lazy)
+        {
+            if (axis >= e.dimension())
+            {
+                throw std::runtime_error("Axis larger than expression dimension in accumulator.");
+            }
+            using accumulator_type = xaccumulator<std::decay_t<F>, const_xclosure_t<E>>;
+            return accumulator_type(std::forward<F>(f), std::forward<E>(e), axis);
+        }
+
+        template <class F, class E>
+        inline auto accumulator_impl(F&& f, E&& e, evaluation_strategy::lazy)
+        {
+            return accumulator_impl(std::forward<F>(f), ravel<XTENSOR_DEFAULT_LAYOUT>(std::forward<E>(e)),
+                                    std::size_t(0), evaluation_strategy::lazy());
+        }
     }
 
     /**
      * Accumulate and flatten array
-     * **NOTE** This function is not lazy!
+     * The accumulation is computed immediately unless \c evaluation_strategy
+     * is evaluation_strategy::lazy, in which case an xaccumulator over the
+     * flattened expression is returned.
      *
      * @param f functor to use for accumulation
      * @param e xexpression to be accumulated
      * @param evaluation_strategy evaluation strategy of the accumulation
      *
-     * @return returns xarray<T> filled with accumulated values
+     * @return returns xarray<T> filled with accumulated values, or an xaccumulator
      */
     template <class F, class E, class EVS = DEFAULT_STRATEGY_ACCUMULATORS,
               typename std::enable_if_t<!std::is_integral<EVS>::value, int> = 0>
@@ -291,14 +702,15 @@ namespace xt
 
     /**
      * Accumulate over axis
-     * **NOTE** This function is not lazy!
+     * The accumulation is computed immediately unless \c evaluation_strategy
+     * is evaluation_strategy::lazy, in which case an xaccumulator is returned.
      *
      * @param f Functor to use for accumulation
      * @param e xexpression to accumulate
      * @param axis Axis to perform accumulation over
      * @param evaluation_strategy evaluation strategy of the accumulation
      *
-     * @return returns xarray<T> filled with accumulated values
+     * @return returns xarray<T> filled with accumulated values, or an xaccumulator
      */
     template <class F, class E, class EVS = DEFAULT_STRATEGY_ACCUMULATORS>
     inline auto accumulate(F&& f, E&& e, std::ptrdiff_t axis, EVS evaluation_strategy = EVS())
@@ -306,6 +718,589 @@ namespace xt
         std::size_t ax = normalize_axis(e.dimension(), axis);
         return detail::accumulator_impl(std::forward<F>(f), std::forward<E>(e), ax, evaluation_strategy);
     }
+
+    /*******************************
+     * xaccumulator implementation *
+     *******************************/
+
+    /**
+     * @name Constructor
+     */
+    //@{
+    /**
+     * Constructs an xaccumulator expression accumulating the given
+     * expression along the given axis.
+     *
+     * @param func the tuple of the accumulating and initializing functions
+     * @param e the expression to accumulate
+     * @param axis the axis along which the accumulation is performed
+     */
+    template <class F, class CT>
+    template <class Func, class CTA>
+    inline xaccumulator<F, CT>::xaccumulator(Func&& func, CTA&& e, size_type axis)
+        : m_e(std::forward<CTA>(e))
+        , m_accumulate(std::get<0>(func))
+        , m_init(std::get<1>(func))
+        , m_axis(axis)
+    {
+    }
+    //@}
+
+    /**
+     * @name Size and shape
+     */
+    /**
+     * Returns the size of the expression.
+     */
+    template <class F, class CT>
+    inline auto xaccumulator<F, CT>::size() const noexcept -> size_type
+    {
+        return compute_size(shape());
+    }
+
+    /**
+     * Returns the number of dimensions of the expression.
+     */
+    template <class F, class CT>
+    inline auto xaccumulator<F, CT>::dimension() const noexcept -> size_type
+    {
+        return m_e.dimension();
+    }
+
+    /**
+     * Returns the shape of the expression.
+     */
+    template <class F, class CT>
+    inline auto xaccumulator<F, CT>::shape() const noexcept -> const inner_shape_type&
+    {
+        return m_e.shape();
+    }
+
+    /**
+     * Returns the layout of the expression.
+     */
+    template <class F, class CT>
+    inline layout_type xaccumulator<F, CT>::layout() const noexcept
+    {
+        return static_layout;
+    }
+
+    /**
+     * Returns the axis along which the expression is accumulated.
+     */
+    template <class F, class CT>
+    inline auto xaccumulator<F, CT>::axis() const noexcept -> size_type
+    {
+        return m_axis;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    /**
+     * Returns the element at the specified position in the accumulator.
+     * @param args a list of indices specifying the position in the accumulator. Indices
+     * must be unsigned integers, the number of indices should be equal or greater than
+     * the number of dimensions of the accumulator.
+     */
+    template <class F, class CT>
+    template <class... Args>
+    inline auto xaccumulator<F, CT>::operator()(Args... args) const -> const_reference
+    {
+        XTENSOR_TRY(check_index(shape(), args...));
+        XTENSOR_CHECK_DIMENSION(shape(), args...);
+        std::array<std::size_t, sizeof...(Args)> arg_array = {{static_cast<std::size_t>(args)...}};
+        return element(arg_array.cbegin(), arg_array.cend());
+    }
+
+    /**
+     * Returns the element at the specified position in the accumulator,
+     * after dimension and bounds checking.
+     * @param args a list of indices specifying the position in the accumulator. Indices
+     * must be unsigned integers, the number of indices should be equal to the number of dimensions
+     * of the accumulator.
+     * @exception std::out_of_range if the number of argument is greater than the number of dimensions
+     * or if indices are out of bounds.
+     */
+    template <class F, class CT>
+    template <class... Args>
+    inline auto xaccumulator<F, CT>::at(Args... args) const -> const_reference
+    {
+        check_access(shape(), static_cast<size_type>(args)...);
+        return this->operator()(args...);
+    }
+
+    /**
+     * Returns the element at the specified position in the accumulator.
+     * @param args a list of indices specifying the position in the accumulator. Indices
+     * must be unsigned integers, the number of indices must be equal to the number of
+     * dimensions of the accumulator, else the behavior is undefined.
+     */
+    template <class F, class CT>
+    template <class... Args>
+    inline auto xaccumulator<F, CT>::unchecked(Args... args) const -> const_reference
+    {
+        std::array<std::size_t, sizeof...(Args)> arg_array = {{static_cast<std::size_t>(args)...}};
+        return element(arg_array.cbegin(), arg_array.cend());
+    }
+
+    /**
+     * Returns the element at the specified position in the accumulator.
+     * @param index a sequence of indices specifying the position in the accumulator. Indices
+     * must be unsigned integers, the number of indices in the sequence should be equal or greater
+     * than the number of dimensions of the accumulator.
+     */
+    template <class F, class CT>
+    template <class S>
+    inline auto xaccumulator<F, CT>::operator[](const S& index) const
+        -> disable_integral_t<S, const_reference>
+    {
+        return element(index.cbegin(), index.cend());
+    }
+
+    template <class F, class CT>
+    template <class I>
+    inline auto xaccumulator<F, CT>::operator[](std::initializer_list<I> index) const
+        -> const_reference
+    {
+        return element(index.begin(), index.end());
+    }
+
+    template <class F, class CT>
+    inline auto xaccumulator<F, CT>::operator[](size_type i) const -> const_reference
+    {
+        return operator()(i);
+    }
+
+    /**
+     * Returns the element at the specified position in the accumulator.
+     * Only the lane of the element along the axis is accumulated, up to the
+     * element.
+     * @param first iterator starting the sequence of indices
+     * @param last iterator ending the sequence of indices
+     * The number of indices in the sequence should be equal to or greater
+     * than the number of dimensions of the accumulator.
+     */
+    template <class F, class CT>
+    template <class It>
+    inline auto xaccumulator<F, CT>::element(It first, It last) const -> const_reference
+    {
+        XTENSOR_TRY(check_element_index(shape(), first, last));
+        // Only the lane of the element is accumulated, not the line of
+        // the steppers
+        substepper_type stepper = m_e.stepper_begin(m_e.shape());
+        size_type dim = 0;
+        size_type axis_index = 0;
+        // drop left most elements
+        auto size = std::ptrdiff_t(dimension()) - std::distance(first, last);
+        auto begin = first - size;
+        while (begin != last)
+        {
+            size_type index = begin < first ? size_type(0) : static_cast<size_type>(*begin);
+            ++begin;
+            if (dim == m_axis)
+            {
+                axis_index = index;
+            }
+            stepper.step(dim++, index);
+        }
+        return accumulate_back(stepper, axis_index);
+    }
+
+    /**
+     * Returns a constant reference to the underlying expression of the accumulator.
+     */
+    template <class F, class CT>
+    inline auto xaccumulator<F, CT>::expression() const noexcept -> const xexpression_type&
+    {
+        return m_e;
+    }
+    //@}
+
+    /**
+     * @name Broadcasting
+     */
+    //@{
+    /**
+     * Broadcast the shape of the accumulator to the specified parameter.
+     * @param shape the result shape
+     * @param reuse_cache parameter for internal optimization
+     * @return a boolean indicating whether the broadcasting is trivial
+     */
+    template <class F, class CT>
+    template <class S>
+    inline bool xaccumulator<F, CT>::broadcast_shape(S& shape, bool) const
+    {
+        return xt::broadcast_shape(this->shape(), shape);
+    }
+
+    /**
+     * Checks whether the xaccumulator can be linearly assigned to an expression
+     * with the specified strides.
+     * @return a boolean indicating whether a linear assign is possible
+     */
+    template <class F, class CT>
+    template <class S>
+    inline bool xaccumulator<F, CT>::has_linear_assign(const S& /*strides*/) const noexcept
+    {
+        return false;
+    }
+    //@}
+
+    template <class F, class CT>
+    template <class S>
+    inline auto xaccumulator<F, CT>::stepper_begin(const S& shape) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(*this, offset);
+    }
+
+    template <class F, class CT>
+    template <class S>
+    inline auto xaccumulator<F, CT>::stepper_end(const S& shape, layout_type l) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(*this, offset, true, l);
+    }
+
+    // Accumulates the n elements preceding the position of stepper along the axis,
+    // and the element at this position
+    template <class F, class CT>
+    inline auto xaccumulator<F, CT>::accumulate_back(substepper_type stepper, size_type n) const -> value_type
+    {
+        stepper.step_back(m_axis, n);
+        value_type res = static_cast<value_type>(m_init(*stepper));
+        for (size_type i = 0; i < n; ++i)
+        {
+            stepper.step(m_axis);
+            res = m_accumulate(res, *stepper);
+        }
+        return res;
+    }
+
+    // Accumulates rows of the line of elements spanning the dimensions [first, last),
+    // starting from the position of stepper along the axis. The first row initializes
+    // the line if init is true. The loops follow the memory order of the expression:
+    // row by row if the line dimensions are inner to the axis, element by element
+    // otherwise.
+    template <class F, class CT>
+    template <class L>
+    inline void xaccumulator<F, CT>::accumulate_line(L& line, substepper_type& stepper, size_type first, size_type last,
+                                                     size_type rows, bool init) const
+    {
+        bool inner_line = (first > m_axis) == (m_e.layout() != layout_type::column_major);
+        if (inner_line)
+        {
+            for (size_type r = 0; r < rows; ++r)
+            {
+                if (r != 0)
+                {
+                    stepper.step(m_axis);
+                }
+                bool init_row = init && r == 0;
+                walk_line(stepper, first, last, [&line, init_row, this](size_type p, const substepper_type& st) {
+                    line[p] = init_row ? static_cast<value_type>(m_init(*st)) : m_accumulate(line[p], *st);
+                });
+            }
+        }
+        else
+        {
+            walk_line(stepper, first, last, [&line, rows, init, this](size_type p, substepper_type& st) {
+                value_type v = init ? static_cast<value_type>(m_init(*st)) : m_accumulate(line[p], *st);
+                for (size_type r = 1; r < rows; ++r)
+                {
+                    st.step(m_axis);
+                    v = m_accumulate(v, *st);
+                }
+                st.step_back(m_axis, rows - 1);
+                line[p] = v;
+            });
+        }
+    }
+
+    // Calls func(p, stepper) on the elements of the line spanning the dimensions
+    // [first, last), p being their row-major position in the line. The stepper
+    // starts on the first element and is moved back to it.
+    template <class F, class CT>
+    template <class Func>
+    inline void xaccumulator<F, CT>::walk_line(substepper_type& stepper, size_type first, size_type last, Func&& func) const
+    {
+        const auto& sh = shape();
+        size_type inner_dim = last - 1;
+        size_type inner_size = sh[inner_dim];
+        auto index = xtl::make_sequence<xindex_type_t<shape_type>>(dimension(), size_type(0));
+        size_type p = 0;
+        bool carry = true;
+        while (carry)
+        {
+            for (size_type i = 0; i < inner_size; ++i, ++p)
+            {
+                if (i != 0)
+                {
+                    stepper.step(inner_dim);
+                }
+                func(p, stepper);
+            }
+            stepper.reset(inner_dim);
+            carry = false;
+            for (size_type d = inner_dim; d-- > first;)
+            {
+                if (index[d] + 1 < sh[d])
+                {
+                    ++index[d];
+                    stepper.step(d);
+                    carry = true;
+                    break;
+                }
+                index[d] = 0;
+                stepper.reset(d);
+            }
+        }
+    }
+
+    /***************************************
+     * xaccumulator_stepper implementation *
+     ***************************************/
+
+    template <class F, class CT>
+    inline xaccumulator_stepper<F, CT>::xaccumulator_stepper(const xaccumulator_type& acc, size_type offset, bool end, layout_type l)
+        : p_acc(&acc), m_offset(offset),
+          m_stepper(acc.m_e.stepper_begin(acc.m_e.shape())),
+          m_index(xtl::make_sequence<index_type>(acc.dimension(), size_type(0))),
+          m_value(), m_valid(false),
+          m_line_first(0), m_line_last(0), m_last_step(acc.dimension()),
+          m_line(), m_line_index(m_index), m_line_valid(false), m_line_current(false),
+          m_line_pos(0), m_line_strides(m_index)
+    {
+        if (end)
+        {
+            to_end(l);
+        }
+    }
+
+    template <class F, class CT>
+    inline auto xaccumulator_stepper<F, CT>::operator*() const -> reference
+    {
+        if (!m_valid)
+        {
+            if (m_line_current)
+            {
+                m_value = m_line[m_line_pos];
+            }
+            else
+            {
+                m_value = m_line_first != m_line_last ? line_value()
+                                                      : p_acc->accumulate_back(m_stepper, m_index[p_acc->m_axis]);
+            }
+            m_valid = true;
+        }
+        return m_value;
+    }
+
+    template <class F, class CT>
+    inline void xaccumulator_stepper<F, CT>::step(size_type dim)
+    {
+        step(dim, 1);
+    }
+
+    template <class F, class CT>
+    inline void xaccumulator_stepper<F, CT>::step_back(size_type dim)
+    {
+        step_back(dim, 1);
+    }
+
+    template <class F, class CT>
+    inline void xaccumulator_stepper<F, CT>::step(size_type dim, size_type n)
+    {
+        if (is_broadcast(dim))
+        {
+            return;
+        }
+        size_type d = dim - m_offset;
+        if (d == p_acc->m_axis && m_valid && m_index[d] + n < p_acc->shape()[d])
+        {
+            // running accumulation along the axis
+            for (size_type i = 0; i < n; ++i)
+            {
+                m_stepper.step(d);
+                m_value = p_acc->m_accumulate(m_value, *m_stepper);
+            }
+            m_line_current = false;
+        }
+        else
+        {
+            m_stepper.step(d, n);
+            m_index[d] += n;
+            moved(d, m_index[d] - n, true);
+            return;
+        }
+        m_index[d] += n;
+    }
+
+    template <class F, class CT>
+    inline void xaccumulator_stepper<F, CT>::step_back(size_type dim, size_type n)
+    {
+        if (is_broadcast(dim))
+        {
+            return;
+        }
+        size_type d = dim - m_offset;
+        m_stepper.step_back(d, n);
+        m_index[d] -= n;
+        moved(d, m_index[d] + n, true);
+    }
+
+    template <class F, class CT>
+    inline void xaccumulator_stepper<F, CT>::reset(size_type dim)
+    {
+        if (is_broadcast(dim))
+        {
+            return;
+        }
+        size_type d = dim - m_offset;
+        m_stepper.reset(d);
+        size_type old_index = m_index[d];
+        m_index[d] = 0;
+        moved(d, old_index, false);
+    }
+
+    template <class F, class CT>
+    inline void xaccumulator_stepper<F, CT>::reset_back(size_type dim)
+    {
+        if (is_broadcast(dim))
+        {
+            return;
+        }
+        size_type d = dim - m_offset;
+        m_stepper.reset_back(d);
+        size_type old_index = m_index[d];
+        m_index[d] = p_acc->shape()[d] - 1;
+        moved(d, old_index, false);
+    }
+
+    template <class F, class CT>
+    inline void xaccumulator_stepper<F, CT>::to_begin()
+    {
+        m_stepper.to_begin();
+        std::fill(m_index.begin(), m_index.end(), size_type(0));
+        m_valid = false;
+        m_line_current = false;
+    }
+
+    template <class F, class CT>
+    inline void xaccumulator_stepper<F, CT>::to_end(layout_type l)
+    {
+        m_stepper.to_end(l);
+        std::copy(p_acc->shape().cbegin(), p_acc->shape().cend(), m_index.begin());
+        m_valid = false;
+        m_line_current = false;
+    }
+
+    template <class F, class CT>
+    inline bool xaccumulator_stepper<F, CT>::is_broadcast(size_type dim) const noexcept
+    {
+        return dim < m_offset || p_acc->shape()[dim - m_offset] == 1;
+    }
+
+    // Invalidates the current value, and selects the dimensions spanned by
+    // the line: those following the axis if the traversal steps them the
+    // most, those preceding it otherwise. The side of the line changes when
+    // a dimension of the other side is stepped twice in a row.
+    template <class F, class CT>
+    inline void xaccumulator_stepper<F, CT>::moved(size_type d, size_type old_index, bool stepped) noexcept
+    {
+        m_valid = false;
+        if (is_line_dim(d))
+        {
+            // wraps around when moving back, the result is still exact
+            m_line_pos += (m_index[d] - old_index) * m_line_strides[d];
+        }
+        else
+        {
+            m_line_current = false;
+        }
+        size_type axis = p_acc->m_axis;
+        if (stepped && d != axis)
+        {
+            if (!is_line_dim(d) && (m_line_first == m_line_last || m_last_step == d))
+            {
+                m_line_first = d > axis ? axis + 1 : 0;
+                m_line_last = d > axis ? p_acc->dimension() : axis;
+                m_line_valid = false;
+                size_type stride = 1;
+                for (size_type i = m_line_last; i-- > m_line_first;)
+                {
+                    m_line_strides[i] = stride;
+                    stride *= p_acc->shape()[i];
+                }
+            }
+            m_last_step = d;
+        }
+    }
+
+    template <class F, class CT>
+    inline bool xaccumulator_stepper<F, CT>::is_line_dim(size_type d) const noexcept
+    {
+        return m_line_first <= d && d < m_line_last;
+    }
+
+    template <class F, class CT>
+    inline auto xaccumulator_stepper<F, CT>::line_value() const -> value_type
+    {
+        const auto& sh = p_acc->shape();
+        size_type axis = p_acc->m_axis;
+        size_type k = m_index[axis];
+
+        if (!m_line_current)
+        {
+            bool same_line = m_line_valid && m_line_index[axis] <= k;
+            for (size_type d = 0; same_line && d < m_index.size(); ++d)
+            {
+                same_line = d == axis || is_line_dim(d) || m_index[d] == m_line_index[d];
+            }
+            if (!same_line)
+            {
+                size_type line_size = 1;
+                for (size_type d = m_line_first; d < m_line_last; ++d)
+                {
+                    line_size *= sh[d];
+                }
+                m_line.resize(line_size);
+                m_line_index = m_index;
+                substepper_type stepper = line_stepper(0);
+                p_acc->accumulate_line(m_line, stepper, m_line_first, m_line_last, k + 1, true);
+                m_line_valid = true;
+            }
+            else if (m_line_index[axis] < k)
+            {
+                substepper_type stepper = line_stepper(m_line_index[axis] + 1);
+                p_acc->accumulate_line(m_line, stepper, m_line_first, m_line_last, k - m_line_index[axis], false);
+                m_line_index[axis] = k;
+            }
+            m_line_pos = 0;
+            for (size_type d = m_line_first; d < m_line_last; ++d)
+            {
+                m_line_pos += m_index[d] * m_line_strides[d];
+            }
+            m_line_current = true;
+        }
+        return m_line[m_line_pos];
+    }
+
+    // Returns a stepper on the first element of the line at position k along the axis
+    template <class F, class CT>
+    inline auto xaccumulator_stepper<F, CT>::line_stepper(size_type k) const -> substepper_type
+    {
+        substepper_type stepper = m_stepper;
+        for (size_type d = m_line_first; d < m_line_last; ++d)
+        {
+            stepper.step_back(d, m_index[d]);
+        }
+        size_type axis = p_acc->m_axis;
+        stepper.step_back(axis, m_index[axis] - k);
+        return stepper;
+    }
 }
 
 #endif
@@ -0,0 +1,471 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ARENA_HPP
+#define XTENSOR_ARENA_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xtensor_config.hpp"
+
+#ifdef XTENSOR_USE_XSIMD
+#include <xsimd/xsimd.hpp>
+#endif
+
+#ifndef XTENSOR_ARENA_BLOCK_SIZE
+#define XTENSOR_ARENA_BLOCK_SIZE 1048576
+#endif
+
+namespace xt
+{
+    /**********
+     * xarena *
+     **********/
+
+    /**
+     * @class xarena
+     * @brief Monotonic memory arena.
+     *
+     * The arena allocates memory by bumping a pointer in blocks obtained
+     * from the heap, memory is only given back when the arena is reset or
+     * destroyed. The arena is not thread-safe.
+     */
+    class xarena
+    {
+    public:
+
+        explicit xarena(std::size_t block_size = XTENSOR_ARENA_BLOCK_SIZE);
+        ~xarena();
+
+        xarena(const xarena&) = delete;
+        xarena& operator=(const xarena&) = delete;
+
+        void* allocate(std::size_t size, std::size_t alignment);
+        void reset() noexcept;
+
+        std::size_t bytes_used() const noexcept;
+        std::size_t bytes_reserved() const noexcept;
+
+    private:
+
+        struct block
+        {
+            char* p_data;
+            std::size_t m_size;
+        };
+
+        void release() noexcept;
+
+        std::vector<block> m_blocks;
+        char* p_current;
+        char* p_end;
+        std::size_t m_block_size;
+        std::size_t m_bytes_used;
+        std::size_t m_bytes_reserved;
+    };
+
+    namespace detail
+    {
+#ifdef XTENSOR_USE_XSIMD
+        constexpr std::size_t arena_simd_alignment = XSIMD_DEFAULT_ALIGNMENT;
+#else
+        constexpr std::size_t arena_simd_alignment = 0;
+#endif
+        // Alignment of the buffers of arena_allocator, which is also the size
+        // of the header that records where a buffer comes from.
+        constexpr std::size_t arena_alignment = std::max(std::max(arena_simd_alignment, alignof(std::max_align_t)),
+                                                         2 * sizeof(void*));
+
+        // Arena of an arena_scope, reference counted by the scope and by the
+        // buffers allocated in it, so that a buffer that escapes the scope
+        // stays valid.
+        struct arena_resource
+        {
+            explicit arena_resource(std::size_t block_size)
+                : m_arena(block_size), m_refs(1), p_previous(nullptr)
+            {
+            }
+
+            void release() noexcept
+            {
+                if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    delete this;
+                }
+            }
+
+            xarena m_arena;
+            std::atomic<std::size_t> m_refs;
+            arena_resource* p_previous;
+        };
+
+        inline arena_resource*& current_arena() noexcept
+        {
+            static thread_local arena_resource* p_arena = nullptr;
+            return p_arena;
+        }
+
+        struct arena_header
+        {
+            arena_resource* p_arena;
+            void* p_heap;
+        };
+
+        inline void* arena_allocate(std::size_t size)
+        {
+            char* data;
+            arena_header header;
+            arena_resource* arena = current_arena();
+            if (arena != nullptr)
+            {
+                data = static_cast<char*>(arena->m_arena.allocate(size + arena_alignment, arena_alignment));
+                arena->m_refs.fetch_add(1, std::memory_order_relaxed);
+                header = {arena, nullptr};
+            }
+            else
+            {
+                void* raw = ::operator new(size + 2 * arena_alignment);
+                std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw);
+                data = reinterpret_cast<char*>((addr + arena_alignment) & ~(std::uintptr_t(arena_alignment) - 1));
+                header = {nullptr, raw};
+            }
+            ::new (data) arena_header(header);
+            return data + arena_alignment;
+        }
+
+        inline void arena_deallocate(void* p) noexcept
+        {
+            if (p != nullptr)
+            {
+                arena_header* header = reinterpret_cast<arena_header*>(static_cast<char*>(p) - arena_alignment);
+                if (header->p_arena != nullptr)
+                {
+                    header->p_arena->release();
+                }
+                else
+                {
+                    ::operator delete(header->p_heap);
+                }
+            }
+        }
+    }
+
+    /***************
+     * arena_scope *
+     ***************/
+
+    /**
+     * @class arena_scope
+     * @brief Routes the allocations of arena_allocator to an arena.
+     *
+     * While an arena_scope is alive, the buffers allocated with an
+     * arena_allocator by the thread that created the scope are taken from a
+     * monotonic arena owned by the scope, instead of the heap. Scopes can be
+     * nested, the innermost one is used. The memory of the arena is given
+     * back when the scope and all the buffers allocated in it are destroyed,
+     * so that containers moved out of the scope remain valid; such a
+     * container keeps all the blocks of the arena alive until it is
+     * destroyed. Results are better copied into containers allocated
+     * outside of the scope.
+     *
+     * Defining ``XTENSOR_DEFAULT_ALLOCATOR(T)`` to ``xt::arena_allocator<T>``
+     * and including this header before the other headers of xtensor routes
+     * all the temporaries of the containers (evaluations, assignments with
+     * aliasing, sort results...) to the current arena:
+     *
+     * @code{.cpp}
+     * #define XTENSOR_DEFAULT_ALLOCATOR(T) xt::arena_allocator<T>
+     * #include "xtensor/xarena.hpp"
+     * #include "xtensor/xarray.hpp"
+     *
+     * xt::xarray<double> res(shape);
+     * {
+     *     xt::arena_scope scope;
+     *     xt::noalias(res) = compute(a, b);
+     * }
+     * @endcode
+     */
+    class arena_scope
+    {
+    public:
+
+        explicit arena_scope(std::size_t block_size = XTENSOR_ARENA_BLOCK_SIZE);
+        ~arena_scope();
+
+        arena_scope(const arena_scope&) = delete;
+        arena_scope& operator=(const arena_scope&) = delete;
+
+        std::size_t bytes_used() const noexcept;
+        std::size_t bytes_reserved() const noexcept;
+
+    private:
+
+        detail::arena_resource* p_arena;
+    };
+
+    /*******************
+     * arena_allocator *
+     *******************/
+
+    /**
+     * @class arena_allocator
+     * @brief Allocator taking its memory from the current arena_scope.
+     *
+     * The allocator is stateless: the buffers are allocated in the arena of
+     * the innermost arena_scope of the calling thread, or on the heap when
+     * there is none. Every buffer records where it comes from, so it can be
+     * deallocated by any arena_allocator, from any thread. Deallocating a
+     * buffer of an arena does not reuse its memory before the arena is
+     * released.
+     *
+     * @tparam T the type of the allocated values
+     */
+    template <class T>
+    class arena_allocator
+    {
+    public:
+
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = arena_allocator<U>;
+        };
+
+        arena_allocator() noexcept = default;
+
+        template <class U>
+        arena_allocator(const arena_allocator<U>&) noexcept;
+
+        pointer allocate(size_type n);
+        void deallocate(pointer p, size_type n) noexcept;
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args);
+
+        template <class U>
+        void destroy(U* p);
+
+        size_type max_size() const noexcept;
+    };
+
+    template <class T, class U>
+    bool operator==(const arena_allocator<T>&, const arena_allocator<U>&) noexcept;
+
+    template <class T, class U>
+    bool operator!=(const arena_allocator<T>&, const arena_allocator<U>&) noexcept;
+
+    /*************************
+     * xarena implementation *
+     *************************/
+
+    /**
+     * Builds an empty arena.
+     * @param block_size the minimal size in bytes of the blocks allocated
+     * on the heap. The size of the blocks grows geometrically.
+     */
+    inline xarena::xarena(std::size_t block_size)
+        : p_current(nullptr), p_end(nullptr), m_block_size(std::max(block_size, std::size_t(64))),
+          m_bytes_used(0), m_bytes_reserved(0)
+    {
+    }
+
+    inline xarena::~xarena()
+    {
+        release();
+    }
+
+    /**
+     * Allocates \c size bytes aligned on \c alignment, which must be a power of 2.
+     */
+    inline void* xarena::allocate(std::size_t size, std::size_t alignment)
+    {
+        std::uintptr_t current = reinterpret_cast<std::uintptr_t>(p_current);
+        std::uintptr_t aligned = (current + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+        if (p_current == nullptr || aligned + size > reinterpret_cast<std::uintptr_t>(p_end))
+        {
+            std::size_t block_size = std::max(m_block_size, size + alignment);
+            char* data = static_cast<char*>(::operator new(block_size));
+            m_blocks.push_back({data, block_size});
+            m_bytes_reserved += block_size;
+            m_block_size *= 2;
+            p_current = data;
+            p_end = data + block_size;
+            current = reinterpret_cast<std::uintptr_t>(p_current);
+            aligned = (current + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+        }
+        p_current += (aligned - current) + size;
+        m_bytes_used += size;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    /**
+     * Gives back all the memory of the arena but its largest block, which is
+     * reused by the next allocations. The memory allocated before the reset
+     * must not be used anymore.
+     */
+    inline void xarena::reset() noexcept
+    {
+        if (!m_blocks.empty())
+        {
+            block last = m_blocks.back();
+            m_blocks.pop_back();
+            release();
+            m_blocks.push_back(last);
+            m_bytes_reserved = last.m_size;
+            p_current = last.p_data;
+            p_end = last.p_data + last.m_size;
+        }
+        m_bytes_used = 0;
+    }
+
+    /**
+     * Returns the number of bytes allocated in the arena.
+     */
+    inline std::size_t xarena::bytes_used() const noexcept
+    {
+        return m_bytes_used;
+    }
+
+    /**
+     * Returns the number of bytes of the blocks allocated on the heap.
+     */
+    inline std::size_t xarena::bytes_reserved() const noexcept
+    {
+        return m_bytes_reserved;
+    }
+
+    inline void xarena::release() noexcept
+    {
+        for (const auto& b : m_blocks)
+        {
+            ::operator delete(b.p_data);
+        }
+        m_blocks.clear();
+        p_current = nullptr;
+        p_end = nullptr;
+        m_bytes_reserved = 0;
+    }
+
+    /******************************
+     * arena_scope implementation *
+     ******************************/
+
+    /**
+     * Creates an arena and makes it the current arena of the calling thread.
+     * @param block_size the size in bytes of the first block of the arena
+     */
+    inline arena_scope::arena_scope(std::size_t block_size)
+        : p_arena(new detail::arena_resource(block_size))
+    {
+        p_arena->p_previous = detail::current_arena();
+        detail::current_arena() = p_arena;
+    }
+
+    /**
+     * Restores the previous arena of the calling thread, the memory of the
+     * arena is given back once the buffers allocated in it are destroyed.
+     */
+    inline arena_scope::~arena_scope()
+    {
+        detail::current_arena() = p_arena->p_previous;
+        p_arena->release();
+    }
+
+    /**
+     * Returns the number of bytes allocated in the arena of the scope.
+     */
+    inline std::size_t arena_scope::bytes_used() const noexcept
+    {
+        return p_arena->m_arena.bytes_used();
+    }
+
+    /**
+     * Returns the number of bytes of the blocks of the arena of the scope.
+     */
+    inline std::size_t arena_scope::bytes_reserved() const noexcept
+    {
+        return p_arena->m_arena.bytes_reserved();
+    }
+
+    /**********************************
+     * arena_allocator implementation *
+     **********************************/
+
+    template <class T>
+    template <class U>
+    inline arena_allocator<T>::arena_allocator(const arena_allocator<U>&) noexcept
+    {
+    }
+
+    template <class T>
+    inline auto arena_allocator<T>::allocate(size_type n) -> pointer
+    {
+        static_assert(alignof(T) <= detail::arena_alignment, "arena_allocator: over-aligned types are not supported");
+        if (n > max_size())
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<pointer>(detail::arena_allocate(n * sizeof(T)));
+    }
+
+    template <class T>
+    inline void arena_allocator<T>::deallocate(pointer p, size_type) noexcept
+    {
+        detail::arena_deallocate(p);
+    }
+
+    template <class T>
+    template <class U, class... Args>
+    inline void arena_allocator<T>::construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <class T>
+    template <class U>
+    inline void arena_allocator<T>::destroy(U* p)
+    {
+        p->~U();
+    }
+
+    template <class T>
+    inline auto arena_allocator<T>::max_size() const noexcept -> size_type
+    {
+        return (std::numeric_limits<size_type>::max() - 2 * detail::arena_alignment) / sizeof(T);
+    }
+
+    template <class T, class U>
+    inline bool operator==(const arena_allocator<T>&, const arena_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const arena_allocator<T>&, const arena_allocator<U>&) noexcept
+    {
+        return false;
+    }
+}
+
+#endif
@@ -104,6 +104,7 @@ namespace xt
         xarray_container();
         explicit xarray_container(const shape_type& shape, layout_type l = L);
         explicit xarray_container(const shape_type& shape, const_reference value, layout_type l = L);
+        explicit xarray_container(const shape_type& shape, uninitialized_t, layout_type l = L);
         explicit xarray_container(const shape_type& shape, const strides_type& strides);
         explicit xarray_container(const shape_type& shape, const strides_type& strides, const_reference value);
         explicit xarray_container(storage_type&& storage, inner_shape_type&& shape, inner_strides_type&& strides);
@@ -117,6 +118,8 @@ namespace xt
 
         template <class S = shape_type>
         static xarray_container from_shape(S&& s);
+        template <class S = shape_type>
+        static xarray_container from_shape(S&& s, uninitialized_t);
 
         ~xarray_container() = default;
 
@@ -281,6 +284,20 @@ namespace xt
         std::fill(m_storage.begin(), m_storage.end(), value);
     }
 
+    /**
+     * Allocates an xarray_container with the specified shape and layout_type.
+     * Elements are default-initialized rather than value-initialized, see
+     * uninitialized_t.
+     * @param shape the shape of the xarray_container
+     * @param l the layout_type of the xarray_container
+     */
+    template <class EC, layout_type L, class SC, class Tag>
+    inline xarray_container<EC, L, SC, Tag>::xarray_container(const shape_type& shape, uninitialized_t, layout_type l)
+        : base_type()
+    {
+        base_type::resize(shape, l, uninitialized);
+    }
+
     /**
      * Allocates an uninitialized xarray_container with the specified shape and strides.
      * @param shape the shape of the xarray_container
@@ -412,6 +429,19 @@ namespace xt
         return self_type(shape);
     }
 
+    /**
+     * Allocates and returns an xarray_container with the specified shape,
+     * without value-initializing its elements.
+     * @param s the shape of the xarray_container
+     */
+    template <class EC, layout_type L, class SC, class Tag>
+    template <class S>
+    inline xarray_container<EC, L, SC, Tag> xarray_container<EC, L, SC, Tag>::from_shape(S&& s, uninitialized_t)
+    {
+        shape_type shape = xtl::forward_sequence<shape_type, S>(s);
+        return self_type(shape, uninitialized);
+    }
+
     template <class EC, layout_type L, class SC, class Tag>
     template <std::size_t N>
     inline xarray_container<EC, L, SC, Tag>::xarray_container(xtensor_container<EC, N, L, Tag>&& rhs)
@@ -18,15 +18,13 @@
 #include "xconcepts.hpp"
 #include "xexpression.hpp"
 #include "xiterator.hpp"
+#include "xparallel.hpp"
+#include "xstorage.hpp"
 #include "xstrides.hpp"
 #include "xtensor_forward.hpp"
 #include "xutils.hpp"
 #include "xfunction.hpp"
 
-#if defined(XTENSOR_USE_TBB)
-#include <tbb/tbb.h>
-#endif
-
 namespace xt
 {
 
@@ -90,14 +88,11 @@ namespace xt
         template <class E1, class E2>
         static void assert_compatible_shape(const xexpression<E1>& e1, const xexpression<E2>& e2);
 
-    private:
-
         template <class E1, class E2>
         static bool resize(E1& e1, const E2& e2);
 
         template <class E1, class F, class... CT>
         static bool resize(E1& e1, const xfunction<F, CT...>& e2);
-
     };
 
     /********************
@@ -128,6 +123,8 @@ namespace xt
 
     private:
 
+        void run_range(size_type first, size_type last);
+
         E1& m_e1;
 
         lhs_iterator m_lhs;
@@ -179,6 +176,57 @@ namespace xt
         static void run(E1& e1, const E2& e2);
     };
 
+    /***********************
+     * transposed_assigner *
+     ***********************/
+
+    template <bool enabled>
+    class transposed_assigner
+    {
+    public:
+
+        template <class E1, class E2>
+        static bool check(const E1& e1, const E2& e2);
+
+        template <class E1, class E2>
+        static void assign(E1& e1, const E2& e2);
+
+        template <class E1, class E2>
+        static bool run(E1& e1, const E2& e2);
+    };
+
+    /*************************
+     * strided_data_assigner *
+     *************************/
+
+    namespace strided_assign_detail
+    {
+        // Loops of a strided assignment, from the outermost to the innermost
+        struct loop_nest
+        {
+            svector<std::size_t, 4> shape;
+            svector<std::ptrdiff_t, 4> dst_strides;
+            svector<std::ptrdiff_t, 4> src_strides;
+        };
+    }
+
+    template <bool enabled>
+    class strided_data_assigner
+    {
+    public:
+
+        using loop_nest = strided_assign_detail::loop_nest;
+
+        template <class E1, class E2>
+        static bool check(const E1& e1, const E2& e2, loop_nest& loops);
+
+        template <class E1, class E2>
+        static void assign(E1& e1, const E2& e2, const loop_nest& loops);
+
+        template <class E1, class E2>
+        static bool run(E1& e1, const E2& e2);
+    };
+
     /***********************************
      * Assign functions implementation *
      ***********************************/
@@ -258,6 +306,19 @@ namespace xt
         {
         };
 
+        template <class E, class = void>
+        struct has_strided_data : std::false_type
+        {
+        };
+
+        template <class E>
+        struct has_strided_data<E, void_t<decltype(std::declval<E&>().data()),
+                                          decltype(std::declval<E&>().data_offset()),
+                                          decltype(std::declval<E&>().strides())>>
+            : std::true_type
+        {
+        };
+
         template <class T>
         struct use_strided_loop
         {
@@ -278,6 +339,25 @@ namespace xt
             static constexpr bool value = xtl::conjunction<use_strided_loop<std::decay_t<CT>>...>::value &&
                                           xfunction<F, CT...>::has_simd_interface::value;
         };
+
+        /**
+         * Calls f on chunks of [first, last) from several threads if the
+         * evaluation of E can be parallelized and \c size (the number of
+         * elements to compute) is above XTENSOR_PARALLEL_THRESHOLD, calls
+         * f(first, last) otherwise.
+         */
+        template <class E, class F>
+        inline void assign_chunks(std::size_t size, std::size_t first, std::size_t last, std::size_t grain, F&& f)
+        {
+            if (is_parallel_safe<E>::value && use_parallel(size))
+            {
+                parallel_for(first, last, grain, std::forward<F>(f));
+            }
+            else
+            {
+                f(first, last);
+            }
+        }
     }
 
     template <class E1, class E2>
@@ -292,6 +372,9 @@ namespace xt
         static constexpr bool simd_size() { return lhs_simd_size() && rhs_simd_size(); }
         static constexpr bool forbid_simd() { return !has_simd_interface<E2>::value; }
         static constexpr bool simd_assign() { return contiguous_layout() && convertible_types() && simd_size() && has_simd_interface<E2>::value; }
+        static constexpr bool strided_data_assign() { return convertible_types() && detail::has_strided_data<E1>::value &&
+                                                             detail::has_strided_data<const E2>::value; }
+        static constexpr bool transposed_assign() { return strided_data_assign(); }
         static constexpr bool simd_strided_loop() { return convertible_types() && simd_size() &&
                                                            detail::use_strided_loop<E2>::value &&
                                                            detail::use_strided_loop<E1>::value; }
@@ -306,10 +389,18 @@ namespace xt
         bool linear_assign = trivial && detail::is_linear_assign(de1, de2);
         constexpr bool simd_assign = xassign_traits<E1, E2>::simd_assign();
         constexpr bool strided_simd_assign = xassign_traits<E1, E2>::simd_strided_loop();
+        constexpr bool transposed_assign = xassign_traits<E1, E2>::transposed_assign();
+        constexpr bool strided_data_assign = xassign_traits<E1, E2>::strided_data_assign();
         if (linear_assign)
         {
             linear_assigner<simd_assign>::run(de1, de2);
         }
+        else if (transposed_assigner<transposed_assign>::run(de1, de2))
+        {
+        }
+        else if (strided_data_assigner<strided_data_assign>::run(de1, de2))
+        {
+        }
         else if (strided_simd_assign)
         {
             strided_loop_assigner<strided_simd_assign>::run(de1, de2);
@@ -360,13 +451,19 @@ namespace xt
     inline void xexpression_assigner<Tag>::scalar_computed_assign(xexpression<E1>& e1, const E2& e2, F&& f)
     {
         E1& d = e1.derived_cast();
-        using size_type = typename E1::size_type;
+        using value_type = typename E1::value_type;
         auto dst = d.storage().begin();
-        for (size_type i = d.size(); i > 0; --i)
+        using difference_type = typename std::iterator_traits<decltype(dst)>::difference_type;
+        std::size_t size = static_cast<std::size_t>(d.size());
+        detail::assign_chunks<F>(size, 0, size, detail::cache_chunk_size<value_type>(), [&dst, &e2, &f](std::size_t first, std::size_t last)
         {
-            *dst = f(*dst, e2);
-            ++dst;
-        }
+            auto it = dst + static_cast<difference_type>(first);
+            for (std::size_t i = first; i < last; ++i)
+            {
+                *it = f(*it, e2);
+                ++it;
+            }
+        });
     }
 
     template <class Tag>
@@ -452,13 +549,51 @@ namespace xt
     template <class E1, class E2, layout_type L>
     inline void stepper_assigner<E1, E2, L>::run()
     {
-        using size_type = typename E1::size_type;
+        size_type s = m_e1.size();
+        if (is_parallel_safe<E2>::value && detail::use_parallel(s))
+        {
+            // Each chunk is computed by a copy of this assigner,
+            // moved to the first index of the chunk.
+            parallel_for(0, s, detail::balanced_grain(s), [this](std::size_t first, std::size_t last)
+            {
+                stepper_assigner assigner(*this);
+                assigner.run_range(first, last);
+            });
+        }
+        else
+        {
+            run_range(0, s);
+        }
+    }
+
+    template <class E1, class E2, layout_type L>
+    inline void stepper_assigner<E1, E2, L>::run_range(size_type first, size_type last)
+    {
         using argument_type = std::decay_t<decltype(*m_rhs)>;
         using result_type = std::decay_t<decltype(*m_lhs)>;
         constexpr bool is_narrowing = is_narrowing_conversion<argument_type, result_type>::value;
 
-        size_type s = m_e1.size();
-        for (size_type i = 0; i < s; ++i)
+        if (first != 0)
+        {
+            const auto& shape = m_e1.shape();
+            size_type n = first;
+            size_type dim = shape.size();
+            for (size_type i = 0; i < dim; ++i)
+            {
+                size_type d = L == layout_type::row_major ? dim - 1 - i : i;
+                m_index[d] = n % static_cast<size_type>(shape[d]);
+                n /= static_cast<size_type>(shape[d]);
+            }
+            for (size_type i = 0; i < dim; ++i)
+            {
+                if (m_index[i] != 0)
+                {
+                    step(i, m_index[i]);
+                }
+            }
+        }
+
+        for (size_type i = first; i < last; ++i)
         {
             *m_lhs = conditional_cast<is_narrowing, result_type>(*m_rhs);
             stepper_tools<L>::increment_stepper(*this, m_index, m_e1.shape());
@@ -518,17 +653,16 @@ namespace xt
             e1.data_element(i) = e2.data_element(i);
         }
 
-        #if defined(XTENSOR_USE_TBB)
-        tbb::parallel_for(align_begin, align_end, simd_size, [&](size_t i)
+        // Chunks are multiples of simd_size, so that they all start on an aligned element.
+        detail::assign_chunks<E2>(size, align_begin, align_end, detail::cache_chunk_size<value_type>(simd_size),
+                                  [&e1, &e2](std::size_t first, std::size_t last)
         {
-            e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
+            for (std::size_t i = first; i < last; i += simd_type::size)
+            {
+                e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
+            }
         });
-        #else
-        for (size_type i = align_begin; i < align_end; i += simd_size)
-        {
-            e1.template store_simd<lhs_align_mode>(i, e2.template load_simd<rhs_align_mode, value_type>(i));
-        }
-        #endif
+
         for (size_type i = align_end; i < size; ++i)
         {
             e1.data_element(i) = e2.data_element(i);
@@ -550,24 +684,23 @@ namespace xt
     inline void linear_assigner<false>::run_impl(E1& e1, const E2& e2, std::true_type /*is_convertible*/)
     {
         using value_type = typename E1::value_type;
-        using size_type = typename E1::size_type;
         auto src = detail::linear_begin(e2);
         auto dst = detail::linear_begin(e1);
-        size_type n = e1.size();
+        using src_difference_type = typename std::iterator_traits<decltype(src)>::difference_type;
+        using dst_difference_type = typename std::iterator_traits<decltype(dst)>::difference_type;
+        std::size_t n = static_cast<std::size_t>(e1.size());
 
-#if defined(XTENSOR_USE_TBB)
-        tbb::parallel_for(std::ptrdiff_t(0), static_cast<std::ptrdiff_t>(n), [&](std::ptrdiff_t i)
+        detail::assign_chunks<E2>(n, 0, n, detail::cache_chunk_size<value_type>(), [&src, &dst](std::size_t first, std::size_t last)
         {
-            *(dst + i) = static_cast<value_type>(*(src + i));
+            auto s = src + static_cast<src_difference_type>(first);
+            auto d = dst + static_cast<dst_difference_type>(first);
+            for (std::size_t i = first; i < last; ++i)
+            {
+                *d = static_cast<value_type>(*s);
+                ++s;
+                ++d;
+            }
         });
-#else
-        for (; n > size_type(0); --n)
-        {
-            *dst = static_cast<value_type>(*src);
-            ++src;
-            ++dst;
-        }
-#endif
     }
 
     template <class E1, class E2>
@@ -719,6 +852,18 @@ namespace xt
 
             return std::make_tuple(inner_loop_size, outer_loop_size, cut);
         }
+
+        template <class T>
+        inline void unravel_idx(std::size_t n, T& outer_index, const T& outer_shape, bool is_row_major)
+        {
+            std::size_t sz = outer_index.size();
+            for (std::size_t i = 0; i < sz; ++i)
+            {
+                std::size_t d = is_row_major ? sz - 1 - i : i;
+                outer_index[d] = n % outer_shape[d];
+                n /= outer_shape[d];
+            }
+        }
     }
 
     template <bool simd>
@@ -786,8 +931,8 @@ namespace xt
         std::size_t simd_size = inner_loop_size / simd_type::size;
         std::size_t simd_rest = inner_loop_size % simd_type::size;
 
-        auto fct_stepper = e2.stepper_begin(e1.shape());
-        auto res_stepper = e1.stepper_begin(e1.shape());
+        auto fct_begin = e2.stepper_begin(e1.shape());
+        auto res_begin = e1.stepper_begin(e1.shape());
 
         // TODO in 1D case this is ambigous -- could be RM or CM.
         //      Use default layout to make decision
@@ -797,49 +942,486 @@ namespace xt
             step_dim = cut;
         }
 
-        for (std::size_t ox = 0; ox < outer_loop_size; ++ox)
+        // The outer loop is split in chunks of contiguous outer indices, each
+        // chunk working on its own copy of the steppers.
+        auto outer_loop = [&](std::size_t first, std::size_t last)
+        {
+            auto fct_stepper = fct_begin;
+            auto res_stepper = res_begin;
+            auto index = idx;
+
+            if (first != 0)
+            {
+                strided_assign_detail::unravel_idx(first, index, max_shape, is_row_major);
+                for (std::size_t i = 0; i < index.size(); ++i)
+                {
+                    fct_stepper.step(i + step_dim, index[i]);
+                    res_stepper.step(i + step_dim, index[i]);
+                }
+            }
+
+            for (std::size_t ox = first; ox < last; ++ox)
+            {
+                for (std::size_t i = 0; i < simd_size; ++i)
+                {
+                    res_stepper.template store_simd<simd_type>(fct_stepper.template step_simd<simd_type>());
+                }
+                for (std::size_t i = 0; i < simd_rest; ++i)
+                {
+                    *(res_stepper) = *(fct_stepper);
+                    res_stepper.step_leading();
+                    fct_stepper.step_leading();
+                }
+
+                is_row_major ?
+                    strided_assign_detail::idx_tools<layout_type::row_major>::next_idx(index, max_shape) :
+                    strided_assign_detail::idx_tools<layout_type::column_major>::next_idx(index, max_shape);
+
+                fct_stepper.to_begin();
+
+                // need to step E1 as well if not contigous assign (e.g. view)
+                if (!E1::contiguous_layout)
+                {
+                    res_stepper.to_begin();
+                    for (std::size_t i = 0; i < index.size(); ++i)
+                    {
+                        fct_stepper.step(i + step_dim, index[i]);
+                        res_stepper.step(i + step_dim, index[i]);
+                    }
+                }
+                else
+                {
+                    for (std::size_t i = 0; i < index.size(); ++i)
+                    {
+                        fct_stepper.step(i + step_dim, index[i]);
+                    }
+                }
+            }
+        };
+
+        detail::assign_chunks<E2>(outer_loop_size * inner_loop_size, 0, outer_loop_size,
+                                  detail::balanced_grain(outer_loop_size), outer_loop);
+    }
+
+    template <>
+    template <class E1, class E2>
+    inline void strided_loop_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
+    {
+    }
+
+    /**************************************
+     * transposed_assigner implementation *
+     **************************************/
+
+    namespace detail
+    {
+        // Returns the axis along which the elements are contiguous,
+        // or shape.size() if there is none.
+        template <class S, class ST>
+        inline std::size_t unit_stride_axis(const S& shape, const ST& strides)
+        {
+            for (std::size_t i = shape.size(); i != 0; --i)
+            {
+                if (shape[i - 1] != 1 && strides[i - 1] == 1)
+                {
+                    return i - 1;
+                }
+            }
+            return shape.size();
+        }
+
+        // Copies the tile [first_b, last_b) x [0, size_a) of a 2-D transposition:
+        // dst is contiguous along a, src is contiguous along b. The tile is
+        // processed in square blocks that fit in the L1 cache, so that the
+        // cache lines read from src are reused across the rows of dst.
+        template <class T, class U>
+        inline void transpose_tile(T* dst, const U* src, std::size_t first_b, std::size_t last_b, std::size_t size_a,
+                                   std::ptrdiff_t dst_stride_b, std::ptrdiff_t src_stride_a)
         {
-            for (std::size_t i = 0; i < simd_size; ++i)
+            constexpr bool is_narrowing = is_narrowing_conversion<U, T>::value;
+            constexpr std::size_t block = XTENSOR_TRANSPOSE_BLOCK_SIZE;
+            for (std::size_t ja = 0; ja < size_a; ja += block)
             {
-                res_stepper.template store_simd<simd_type>(fct_stepper.template step_simd<simd_type>());
+                std::size_t last_a = std::min(ja + block, size_a);
+                for (std::size_t ib = first_b; ib < last_b; ++ib)
+                {
+                    T* d = dst + static_cast<std::ptrdiff_t>(ib) * dst_stride_b;
+                    const U* s = src + ib;
+                    for (std::size_t ia = ja; ia < last_a; ++ia)
+                    {
+                        d[ia] = conditional_cast<is_narrowing, T>(s[static_cast<std::ptrdiff_t>(ia) * src_stride_a]);
+                    }
+                }
             }
-            for (std::size_t i = 0; i < simd_rest; ++i)
+        }
+    }
+
+    /**
+     * Checks if \c e2 has the same non-empty shape as \c e1 and is
+     * contiguous along another axis than \c e1.
+     */
+    template <bool enabled>
+    template <class E1, class E2>
+    inline bool transposed_assigner<enabled>::check(const E1& e1, const E2& e2)
+    {
+        const auto& shape = e1.shape();
+        std::size_t dim = shape.size();
+        if (dim < 2 || e1.size() == 0 || e2.dimension() != dim || !std::equal(shape.cbegin(), shape.cend(), e2.shape().cbegin()))
+        {
+            return false;
+        }
+        std::size_t axis_a = detail::unit_stride_axis(shape, e1.strides());
+        std::size_t axis_b = detail::unit_stride_axis(shape, e2.strides());
+        return axis_a != dim && axis_b != dim && axis_a != axis_b;
+    }
+
+    /**
+     * Assigns an expression whose elements are contiguous along another
+     * axis than the ones of the destination, for instance a transposed
+     * container or a container with another layout. The assignment is
+     * computed by cache blocks over the two contiguous axes instead of
+     * striding across the memory of the source. The expressions must
+     * satisfy check(e1, e2).
+     */
+    template <bool enabled>
+    template <class E1, class E2>
+    inline void transposed_assigner<enabled>::assign(E1& e1, const E2& e2)
+    {
+        const auto& shape = e1.shape();
+        std::size_t dim = shape.size();
+        const auto& dst_strides = e1.strides();
+        const auto& src_strides = e2.strides();
+        std::size_t axis_a = detail::unit_stride_axis(shape, dst_strides);
+        std::size_t axis_b = detail::unit_stride_axis(shape, src_strides);
+
+        // Other axes, iterated in the outer loop
+        svector<std::size_t, 4> outer_shape;
+        svector<std::ptrdiff_t, 4> outer_dst_strides;
+        svector<std::ptrdiff_t, 4> outer_src_strides;
+        for (std::size_t i = 0; i < dim; ++i)
+        {
+            if (i != axis_a && i != axis_b)
             {
-                *(res_stepper) = *(fct_stepper);
-                res_stepper.step_leading();
-                fct_stepper.step_leading();
+                outer_shape.push_back(static_cast<std::size_t>(shape[i]));
+                outer_dst_strides.push_back(static_cast<std::ptrdiff_t>(dst_strides[i]));
+                outer_src_strides.push_back(static_cast<std::ptrdiff_t>(src_strides[i]));
             }
+        }
+
+        auto* dst = e1.data() + e1.data_offset();
+        const auto* src = e2.data() + e2.data_offset();
+        std::size_t size_a = static_cast<std::size_t>(shape[axis_a]);
+        std::size_t size_b = static_cast<std::size_t>(shape[axis_b]);
+        std::ptrdiff_t dst_stride_b = static_cast<std::ptrdiff_t>(dst_strides[axis_b]);
+        std::ptrdiff_t src_stride_a = static_cast<std::ptrdiff_t>(src_strides[axis_a]);
+
+        // A task copies a band of XTENSOR_TRANSPOSE_BLOCK_SIZE rows of b for one outer index
+        constexpr std::size_t block = XTENSOR_TRANSPOSE_BLOCK_SIZE;
+        std::size_t bands = (size_b + block - 1) / block;
+        std::size_t outer_size = e1.size() / (size_a * size_b);
+        std::size_t n_tasks = outer_size * bands;
+        auto task = [&](std::size_t first, std::size_t last)
+        {
+            for (std::size_t t = first; t < last; ++t)
+            {
+                std::size_t outer = t / bands;
+                std::size_t first_b = (t % bands) * block;
+                std::ptrdiff_t dst_offset = 0;
+                std::ptrdiff_t src_offset = 0;
+                for (std::size_t i = outer_shape.size(); i != 0; --i)
+                {
+                    std::ptrdiff_t idx = static_cast<std::ptrdiff_t>(outer % outer_shape[i - 1]);
+                    outer /= outer_shape[i - 1];
+                    dst_offset += idx * outer_dst_strides[i - 1];
+                    src_offset += idx * outer_src_strides[i - 1];
+                }
+                detail::transpose_tile(dst + dst_offset, src + src_offset, first_b, std::min(first_b + block, size_b),
+                                       size_a, dst_stride_b, src_stride_a);
+            }
+        };
+        detail::assign_chunks<E2>(e1.size(), 0, n_tasks, detail::balanced_grain(n_tasks), task);
+    }
+
+    /**
+     * Assigns \c e2 to \c e1 if they satisfy check(e1, e2). Returns false
+     * without assigning anything otherwise.
+     */
+    template <bool enabled>
+    template <class E1, class E2>
+    inline bool transposed_assigner<enabled>::run(E1& e1, const E2& e2)
+    {
+        if (!check(e1, e2))
+        {
+            return false;
+        }
+        assign(e1, e2);
+        return true;
+    }
+
+    template <>
+    template <class E1, class E2>
+    inline bool transposed_assigner<false>::check(const E1& /*e1*/, const E2& /*e2*/)
+    {
+        return false;
+    }
 
-            is_row_major ?
-                strided_assign_detail::idx_tools<layout_type::row_major>::next_idx(idx, max_shape) :
-                strided_assign_detail::idx_tools<layout_type::column_major>::next_idx(idx, max_shape);
+    template <>
+    template <class E1, class E2>
+    inline void transposed_assigner<false>::assign(E1& /*e1*/, const E2& /*e2*/)
+    {
+    }
 
-            fct_stepper.to_begin();
+    template <>
+    template <class E1, class E2>
+    inline bool transposed_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
+    {
+        return false;
+    }
 
-            // need to step E1 as well if not contigous assign (e.g. view)
-            if (!E1::contiguous_layout)
+    /****************************************
+     * strided_data_assigner implementation *
+     ****************************************/
+
+    namespace strided_assign_detail
+    {
+        inline std::ptrdiff_t stride_magnitude(std::ptrdiff_t s) noexcept
+        {
+            return s < 0 ? -s : s;
+        }
+
+        // Builds the loops assigning e2 to e1: the axes of size 1 are dropped,
+        // the other ones are sorted by decreasing destination strides and the
+        // adjacent axes that both expressions span with a constant stride are
+        // merged into a single loop. Returns false if e2 cannot be broadcast
+        // to the shape of e1.
+        template <class E1, class E2>
+        inline bool collapse_loops(const E1& e1, const E2& e2, loop_nest& loops)
+        {
+            const auto& shape = e1.shape();
+            const auto& src_shape = e2.shape();
+            std::size_t dim = shape.size();
+            std::size_t src_dim = src_shape.size();
+            if (src_dim > dim)
+            {
+                return false;
+            }
+
+            svector<std::size_t, 4> axes;
+            svector<std::ptrdiff_t, 4> src_strides;
+            for (std::size_t i = 0; i < dim; ++i)
             {
-                res_stepper.to_begin();
-                for (std::size_t i = 0; i < idx.size(); ++i)
+                std::size_t n = static_cast<std::size_t>(shape[i]);
+                std::ptrdiff_t ss = 0;
+                if (i + src_dim >= dim)
+                {
+                    std::size_t j = i + src_dim - dim;
+                    std::size_t sn = static_cast<std::size_t>(src_shape[j]);
+                    if (sn != n && sn != 1)
+                    {
+                        return false;
+                    }
+                    ss = sn == 1 ? 0 : static_cast<std::ptrdiff_t>(e2.strides()[j]);
+                }
+                src_strides.push_back(ss);
+                if (n != 1)
                 {
-                    fct_stepper.step(i + step_dim, idx[i]);
-                    res_stepper.step(i + step_dim, idx[i]);
+                    axes.push_back(i);
+                }
+            }
+
+            const auto& dst_strides = e1.strides();
+            std::sort(axes.begin(), axes.end(), [&](std::size_t lhs, std::size_t rhs)
+            {
+                std::ptrdiff_t dl = stride_magnitude(static_cast<std::ptrdiff_t>(dst_strides[lhs]));
+                std::ptrdiff_t dr = stride_magnitude(static_cast<std::ptrdiff_t>(dst_strides[rhs]));
+                return dl != dr ? dl > dr : stride_magnitude(src_strides[lhs]) > stride_magnitude(src_strides[rhs]);
+            });
+
+            for (std::size_t axis : axes)
+            {
+                std::size_t n = static_cast<std::size_t>(shape[axis]);
+                std::ptrdiff_t ds = static_cast<std::ptrdiff_t>(dst_strides[axis]);
+                std::ptrdiff_t ss = src_strides[axis];
+                std::ptrdiff_t sn = static_cast<std::ptrdiff_t>(n);
+                if (!loops.shape.empty() && loops.dst_strides.back() == ds * sn && loops.src_strides.back() == ss * sn)
+                {
+                    loops.shape.back() *= n;
+                    loops.dst_strides.back() = ds;
+                    loops.src_strides.back() = ss;
+                }
+                else
+                {
+                    loops.shape.push_back(n);
+                    loops.dst_strides.push_back(ds);
+                    loops.src_strides.push_back(ss);
+                }
+            }
+
+            if (loops.shape.empty())
+            {
+                loops.shape.push_back(1);
+                loops.dst_strides.push_back(0);
+                loops.src_strides.push_back(0);
+            }
+            return true;
+        }
+
+        // Assigns n values with constant strides. The unit stride cases have
+        // their own loops so that the compiler can vectorize them, with
+        // gather or scatter instructions when only one side is strided.
+        template <class T, class U>
+        inline void assign_line(T* dst, const U* src, std::size_t n, std::ptrdiff_t dst_stride, std::ptrdiff_t src_stride)
+        {
+            constexpr bool is_narrowing = is_narrowing_conversion<U, T>::value;
+            std::ptrdiff_t size = static_cast<std::ptrdiff_t>(n);
+            if (dst_stride == 1 && src_stride == 1)
+            {
+                for (std::ptrdiff_t i = 0; i < size; ++i)
+                {
+                    dst[i] = conditional_cast<is_narrowing, T>(src[i]);
+                }
+            }
+            else if (dst_stride == 1)
+            {
+                for (std::ptrdiff_t i = 0; i < size; ++i)
+                {
+                    dst[i] = conditional_cast<is_narrowing, T>(src[i * src_stride]);
+                }
+            }
+            else if (src_stride == 1)
+            {
+                for (std::ptrdiff_t i = 0; i < size; ++i)
+                {
+                    dst[i * dst_stride] = conditional_cast<is_narrowing, T>(src[i]);
                 }
             }
             else
             {
-                for (std::size_t i = 0; i < idx.size(); ++i)
+                for (std::ptrdiff_t i = 0; i < size; ++i)
                 {
-                    fct_stepper.step(i + step_dim, idx[i]);
+                    dst[i * dst_stride] = conditional_cast<is_narrowing, T>(src[i * src_stride]);
                 }
             }
         }
     }
 
+    /**
+     * Builds the loops assigning \c e2 to \c e1 in \c loops. Returns false
+     * if \c e2 does not broadcast to the shape of \c e1.
+     */
+    template <bool enabled>
+    template <class E1, class E2>
+    inline bool strided_data_assigner<enabled>::check(const E1& e1, const E2& e2, loop_nest& loops)
+    {
+        return strided_assign_detail::collapse_loops(e1, e2, loops);
+    }
+
+    /**
+     * Assigns an expression holding its values in a strided buffer (a
+     * container or a strided view) to a strided destination with pointer
+     * loops instead of steppers. The axes are reordered by decreasing
+     * strides of the destination and merged when possible, so that the
+     * innermost loop is as long as possible and runs with constant
+     * strides; a copy of ``view(a, all(), range(0, n, 2))`` is a single
+     * loop of stride 2 when the other axes can be merged. The loops are
+     * the ones built by check(e1, e2, loops).
+     */
+    template <bool enabled>
+    template <class E1, class E2>
+    inline void strided_data_assigner<enabled>::assign(E1& e1, const E2& e2, const loop_nest& loops)
+    {
+        std::size_t size = e1.size();
+        if (size == 0)
+        {
+            return;
+        }
+
+        auto* dst = e1.data() + e1.data_offset();
+        const auto* src = e2.data() + e2.data_offset();
+        std::size_t outer_dim = loops.shape.size() - 1;
+        std::size_t inner_size = loops.shape.back();
+        std::ptrdiff_t dst_stride = loops.dst_strides.back();
+        std::ptrdiff_t src_stride = loops.src_strides.back();
+
+        // A task assigns the flat range [first, last) of the loop nest; the
+        // index of the outer loops is unraveled once and then incremented.
+        auto task = [&](std::size_t first, std::size_t last)
+        {
+            svector<std::size_t, 4> index(outer_dim, std::size_t(0));
+            std::size_t line = first / inner_size;
+            std::size_t pos = first % inner_size;
+            std::ptrdiff_t dst_offset = 0;
+            std::ptrdiff_t src_offset = 0;
+            for (std::size_t i = outer_dim; i != 0; --i)
+            {
+                index[i - 1] = line % loops.shape[i - 1];
+                line /= loops.shape[i - 1];
+                dst_offset += static_cast<std::ptrdiff_t>(index[i - 1]) * loops.dst_strides[i - 1];
+                src_offset += static_cast<std::ptrdiff_t>(index[i - 1]) * loops.src_strides[i - 1];
+            }
+
+            while (first < last)
+            {
+                std::size_t count = std::min(inner_size - pos, last - first);
+                std::ptrdiff_t p = static_cast<std::ptrdiff_t>(pos);
+                strided_assign_detail::assign_line(dst + dst_offset + p * dst_stride, src + src_offset + p * src_stride,
+                                                   count, dst_stride, src_stride);
+                first += count;
+                pos = 0;
+                for (std::size_t i = outer_dim; i != 0; --i)
+                {
+                    if (++index[i - 1] != loops.shape[i - 1])
+                    {
+                        dst_offset += loops.dst_strides[i - 1];
+                        src_offset += loops.src_strides[i - 1];
+                        break;
+                    }
+                    std::ptrdiff_t back = static_cast<std::ptrdiff_t>(loops.shape[i - 1] - 1);
+                    dst_offset -= back * loops.dst_strides[i - 1];
+                    src_offset -= back * loops.src_strides[i - 1];
+                    index[i - 1] = 0;
+                }
+            }
+        };
+        detail::assign_chunks<E2>(size, 0, size, detail::balanced_grain(size), task);
+    }
+
+    /**
+     * Assigns \c e2 to \c e1 with the loops built by check. Returns false
+     * without assigning anything if \c e2 does not broadcast to the shape
+     * of \c e1.
+     */
+    template <bool enabled>
+    template <class E1, class E2>
+    inline bool strided_data_assigner<enabled>::run(E1& e1, const E2& e2)
+    {
+        loop_nest loops;
+        if (!check(e1, e2, loops))
+        {
+            return false;
+        }
+        assign(e1, e2, loops);
+        return true;
+    }
+
     template <>
     template <class E1, class E2>
-    inline void strided_loop_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
+    inline bool strided_data_assigner<false>::check(const E1& /*e1*/, const E2& /*e2*/, loop_nest& /*loops*/)
+    {
+        return false;
+    }
+
+    template <>
+    template <class E1, class E2>
+    inline void strided_data_assigner<false>::assign(E1& /*e1*/, const E2& /*e2*/, const loop_nest& /*loops*/)
+    {
+    }
+
+    template <>
+    template <class E1, class E2>
+    inline bool strided_data_assigner<false>::run(E1& /*e1*/, const E2& /*e2*/)
     {
+        return false;
     }
 }
 
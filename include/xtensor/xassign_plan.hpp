@@ -0,0 +1,234 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_ASSIGN_PLAN_HPP
+#define XTENSOR_ASSIGN_PLAN_HPP
+
+#include <type_traits>
+#include <utility>
+
+#include "xassign.hpp"
+#include "xexpression.hpp"
+#include "xsemantic.hpp"
+
+namespace xt
+{
+    /*******************
+     * assign_strategy *
+     *******************/
+
+    /**
+     * Loops used by an xassign_plan.
+     */
+    enum class assign_strategy
+    {
+        /// Single loop over the flat storage of both sides
+        linear,
+        /// Cache-blocked loops between two different contiguous axes
+        transposed,
+        /// Pointer loops over collapsed axes of strided buffers
+        strided_data,
+        /// SIMD loops over the contiguous inner axes
+        strided_loop,
+        /// Multi-dimensional steppers
+        stepper
+    };
+
+    /****************
+     * xassign_plan *
+     ****************/
+
+    /**
+     * @class xassign_plan
+     * @brief Assignment of an expression to a container or a view, prepared once
+     * and run many times.
+     *
+     * The plan computes the broadcast shape of the expression, resizes the
+     * destination and chooses the loops of the assignment when it is built,
+     * instead of doing it for every assignment. Running the plan assigns the
+     * current values of the expression to the destination, so that an
+     * expression can be re-evaluated in a loop on new values of its operands:
+     *
+     * @code{.cpp}
+     * xt::xtensor<double, 1> x = xt::zeros<double>({10000});
+     * xt::xtensor<double, 1> y = xt::zeros<double>({10000});
+     * auto plan = xt::make_assign_plan(y, 2. * x + 1.);
+     * for (std::size_t i = 0; i < n; ++i)
+     * {
+     *     read_values(x);
+     *     plan.run(); // same as xt::noalias(y) = 2. * x + 1.;
+     * }
+     * @endcode
+     *
+     * The plan holds the destination and the expression like an xfunction
+     * holds its arguments: by reference for lvalues, by value for temporaries.
+     * The shapes and strides of the operands must not change during the
+     * lifetime of the plan; a new plan must be made after such a change.
+     * Like with noalias, the destination should not be an operand of the
+     * expression.
+     *
+     * @tparam E1 the type of the destination
+     * @tparam E2 the type of the assigned expression
+     * @sa make_assign_plan
+     */
+    template <class E1, class E2>
+    class xassign_plan
+    {
+    public:
+
+        using lhs_closure_type = xclosure_t<E1>;
+        using rhs_closure_type = const_xclosure_t<E2>;
+        using lhs_type = std::decay_t<lhs_closure_type>;
+        using rhs_type = std::decay_t<rhs_closure_type>;
+
+        template <class LHS, class RHS>
+        xassign_plan(LHS&& lhs, RHS&& rhs);
+
+        void run();
+
+        assign_strategy strategy() const noexcept;
+
+        lhs_type& lhs() noexcept;
+        const rhs_type& rhs() const noexcept;
+
+    private:
+
+        using traits = xassign_traits<lhs_type, rhs_type>;
+        using loop_nest = strided_assign_detail::loop_nest;
+
+        static_assert(std::is_same<xexpression_tag_t<lhs_type, rhs_type>, xtensor_expression_tag>::value,
+                      "xassign_plan only supports expressions with the xtensor_expression_tag");
+
+        lhs_closure_type m_lhs;
+        rhs_closure_type m_rhs;
+        assign_strategy m_strategy;
+        loop_nest m_loops;
+    };
+
+    template <class E1, class E2>
+    xassign_plan<E1, E2> make_assign_plan(E1&& lhs, E2&& rhs);
+
+    /*******************************
+     * xassign_plan implementation *
+     *******************************/
+
+    namespace detail
+    {
+        template <class E1, class E2>
+        inline bool plan_resize(E1& e1, const E2& e2, std::true_type /*is_container*/)
+        {
+            return xexpression_assigner<xtensor_expression_tag>::resize(e1, e2);
+        }
+
+        template <class E1, class E2>
+        inline bool plan_resize(E1& e1, const E2& e2, std::false_type /*is_container*/)
+        {
+            assert_compatible_shape(e1, e2);
+            return get_rhs_triviality(e2);
+        }
+    }
+
+    /**
+     * Builds the plan assigning \c rhs to \c lhs. The destination is resized
+     * to the shape of the expression if it is a container; if it is a view,
+     * the expression must broadcast to its shape.
+     * @param lhs the destination
+     * @param rhs the expression to assign
+     */
+    template <class E1, class E2>
+    template <class LHS, class RHS>
+    inline xassign_plan<E1, E2>::xassign_plan(LHS&& lhs, RHS&& rhs)
+        : m_lhs(std::forward<LHS>(lhs)), m_rhs(std::forward<RHS>(rhs)), m_strategy(assign_strategy::stepper)
+    {
+        using is_container = std::is_base_of<xcontainer_semantic<lhs_type>, lhs_type>;
+        bool trivial_broadcast = detail::plan_resize(m_lhs, m_rhs, is_container());
+
+        if (trivial_broadcast && detail::is_linear_assign(m_lhs, m_rhs))
+        {
+            m_strategy = assign_strategy::linear;
+        }
+        else if (transposed_assigner<traits::transposed_assign()>::check(m_lhs, m_rhs))
+        {
+            m_strategy = assign_strategy::transposed;
+        }
+        else if (strided_data_assigner<traits::strided_data_assign()>::check(m_lhs, m_rhs, m_loops))
+        {
+            m_strategy = assign_strategy::strided_data;
+        }
+        else if (traits::simd_strided_loop())
+        {
+            m_strategy = assign_strategy::strided_loop;
+        }
+    }
+
+    /**
+     * Assigns the current values of the expression to the destination.
+     */
+    template <class E1, class E2>
+    inline void xassign_plan<E1, E2>::run()
+    {
+        switch (m_strategy)
+        {
+            case assign_strategy::linear:
+                linear_assigner<traits::simd_assign()>::run(m_lhs, m_rhs);
+                break;
+            case assign_strategy::transposed:
+                transposed_assigner<traits::transposed_assign()>::assign(m_lhs, m_rhs);
+                break;
+            case assign_strategy::strided_data:
+                strided_data_assigner<traits::strided_data_assign()>::assign(m_lhs, m_rhs, m_loops);
+                break;
+            case assign_strategy::strided_loop:
+                strided_loop_assigner<traits::simd_strided_loop()>::run(m_lhs, m_rhs);
+                break;
+            default:
+                stepper_assigner<lhs_type, rhs_type, default_assignable_layout(lhs_type::static_layout)>(m_lhs, m_rhs).run();
+                break;
+        }
+    }
+
+    /**
+     * Returns the loops chosen for the assignment.
+     */
+    template <class E1, class E2>
+    inline assign_strategy xassign_plan<E1, E2>::strategy() const noexcept
+    {
+        return m_strategy;
+    }
+
+    /**
+     * Returns the destination of the assignment.
+     */
+    template <class E1, class E2>
+    inline auto xassign_plan<E1, E2>::lhs() noexcept -> lhs_type&
+    {
+        return m_lhs;
+    }
+
+    /**
+     * Returns the assigned expression.
+     */
+    template <class E1, class E2>
+    inline auto xassign_plan<E1, E2>::rhs() const noexcept -> const rhs_type&
+    {
+        return m_rhs;
+    }
+
+    /**
+     * Builds an xassign_plan assigning \c rhs to \c lhs.
+     * @param lhs the destination, a container or a view
+     * @param rhs the expression to assign
+     */
+    template <class E1, class E2>
+    inline xassign_plan<E1, E2> make_assign_plan(E1&& lhs, E2&& rhs)
+    {
+        return xassign_plan<E1, E2>(std::forward<E1>(lhs), std::forward<E2>(rhs));
+    }
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include "xiterator.hpp"
 #include "xmath.hpp"
 #include "xoperation.hpp"
+#include "xstorage.hpp"
 #include "xstrides.hpp"
 #include "xtensor_forward.hpp"
 
@@ -282,6 +283,10 @@ namespace xt
         void resize(S&& shape, layout_type l);
         template <class S = shape_type>
         void resize(S&& shape, const strides_type& strides);
+        template <class S = shape_type>
+        void resize(S&& shape, uninitialized_t, bool force = false);
+        template <class S = shape_type>
+        void resize(S&& shape, layout_type l, uninitialized_t);
 
         template <class S = shape_type>
         void reshape(S&& shape, layout_type layout = base_type::static_layout);
@@ -323,6 +328,9 @@ namespace xt
 
     private:
 
+        template <class S, class... I>
+        void resize_impl(S&& shape, bool force, I... init);
+
         inner_shape_type m_shape;
         inner_strides_type m_strides;
         inner_backstrides_type m_backstrides;
@@ -964,6 +972,17 @@ namespace xt
 
     namespace detail
     {
+        template <class C, class = void_t<>>
+        struct has_uninitialized_resize : std::false_type
+        {
+        };
+
+        template <class C>
+        struct has_uninitialized_resize<C, void_t<decltype(std::declval<C&>().resize(std::size_t(), uninitialized))>>
+            : std::true_type
+        {
+        };
+
         template <class C, class S>
         inline void resize_data_container(C& c, S size)
         {
@@ -977,6 +996,30 @@ namespace xt
             (void) size;
             XTENSOR_ASSERT_MSG(c.size() == size, "Trying to resize const data container with wrong size.");
         }
+
+        template <class C, class S>
+        inline void resize_data_container_uninitialized(C& c, S size, std::true_type)
+        {
+            c.resize(size, uninitialized);
+        }
+
+        template <class C, class S>
+        inline void resize_data_container_uninitialized(C& c, S size, std::false_type)
+        {
+            xt::resize_container(c, size);
+        }
+
+        template <class C, class S>
+        inline void resize_data_container(C& c, S size, uninitialized_t)
+        {
+            resize_data_container_uninitialized(c, size, has_uninitialized_resize<C>());
+        }
+
+        template <class C, class S>
+        inline void resize_data_container(const C& c, S size, uninitialized_t)
+        {
+            resize_data_container(c, size);
+        }
     }
 
     /**
@@ -988,19 +1031,7 @@ namespace xt
     template <class S>
     inline void xstrided_container<D>::resize(S&& shape, bool force)
     {
-        std::size_t dim = shape.size();
-        if (m_shape.size() != dim || !std::equal(std::begin(shape), std::end(shape), std::begin(m_shape)) || force)
-        {
-            if (D::static_layout == layout_type::dynamic && m_layout == layout_type::dynamic)
-            {
-                m_layout = XTENSOR_DEFAULT_LAYOUT;  // fall back to default layout
-            }
-            m_shape = xtl::forward_sequence<shape_type, S>(shape);
-            resize_container(m_strides, dim);
-            resize_container(m_backstrides, dim);
-            size_type data_size = compute_strides<D::static_layout>(m_shape, m_layout, m_strides, m_backstrides);
-            detail::resize_data_container(this->storage(), data_size);
-        }
+        resize_impl(std::forward<S>(shape), force);
     }
 
     /**
@@ -1041,6 +1072,58 @@ namespace xt
         detail::resize_data_container(this->storage(), compute_size(m_shape));
     }
 
+    /**
+     * Resizes the container without value-initializing its elements.
+     * The storage is resized with its ``resize(size, uninitialized)``
+     * method when it provides one; the elements of trivial types are
+     * then left uninitialized. This is meant for containers that are
+     * entirely overwritten afterwards, such as the result of an assignment.
+     * @param shape the new shape
+     * @param force force reshaping, even if the shape stays the same (default: false)
+     */
+    template <class D>
+    template <class S>
+    inline void xstrided_container<D>::resize(S&& shape, uninitialized_t, bool force)
+    {
+        resize_impl(std::forward<S>(shape), force, uninitialized);
+    }
+
+    /**
+     * Resizes the container without value-initializing its elements.
+     * @param shape the new shape
+     * @param l the new layout_type
+     */
+    template <class D>
+    template <class S>
+    inline void xstrided_container<D>::resize(S&& shape, layout_type l, uninitialized_t)
+    {
+        if (base_type::static_layout != layout_type::dynamic && l != base_type::static_layout)
+        {
+            throw std::runtime_error("Cannot change layout_type if template parameter not layout_type::dynamic.");
+        }
+        m_layout = l;
+        resize_impl(std::forward<S>(shape), true, uninitialized);
+    }
+
+    template <class D>
+    template <class S, class... I>
+    inline void xstrided_container<D>::resize_impl(S&& shape, bool force, I... init)
+    {
+        std::size_t dim = shape.size();
+        if (m_shape.size() != dim || !std::equal(std::begin(shape), std::end(shape), std::begin(m_shape)) || force)
+        {
+            if (D::static_layout == layout_type::dynamic && m_layout == layout_type::dynamic)
+            {
+                m_layout = XTENSOR_DEFAULT_LAYOUT;  // fall back to default layout
+            }
+            m_shape = xtl::forward_sequence<shape_type, S>(shape);
+            resize_container(m_strides, dim);
+            resize_container(m_backstrides, dim);
+            size_type data_size = compute_strides<D::static_layout>(m_shape, m_layout, m_strides, m_backstrides);
+            detail::resize_data_container(this->storage(), data_size, init...);
+        }
+    }
+
     /**
      * Reshapes the container and keeps old elements
      * @param shape the new shape (has to have same number of elements as the original container)
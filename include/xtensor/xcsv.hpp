@@ -9,12 +9,20 @@
 #ifndef XTENSOR_CSV_HPP
 #define XTENSOR_CSV_HPP
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <istream>
 #include <iterator>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "xtensor.hpp"
 
@@ -29,10 +37,13 @@ namespace xt
     using xcsv_tensor = xtensor_container<std::vector<T, A>, 2, layout_type::row_major>;
 
     template <class T, class A = std::allocator<T>>
-    xcsv_tensor<T, A> load_csv(std::istream& stream);
+    xcsv_tensor<T, A> load_csv(std::istream& stream, const char delimiter = ',',
+                               const std::size_t skip_rows = 0, const std::ptrdiff_t max_rows = -1,
+                               const std::string& comments = "#",
+                               const std::vector<std::size_t>& usecols = {});
 
     template <class E>
-    void dump_csv(std::ostream& stream, const xexpression<E>& e);
+    void dump_csv(std::ostream& stream, const xexpression<E>& e, const char delimiter = ',');
 
     /*****************************************
      * load_csv and dump_csv implementations *
@@ -60,74 +71,549 @@ namespace xt
             return cell.substr(first, last==std::string::npos?cell.size():last+1);
         }
 
-        template <>
-        inline float lexical_cast<float>(const std::string& cell) { return std::stof(cell); }
+        // Values read and written with the buffered number routines, the
+        // other types go through the stream operators.
+        template <class T>
+        struct is_csv_number
+            : std::integral_constant<bool, std::is_arithmetic<T>::value &&
+                                           !std::is_same<T, bool>::value &&
+                                           !std::is_same<T, char>::value &&
+                                           !std::is_same<T, signed char>::value &&
+                                           !std::is_same<T, unsigned char>::value>
+        {
+        };
 
-        template <>
-        inline double lexical_cast<double>(const std::string& cell) { return std::stod(cell); }
+        inline const char* skip_csv_blanks(const char* first, const char* last)
+        {
+            while (first != last && (*first == ' ' || *first == '\t'))
+            {
+                ++first;
+            }
+            return first;
+        }
 
-        template <>
-        inline long double lexical_cast<long double>(const std::string& cell) { return std::stold(cell); }
+        [[noreturn]] inline void throw_csv_invalid_value(const char* first, const char* last)
+        {
+            throw std::runtime_error("Invalid value in CSV: '" + std::string(first, last) + "'");
+        }
 
-        template <>
-        inline int lexical_cast<int>(const std::string& cell) { return std::stoi(cell); }
+        template <class T>
+        inline const char* parse_csv_number(const char* first, const char* last, T& value, std::true_type /*integral*/)
+        {
+            using limits = std::numeric_limits<T>;
+            const char* it = first;
+            bool negative = false;
+            if (it != last && (*it == '-' || *it == '+'))
+            {
+                negative = *it == '-';
+                ++it;
+            }
+            const char* digits = it;
+            unsigned long long acc = 0;
+            constexpr unsigned long long max_acc = std::numeric_limits<unsigned long long>::max();
+            for (; it != last && *it >= '0' && *it <= '9'; ++it)
+            {
+                unsigned long long digit = static_cast<unsigned long long>(*it - '0');
+                if (acc > (max_acc - digit) / 10)
+                {
+                    throw std::out_of_range("Value out of range in CSV");
+                }
+                acc = acc * 10 + digit;
+            }
+            if (it == digits)
+            {
+                throw_csv_invalid_value(first, last);
+            }
+            // A fractional part is truncated, as in std::stoi
+            if (it != last && *it == '.')
+            {
+                for (++it; it != last && *it >= '0' && *it <= '9'; ++it)
+                {
+                }
+            }
 
-        template <>
-        inline long lexical_cast<long>(const std::string& cell) { return std::stol(cell); }
+            // Negative values wrap around for unsigned types, as in std::stoul
+            unsigned long long max_value = static_cast<unsigned long long>(limits::max());
+            if ((negative && limits::is_signed) ? acc > max_value + 1 : acc > max_value)
+            {
+                throw std::out_of_range("Value out of range in CSV");
+            }
+            value = static_cast<T>(negative ? ~acc + 1 : acc);
+            return it;
+        }
 
-        template <>
-        inline long long lexical_cast<long long>(const std::string& cell) { return std::stoll(cell); }
+        inline void csv_strtod(const char* first, char** end, float& value)
+        {
+            value = std::strtof(first, end);
+        }
 
-        template <>
-        inline unsigned int lexical_cast<unsigned int>(const std::string& cell) { return static_cast<unsigned int>(std::stoul(cell)); }
+        inline void csv_strtod(const char* first, char** end, double& value)
+        {
+            value = std::strtod(first, end);
+        }
 
-        template <>
-        inline unsigned long lexical_cast<unsigned long>(const std::string& cell) { return std::stoul(cell); }
+        inline void csv_strtod(const char* first, char** end, long double& value)
+        {
+            value = std::strtold(first, end);
+        }
 
-        template <>
-        inline unsigned long long lexical_cast<unsigned long long>(const std::string& cell) { return std::stoull(cell); }
+        // first points to a non blank character and the line is followed by
+        // a character that cannot belong to a number, so strtod stops there.
+        template <class T>
+        inline const char* parse_csv_number(const char* first, const char* last, T& value, std::false_type /*integral*/)
+        {
+            char* end = nullptr;
+            csv_strtod(first, &end, value);
+            if (end == first || end > last)
+            {
+                throw_csv_invalid_value(first, last);
+            }
+            return end;
+        }
+
+        // Parses the cell starting at first into value and returns the end of
+        // the cell, i.e. last or the position of the next delimiter.
+        template <class T>
+        inline const char* parse_csv_cell(const char* first, const char* last, char delimiter, T& value, std::true_type /*number*/)
+        {
+            const char* cell = skip_csv_blanks(first, last);
+            const char* end = parse_csv_number(cell, last, value, std::is_integral<T>());
+            end = skip_csv_blanks(end, last);
+            if (end != last && *end != delimiter)
+            {
+                const char* cell_end = std::find(end, last, delimiter);
+                throw_csv_invalid_value(cell, cell_end);
+            }
+            return end;
+        }
 
-        template <class ST, class T, class OI>
-        ST load_csv_row(std::istream& row_stream, OI output, std::string cell)
+        template <class T>
+        inline const char* parse_csv_cell(const char* first, const char* last, char delimiter, T& value, std::false_type /*number*/)
         {
-            ST length = 0;
-            while (std::getline(row_stream, cell, ','))
+            const char* end = std::find(first, last, delimiter);
+            value = lexical_cast<T>(std::string(first, end));
+            return end;
+        }
+
+        // Reads an input stream by blocks and splits it into lines. Lines
+        // are views on the internal buffer, they are valid until the next
+        // call to next. The buffer always ends with a null character, so
+        // that the last line is terminated even without a line break.
+        class csv_line_reader
+        {
+        public:
+
+            explicit csv_line_reader(std::istream& stream, std::size_t block_size = std::size_t(1) << 20);
+
+            bool next(const char*& first, const char*& last);
+
+            std::size_t remaining_bytes();
+            void unread();
+
+        private:
+
+            bool fill();
+
+            std::istream& m_stream;
+            std::vector<char> m_buffer;
+            std::size_t m_begin;
+            std::size_t m_end;
+            bool m_eof;
+        };
+
+        inline csv_line_reader::csv_line_reader(std::istream& stream, std::size_t block_size)
+            : m_stream(stream), m_buffer(block_size + 1), m_begin(0), m_end(0), m_eof(false)
+        {
+            m_buffer[0] = '\0';
+        }
+
+        inline bool csv_line_reader::next(const char*& first, const char*& last)
+        {
+            while (true)
             {
-                *output++ = lexical_cast<T>(cell);
-                ++length;
+                const char* begin = m_buffer.data() + m_begin;
+                const void* eol = std::memchr(begin, '\n', m_end - m_begin);
+                if (eol != nullptr || (m_eof && m_begin != m_end))
+                {
+                    const char* end = eol != nullptr ? static_cast<const char*>(eol) : m_buffer.data() + m_end;
+                    m_begin = static_cast<std::size_t>(end - m_buffer.data()) + (eol != nullptr ? 1 : 0);
+                    first = begin;
+                    last = (end != begin && *(end - 1) == '\r') ? end - 1 : end;
+                    return true;
+                }
+                if (m_eof || !fill())
+                {
+                    return false;
+                }
             }
-            return length;
+        }
+
+        inline std::size_t csv_line_reader::remaining_bytes()
+        {
+            std::size_t buffered = m_end - m_begin;
+            if (m_eof)
+            {
+                return buffered;
+            }
+            std::streampos pos = m_stream.tellg();
+            if (pos == std::streampos(-1))
+            {
+                m_stream.clear();
+                return buffered;
+            }
+            m_stream.seekg(0, std::ios::end);
+            std::streampos end = m_stream.tellg();
+            m_stream.seekg(pos);
+            return buffered + static_cast<std::size_t>(end - pos);
+        }
+
+        // Moves a seekable stream back to the first byte that has been read
+        // but not returned in a line. The position of other streams is left
+        // after the last block read.
+        inline void csv_line_reader::unread()
+        {
+            std::size_t pending = m_end - m_begin;
+            if (pending == 0)
+            {
+                return;
+            }
+            m_stream.clear();
+            std::streampos pos = m_stream.tellg();
+            if (pos == std::streampos(-1))
+            {
+                m_stream.clear();
+                return;
+            }
+            m_stream.seekg(pos - static_cast<std::streamoff>(pending));
+            m_begin = m_end;
+        }
+
+        inline bool csv_line_reader::fill()
+        {
+            std::size_t pending = m_end - m_begin;
+            std::memmove(m_buffer.data(), m_buffer.data() + m_begin, pending);
+            m_begin = 0;
+            m_end = pending;
+            if (m_end + 1 == m_buffer.size())
+            {
+                // A line longer than the buffer
+                m_buffer.resize(2 * m_buffer.size());
+            }
+            m_stream.read(m_buffer.data() + m_end, static_cast<std::streamsize>(m_buffer.size() - m_end - 1));
+            std::size_t count = static_cast<std::size_t>(m_stream.gcount());
+            m_end += count;
+            m_buffer[m_end] = '\0';
+            if (count == 0)
+            {
+                m_eof = true;
+            }
+            return true;
+        }
+
+        inline bool is_csv_blank_line(const char* first, const char* last, const std::string& comments)
+        {
+            const char* it = skip_csv_blanks(first, last);
+            return it == last ||
+                   (!comments.empty() && std::size_t(last - it) >= comments.size() &&
+                    std::equal(comments.cbegin(), comments.cend(), it));
+        }
+
+        // Formats values in a block buffer written to the stream when full.
+        // Floating point values use the precision and notation of the stream,
+        // the types that are not numbers go through its stream operator.
+        class csv_writer
+        {
+        public:
+
+            explicit csv_writer(std::ostream& stream, std::size_t block_size = std::size_t(1) << 16);
+
+            csv_writer(const csv_writer&) = delete;
+            csv_writer& operator=(const csv_writer&) = delete;
+
+            template <class T>
+            void write(const T& value);
+
+            void put(char c);
+            void flush();
+
+        private:
+
+            static constexpr std::size_t max_number_size = 128;
+
+            char* reserve(std::size_t n);
+
+            template <class T>
+            void write_impl(const T& value, std::true_type /*number*/);
+            template <class T>
+            void write_impl(const T& value, std::false_type /*number*/);
+
+            void write_number(long long value);
+            void write_number(unsigned long long value);
+            void write_number(double value);
+            void write_number(long double value);
+
+            template <class T>
+            void write_formatted(const char* format, T value);
+
+            std::ostream& m_stream;
+            std::vector<char> m_buffer;
+            std::size_t m_size;
+            std::ostringstream m_fallback;
+            int m_precision;
+            char m_format;
+        };
+
+        inline csv_writer::csv_writer(std::ostream& stream, std::size_t block_size)
+            : m_stream(stream), m_buffer(std::max(block_size, max_number_size)), m_size(0)
+        {
+            m_fallback.copyfmt(stream);
+            m_precision = static_cast<int>(stream.precision());
+            std::ios_base::fmtflags floatfield = stream.flags() & std::ios_base::floatfield;
+            m_format = floatfield == std::ios_base::fixed ? 'f' : (floatfield == std::ios_base::scientific ? 'e' : 'g');
+        }
+
+        template <class T>
+        inline void csv_writer::write(const T& value)
+        {
+            write_impl(value, is_csv_number<T>());
+        }
+
+        inline void csv_writer::put(char c)
+        {
+            *reserve(1) = c;
+            ++m_size;
+        }
+
+        inline void csv_writer::flush()
+        {
+            m_stream.write(m_buffer.data(), static_cast<std::streamsize>(m_size));
+            m_size = 0;
+        }
+
+        inline char* csv_writer::reserve(std::size_t n)
+        {
+            if (m_size + n > m_buffer.size())
+            {
+                flush();
+                if (n > m_buffer.size())
+                {
+                    m_buffer.resize(n);
+                }
+            }
+            return m_buffer.data() + m_size;
+        }
+
+        template <class T>
+        inline void csv_writer::write_impl(const T& value, std::true_type /*number*/)
+        {
+            using number_type = std::conditional_t<std::is_floating_point<T>::value,
+                                                   std::conditional_t<std::is_same<T, long double>::value, long double, double>,
+                                                   std::conditional_t<std::is_signed<T>::value, long long, unsigned long long>>;
+            write_number(static_cast<number_type>(value));
+        }
+
+        template <class T>
+        inline void csv_writer::write_impl(const T& value, std::false_type /*number*/)
+        {
+            m_fallback.str(std::string());
+            m_fallback << value;
+            std::string str = m_fallback.str();
+            std::copy(str.cbegin(), str.cend(), reserve(str.size()));
+            m_size += str.size();
+        }
+
+        inline void csv_writer::write_number(long long value)
+        {
+            if (value < 0)
+            {
+                put('-');
+                write_number(~static_cast<unsigned long long>(value) + 1);
+            }
+            else
+            {
+                write_number(static_cast<unsigned long long>(value));
+            }
+        }
+
+        inline void csv_writer::write_number(unsigned long long value)
+        {
+            char digits[std::numeric_limits<unsigned long long>::digits10 + 1];
+            std::size_t n = 0;
+            do
+            {
+                digits[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value != 0);
+            char* out = reserve(n);
+            std::reverse_copy(digits, digits + n, out);
+            m_size += n;
+        }
+
+        inline void csv_writer::write_number(double value)
+        {
+            const char format[] = {'%', '.', '*', m_format, '\0'};
+            write_formatted(format, value);
+        }
+
+        inline void csv_writer::write_number(long double value)
+        {
+            const char format[] = {'%', '.', '*', 'L', m_format, '\0'};
+            write_formatted(format, value);
+        }
+
+        template <class T>
+        inline void csv_writer::write_formatted(const char* format, T value)
+        {
+            char* out = reserve(max_number_size);
+            int n = std::snprintf(out, max_number_size, format, m_precision, value);
+            if (n < 0)
+            {
+                throw std::runtime_error("Could not format value for CSV");
+            }
+            if (n >= static_cast<int>(max_number_size))
+            {
+                // Large values in fixed notation
+                std::string str(static_cast<std::size_t>(n) + 1, '\0');
+                std::snprintf(&str[0], str.size(), format, m_precision, value);
+                std::copy(str.cbegin(), str.cend() - 1, reserve(str.size()));
+            }
+            m_size += static_cast<std::size_t>(n);
         }
     }
 
     /**
      * @brief Load tensor from CSV.
-     * 
-     * Returns an \ref xexpression for the parsed CSV
+     *
+     * Returns an \ref xexpression for the parsed CSV. The stream is read by
+     * blocks and the values are parsed in place, without intermediate
+     * strings for numeric types. When the stream is seekable, the storage
+     * of the result is pre-allocated from the remaining length of the stream.
+     * Blank lines and lines starting with \c comments, possibly after
+     * blanks, are ignored.
+     * Numeric cells must contain a single value, possibly surrounded by
+     * blanks, otherwise a \c std::runtime_error is thrown; the fractional
+     * part of a cell read as an integer is truncated, e.g. "1.5" gives 1.
+     * When the stream is seekable, it is left at the beginning of the line
+     * following the last row read, so that it can be read further after
+     * a call with \c max_rows; the position of other streams is
+     * unspecified.
      * @param stream the input stream containing the CSV encoded values
+     * @param delimiter the character separating the values of a row
+     * @param skip_rows the number of lines to skip at the beginning of the
+     * stream, e.g. a header
+     * @param max_rows the maximum number of rows to read, -1 to read all rows
+     * @param comments the prefix of comment lines, empty to disable comments
+     * @param usecols the indices of the columns to read, in the order they
+     * appear in the result. All the columns are read if empty. A column
+     * cannot appear twice.
      */
     template <class T, class A>
-    xcsv_tensor<T, A> load_csv(std::istream& stream)
+    xcsv_tensor<T, A> load_csv(std::istream& stream, const char delimiter, const std::size_t skip_rows,
+                               const std::ptrdiff_t max_rows, const std::string& comments,
+                               const std::vector<std::size_t>& usecols)
     {
         using tensor_type = xcsv_tensor<T, A>;
         using storage_type = typename tensor_type::storage_type;
         using size_type = typename tensor_type::size_type;
         using inner_shape_type = typename tensor_type::inner_shape_type;
         using inner_strides_type = typename tensor_type::inner_strides_type;
-        using output_iterator = std::back_insert_iterator<storage_type>;
+        using number_type = detail::is_csv_number<T>;
+
+        // Position of each column in a row of the result, -1 for skipped columns
+        std::vector<std::ptrdiff_t> column_index;
+        for (std::size_t i = 0; i < usecols.size(); ++i)
+        {
+            if (usecols[i] >= column_index.size())
+            {
+                column_index.resize(usecols[i] + 1, -1);
+            }
+            else if (column_index[usecols[i]] >= 0)
+            {
+                throw std::runtime_error("Duplicate column index in usecols: " + std::to_string(usecols[i]));
+            }
+            column_index[usecols[i]] = static_cast<std::ptrdiff_t>(i);
+        }
 
         storage_type data;
         size_type nbrow = 0, nbcol = 0;
+        detail::csv_line_reader reader(stream);
+        const char* first;
+        const char* last;
+        for (std::size_t i = 0; i < skip_rows && reader.next(first, last); ++i)
+        {
+        }
+
+        while ((max_rows < 0 || nbrow < static_cast<size_type>(max_rows)) && reader.next(first, last))
         {
-            output_iterator output(data);
-            std::string row, cell;
-            while (std::getline(stream, row))
+            if (detail::is_csv_blank_line(first, last, comments))
+            {
+                continue;
+            }
+            std::size_t line_size = static_cast<std::size_t>(last - first);
+
+            size_type row_begin = data.size();
+            size_type col = 0;
+            if (usecols.empty())
+            {
+                while (true)
+                {
+                    T value;
+                    first = detail::parse_csv_cell(first, last, delimiter, value, number_type());
+                    data.push_back(std::move(value));
+                    ++col;
+                    if (first == last)
+                    {
+                        break;
+                    }
+                    ++first;
+                }
+            }
+            else
+            {
+                data.resize(row_begin + usecols.size());
+                for (; col < column_index.size(); ++col)
+                {
+                    if (column_index[col] >= 0)
+                    {
+                        T& value = data[row_begin + static_cast<size_type>(column_index[col])];
+                        first = detail::parse_csv_cell(first, last, delimiter, value, number_type());
+                    }
+                    else
+                    {
+                        first = std::find(first, last, delimiter);
+                    }
+                    if (first == last)
+                    {
+                        ++col;
+                        break;
+                    }
+                    ++first;
+                }
+                if (col < column_index.size())
+                {
+                    throw std::runtime_error("Column index out of range in CSV");
+                }
+                col = usecols.size();
+            }
+
+            if (nbrow == 0)
+            {
+                nbcol = col;
+                std::size_t expected_rows = reader.remaining_bytes() / (line_size + 1) + 1;
+                if (max_rows >= 0)
+                {
+                    expected_rows = std::min(expected_rows, static_cast<std::size_t>(max_rows));
+                }
+                data.reserve(nbcol * expected_rows);
+            }
+            else if (col != nbcol)
             {
-                std::stringstream row_stream(row);
-                nbcol = detail::load_csv_row<size_type, T, output_iterator>(row_stream, output, cell);
-                ++nbrow;
+                throw std::runtime_error("Inconsistent row lengths in CSV");
             }
+            ++nbrow;
         }
+        reader.unread();
+
         inner_shape_type shape = {nbrow, nbcol};
         inner_strides_type strides;  // no need for initializer list for stack-allocated strides_type
         size_type data_size = compute_strides(shape, layout_type::row_major, strides);
@@ -141,12 +627,17 @@ namespace xt
 
     /**
      * @brief Dump tensor to CSV.
-     * 
+     *
+     * The values are formatted in a block buffer written to the stream when
+     * full, the stream is not flushed. Floating point values are formatted
+     * with the precision and the notation (fixed, scientific or default) of
+     * the stream.
      * @param stream the output stream to write the CSV encoded values
      * @param e the tensor expression to serialize
+     * @param delimiter the character separating the values of a row
      */
     template <class E>
-    void dump_csv(std::ostream& stream, const xexpression<E>& e)
+    void dump_csv(std::ostream& stream, const xexpression<E>& e, const char delimiter)
     {
         using size_type = typename E::size_type;
         const E& ex = e.derived_cast();
@@ -154,26 +645,23 @@ namespace xt
         {
             throw std::runtime_error("Only 2-D expressions can be serialized to CSV");
         }
-        size_type nbrows = ex.shape()[0], nbcols = ex.shape()[1];
-        auto st = ex.stepper_begin(ex.shape());
-        for (size_type r = 0; r != nbrows; ++r)
+        size_type nbcols = ex.shape()[1];
+        detail::csv_writer writer(stream);
+        size_type c = 0;
+        for (auto it = ex.template cbegin<layout_type::row_major>(); it != ex.template cend<layout_type::row_major>(); ++it)
         {
-            for (size_type c = 0; c != nbcols; ++c)
+            writer.write(*it);
+            if (++c != nbcols)
             {
-                stream << *st;
-                if (c != nbcols - 1)
-                {
-                    st.step(1);
-                    stream << ',';
-                }
-                else
-                {
-                    st.reset(1);
-                    st.step(0);
-                    stream << std::endl;
-                }
+                writer.put(delimiter);
+            }
+            else
+            {
+                writer.put('\n');
+                c = 0;
             }
         }
+        writer.flush();
     }
 }
 
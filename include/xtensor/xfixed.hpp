@@ -289,6 +289,7 @@ namespace xt
         xfixed_container(const value_type& v);
         explicit xfixed_container(const inner_shape_type& shape, layout_type l = L);
         explicit xfixed_container(const inner_shape_type& shape, value_type v, layout_type l = L);
+        explicit xfixed_container(const inner_shape_type& shape, uninitialized_t, layout_type l = L);
 
         // remove this enable_if when removing the other value_type constructor
         template <class IX = std::integral_constant<std::size_t, N>, class EN = std::enable_if_t<IX::value != 0, int>>
@@ -310,6 +311,8 @@ namespace xt
 
         template <class ST = std::array<std::size_t, N>>
         static xfixed_container from_shape(ST&& /*s*/);
+        template <class ST = std::array<std::size_t, N>>
+        static xfixed_container from_shape(ST&& /*s*/, uninitialized_t);
 
         template <class ST = std::array<std::size_t, N>>
         void resize(ST&& shape, bool force = false) const;
@@ -317,6 +320,10 @@ namespace xt
         void resize(ST&& shape, layout_type l) const;
         template <class ST = shape_type>
         void resize(ST&& shape, const strides_type& strides) const;
+        template <class ST = std::array<std::size_t, N>>
+        void resize(ST&& shape, uninitialized_t, bool force = false) const;
+        template <class ST = shape_type>
+        void resize(ST&& shape, layout_type l, uninitialized_t) const;
 
         template <class ST = std::array<std::size_t, N>>
         void reshape(ST&& shape, layout_type layout = L) const;
@@ -539,6 +546,20 @@ namespace xt
         std::fill(m_storage.begin(), m_storage.end(), v);
     }
 
+    /**
+     * Create an xfixed_container with default-initialized elements. This is the
+     * behavior of all the constructors of xfixed_container that do not take values,
+     * this overload is only provided for homogenity with the other containers.
+     *
+     * @param shape the shape of the xfixed_container (unused!)
+     * @param l the layout_type of the xfixed_container (unused!)
+     */
+    template <class ET, class S, layout_type L, class Tag>
+    inline xfixed_container<ET, S, L, Tag>::xfixed_container(const inner_shape_type& shape, uninitialized_t, layout_type l)
+        : xfixed_container(shape, l)
+    {
+    }
+
     namespace detail
     {
         template <std::size_t X>
@@ -578,6 +599,13 @@ namespace xt
         return tmp;
     }
 
+    template <class ET, class S, layout_type L, class Tag>
+    template <class ST>
+    inline xfixed_container<ET, S, L, Tag> xfixed_container<ET, S, L, Tag>::from_shape(ST&& shape, uninitialized_t)
+    {
+        return from_shape(std::forward<ST>(shape));
+    }
+
     /**
      * Allocates an xfixed_container with shape S with values from a C array.
      * The type returned by get_init_type_t is raw C array ``value_type[X][Y][Z]`` for ``xt::xshape<X, Y, Z>``. 
@@ -658,6 +686,28 @@ namespace xt
         XTENSOR_ASSERT(std::equal(strides.begin(), strides.end(), m_strides.begin()) && strides.size() == m_strides.size());
     }
 
+    /**
+     * Note that the xfixed_container **cannot** be resized. Attempting to resize with a different
+     * size throws an assert in debug mode.
+     */
+    template <class ET, class S, layout_type L, class Tag>
+    template <class ST>
+    inline void xfixed_container<ET, S, L, Tag>::resize(ST&& shape, uninitialized_t, bool force) const
+    {
+        resize(std::forward<ST>(shape), force);
+    }
+
+    /**
+     * Note that the xfixed_container **cannot** be resized. Attempting to resize with a different
+     * size throws an assert in debug mode.
+     */
+    template <class ET, class S, layout_type L, class Tag>
+    template <class ST>
+    inline void xfixed_container<ET, S, L, Tag>::resize(ST&& shape, layout_type l, uninitialized_t) const
+    {
+        resize(std::forward<ST>(shape), l);
+    }
+
     /**
      * Note that the xfixed_container **cannot** be reshaped to a shape different from ``S``.
      */
@@ -13,11 +13,136 @@
 #ifndef XTENSOR_HISTOGRAM_HPP
 #define XTENSOR_HISTOGRAM_HPP
 
-#include "xtensor.hpp"
+#include <algorithm>
+#include <cmath>
+
+#include "xparallel.hpp"
 #include "xsort.hpp"
+#include "xtensor.hpp"
 
 namespace xt
 {
+    namespace detail
+    {
+        /**
+         * Finds the bin of a sample given sorted bin-edges. Values lower than
+         * the second edge belong to the first bin, values greater than or equal
+         * to the one before last edge belong to the last bin. The lookup is
+         * done in constant time when the edges are (nearly) evenly spaced,
+         * and by binary search otherwise.
+         */
+        template <class T>
+        class bin_locator
+        {
+        public:
+
+            template <class E>
+            explicit bin_locator(const E& bin_edges);
+
+            std::size_t size() const noexcept;
+
+            template <class V>
+            std::size_t operator()(const V& v) const;
+
+        private:
+
+            xtensor<T, 1> m_edges;
+            std::size_t m_nbins;
+            double m_left;
+            double m_scale;
+            bool m_uniform;
+        };
+
+        template <class T>
+        template <class E>
+        inline bin_locator<T>::bin_locator(const E& bin_edges)
+            : m_edges(bin_edges), m_nbins(bin_edges.size() - 1),
+              m_left(static_cast<double>(m_edges[0])), m_scale(0.), m_uniform(false)
+        {
+            double width = (static_cast<double>(m_edges[m_nbins]) - m_left) / static_cast<double>(m_nbins);
+            if (width > 0. && std::isfinite(width))
+            {
+                m_uniform = true;
+                for (std::size_t i = 1; i < m_nbins && m_uniform; ++i)
+                {
+                    double expected = m_left + static_cast<double>(i) * width;
+                    m_uniform = std::abs(static_cast<double>(m_edges[i]) - expected) <= 0.5 * width;
+                }
+                m_scale = 1. / width;
+            }
+        }
+
+        template <class T>
+        inline std::size_t bin_locator<T>::size() const noexcept
+        {
+            return m_nbins;
+        }
+
+        template <class T>
+        template <class V>
+        inline std::size_t bin_locator<T>::operator()(const V& v) const
+        {
+            std::size_t last = m_nbins - 1;
+            if (m_uniform)
+            {
+                // guess, then fix rounding errors and deviations from uniformity
+                double t = (static_cast<double>(v) - m_left) * m_scale;
+                std::size_t i = !(t > 0.) ? 0 : (t >= static_cast<double>(last) ? last : static_cast<std::size_t>(t));
+                while (i < last && v >= m_edges[i + 1])
+                {
+                    ++i;
+                }
+                while (i > 0 && v < m_edges[i])
+                {
+                    --i;
+                }
+                return i;
+            }
+            auto first = m_edges.cbegin() + 1;
+            return static_cast<std::size_t>(std::upper_bound(first, first + static_cast<std::ptrdiff_t>(last), v) - first);
+        }
+
+        /**
+         * Adds weight_of(i) to count[bin_of(i)] for i in [0, n). In parallel
+         * mode, each chunk of samples is counted in its own buffer, and the
+         * buffers are summed at the end.
+         */
+        template <class C, class FB, class FW>
+        inline void fill_bins(C& count, std::size_t n, bool parallel, FB&& bin_of, FW&& weight_of)
+        {
+            using value_type = typename C::value_type;
+            if (!parallel || !use_parallel(n))
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    count[bin_of(i)] += weight_of(i);
+                }
+                return;
+            }
+
+            std::size_t nbins = count.size();
+            std::size_t grain = balanced_grain(n);
+            std::size_t n_chunks = (n + grain - 1) / grain;
+            xtensor<value_type, 2> partial = zeros<value_type>({n_chunks, nbins});
+            parallel_for(0, n, grain, [&](std::size_t first, std::size_t last)
+            {
+                value_type* c = partial.data() + (first / grain) * nbins;
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    c[bin_of(i)] += weight_of(i);
+                }
+            });
+            for (std::size_t k = 0; k < n_chunks; ++k)
+            {
+                const value_type* c = partial.data() + k * nbins;
+                for (std::size_t j = 0; j < nbins; ++j)
+                {
+                    count[j] += c[j];
+                }
+            }
+        }
+    }
+
     /**
      * @ingroup histogram
      * @brief Compute the histogram of a set of data.
@@ -53,23 +178,12 @@ namespace xt
         // initialize output
         xt::xtensor<value_type, 1> count = xt::zeros<value_type>({ bin_edges.size() - 1 });
 
-        // indices that sort "data"
-        auto isort = xt::argsort(data);
-
-        // index of the current bin
-        size_type ibin = 0;
-
-        // fill the histogram: loop over (sorted) data
-        for (auto& idx : isort)
-        {
-            // - proceed to the relevant bin
-            while (data[idx] >= bin_edges[ibin + 1] && ibin < bin_edges.size() - 2)
-            {
-                ++ibin;
-            }
-            // - update the count
-            count[ibin] += weights[idx];
-        }
+        // fill the histogram: each sample is binned directly
+        detail::bin_locator<typename std::decay_t<E2>::value_type> locate(bin_edges);
+        bool parallel = is_parallel_safe<std::decay_t<E1>>::value && is_parallel_safe<std::decay_t<E3>>::value;
+        detail::fill_bins(count, data.size(), parallel,
+                          [&data, &locate](std::size_t i) { return locate(data(i)); },
+                          [&weights](std::size_t i) { return weights(i); });
 
         // cast type
         xt::xtensor<R, 1> prob = xt::cast<R>(count);
@@ -392,7 +506,6 @@ namespace xt
     {
         using result_value_type = typename std::decay_t<E2>::value_type;
         using input_value_type = typename std::decay_t<E1>::value_type;
-        using size_type = typename std::decay_t<E1>::size_type;
 
         static_assert(std::is_integral<typename std::decay_t<E1>::value_type>::value,
                       "Bincount data has to be integral type.");
@@ -411,10 +524,10 @@ namespace xt
         xt::xtensor<result_value_type, 1> res = xt::zeros<result_value_type>(
             { (std::max)(minlength, std::size_t(left_right[1] + 1)) });
 
-        for (size_type i = 0; i < data.size(); ++i)
-        {
-            res(data(i)) += weights(i);
-        }
+        bool parallel = is_parallel_safe<std::decay_t<E1>>::value && is_parallel_safe<std::decay_t<E2>>::value;
+        detail::fill_bins(res, data.size(), parallel,
+                          [&data](std::size_t i) { return static_cast<std::size_t>(data(i)); },
+                          [&weights](std::size_t i) { return weights(i); });
 
         return res;
     }
@@ -11,13 +11,18 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <numeric>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "xexpression.hpp"
 #include "xiterable.hpp"
+#include "xoperation.hpp"
 #include "xstrides.hpp"
+#include "xtensor.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -48,6 +53,47 @@ namespace xt
         using xindex_view_base_t = typename xindex_view_base<CT, I>::type;
     }
 
+    /***************
+     * xflat_index *
+     ***************/
+
+    /**
+     * @class xflat_index
+     * @brief Offset of an element in the contiguous data of an expression.
+     *
+     * xflat_index is used by \ref filter instead of a multi-dimensional
+     * index when the filtered expression has a contiguous row-major data
+     * interface, so that the elements of the view are accessed without
+     * computing their offset from their index.
+     */
+    struct xflat_index
+    {
+        xflat_index() = default;
+        explicit xflat_index(std::size_t o) noexcept;
+
+        std::size_t offset;
+    };
+
+    inline xflat_index::xflat_index(std::size_t o) noexcept
+        : offset(o)
+    {
+    }
+
+    namespace detail
+    {
+        template <class E, class I>
+        inline decltype(auto) index_view_element(E&& e, const I& index)
+        {
+            return e[index];
+        }
+
+        template <class E>
+        inline decltype(auto) index_view_element(E&& e, const xflat_index& index)
+        {
+            return e.data_element(index.offset);
+        }
+    }
+
     /***************
      * xindex_view *
      ***************/
@@ -376,7 +422,7 @@ namespace xt
     template <class CT, class I>
     inline auto xindex_view<CT, I>::operator()(size_type idx) -> reference
     {
-        return m_e[m_indices[idx]];
+        return detail::index_view_element(m_e, m_indices[idx]);
     }
 
     template <class CT, class I>
@@ -404,7 +450,7 @@ namespace xt
     template <class CT, class I>
     inline auto xindex_view<CT, I>::operator()(size_type idx) const -> const_reference
     {
-        return m_e[m_indices[idx]];
+        return detail::index_view_element(m_e, m_indices[idx]);
     }
 
     template <class CT, class I>
@@ -435,7 +481,7 @@ namespace xt
     inline auto xindex_view<CT, I>::operator[](const S& index)
         -> disable_integral_t<S, reference>
     {
-        return m_e[m_indices[index[0]]];
+        return detail::index_view_element(m_e, m_indices[index[0]]);
     }
 
     template <class CT, class I>
@@ -443,7 +489,7 @@ namespace xt
     inline auto xindex_view<CT, I>::operator[](std::initializer_list<OI> index)
         -> reference
     {
-        return m_e[m_indices[*(index.begin())]];
+        return detail::index_view_element(m_e, m_indices[*(index.begin())]);
     }
 
     template <class CT, class I>
@@ -463,7 +509,7 @@ namespace xt
     inline auto xindex_view<CT, I>::operator[](const S& index) const
         -> disable_integral_t<S, const_reference>
     {
-        return m_e[m_indices[index[0]]];
+        return detail::index_view_element(m_e, m_indices[index[0]]);
     }
 
     template <class CT, class I>
@@ -471,7 +517,7 @@ namespace xt
     inline auto xindex_view<CT, I>::operator[](std::initializer_list<OI> index) const
         -> const_reference
     {
-        return m_e[m_indices[*(index.begin())]];
+        return detail::index_view_element(m_e, m_indices[*(index.begin())]);
     }
 
     template <class CT, class I>
@@ -489,7 +535,7 @@ namespace xt
     template <class It>
     inline auto xindex_view<CT, I>::element(It first, It /*last*/) -> reference
     {
-        return m_e[m_indices[(*first)]];
+        return detail::index_view_element(m_e, m_indices[(*first)]);
     }
 
     /**
@@ -501,7 +547,7 @@ namespace xt
     template <class It>
     inline auto xindex_view<CT, I>::element(It first, It /*last*/) const -> const_reference
     {
-        return m_e[m_indices[(*first)]];
+        return detail::index_view_element(m_e, m_indices[(*first)]);
     }
 
     /**
@@ -751,11 +797,53 @@ namespace xt
     }
 #endif
 
+    namespace detail
+    {
+        template <class E>
+        using has_flat_filter = std::integral_constant<bool, has_data_interface<E>::value &&
+                                                             E::contiguous_layout &&
+                                                             E::static_layout == layout_type::row_major>;
+
+        template <class E, class O>
+        inline auto filter_indices(const E& /*e*/, const O& condition, std::false_type)
+        {
+            return argwhere(condition);
+        }
+
+        template <class E, class O>
+        inline auto filter_indices(const E& e, const O& condition, std::true_type)
+        {
+            std::vector<xflat_index> indices;
+            if (condition.dimension() == e.dimension() &&
+                std::equal(condition.shape().cbegin(), condition.shape().cend(), e.shape().cbegin()))
+            {
+                compact<layout_type::row_major>(condition, flat_index_source{}, indices);
+            }
+            else
+            {
+                // The indices of the condition are applied to the last
+                // dimensions of e, like in element access
+                using strides_type = svector<std::size_t, 4>;
+                strides_type strides = xtl::make_sequence<strides_type>(e.dimension(), std::size_t(0));
+                compute_strides(e.shape(), layout_type::row_major, strides);
+                for (const auto& idx : argwhere(condition))
+                {
+                    std::size_t n = std::min(idx.size(), strides.size());
+                    indices.emplace_back(std::inner_product(idx.cend() - static_cast<std::ptrdiff_t>(n), idx.cend(),
+                                                            strides.cend() - static_cast<std::ptrdiff_t>(n), std::size_t(0)));
+                }
+            }
+            return indices;
+        }
+    }
+
     /**
      * @brief creates a view into \a e filtered by \a condition.
      *
      * Returns a 1D view with the elements selected where \a condition evaluates to \em true.
      * This is equivalent to \verbatim{index_view(e, argwhere(condition));}\endverbatim
+     * When \a e is a row-major container, the view stores the flat offsets
+     * of the selected elements instead of their multi-dimensional indices.
      * The returned view is not optimal if you just want to assign a scalar to the filtered
      * elements. In that case, you should consider using the \ref filtration function
      * instead.
@@ -774,11 +862,48 @@ namespace xt
     template <class E, class O>
     inline auto filter(E&& e, O&& condition) noexcept
     {
-        auto indices = argwhere(std::forward<O>(condition));
+        auto indices = detail::filter_indices(e, condition, detail::has_flat_filter<std::decay_t<E>>());
         using view_type = xindex_view<xclosure_t<E>, decltype(indices)>;
         return view_type(std::forward<E>(e), std::move(indices));
     }
 
+    /**
+     * @brief returns the elements of \a e where \a condition evaluates to \em true.
+     *
+     * Returns a 1D tensor holding the selected elements in row-major order,
+     * equivalent to \verbatim{xtensor<value_type, 1>(filter(e, condition))}\endverbatim
+     * and to \c numpy.extract. The condition and the values are evaluated
+     * in a single pass and the index array of \ref filter is not built.
+     *
+     * @param condition xexpression with shape of \a e which selects the elements
+     * @param e the xexpression whose elements are extracted
+     *
+     * \code{.cpp}
+     * xarray<double> a = {{1,5,3}, {4,5,6}};
+     * xtensor<double, 1> b = extract(a >= 5, a);
+     * std::cout << b << std::endl; // {5, 5, 6}
+     * \endcode
+     *
+     * \sa filter
+     */
+    template <class C, class E>
+    inline auto extract(const C& condition, const E& e)
+    {
+        using result_type = xtensor<typename E::value_type, 1>;
+        using storage_type = typename result_type::storage_type;
+
+        if (condition.dimension() != e.dimension() ||
+            !std::equal(condition.shape().cbegin(), condition.shape().cend(), e.shape().cbegin()))
+        {
+            throw std::runtime_error("extract: condition and expression shapes mismatch");
+        }
+
+        storage_type storage;
+        detail::compact<layout_type::row_major>(condition, detail::make_flat_value_source<layout_type::row_major>(e), storage);
+        std::size_t size = storage.size();
+        return result_type(std::move(storage), {size}, {std::size_t(1)});
+    }
+
     /**
      * @brief creates a filtration of \c e filtered by \a condition.
      *
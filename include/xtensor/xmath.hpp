@@ -571,6 +571,18 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
         };
     }
 
+    template <class T>
+    struct simd_reducer_traits<math::minimum<T>>
+        : detail::simd_apply_reducer_traits<math::minimum<T>>
+    {
+    };
+
+    template <class T>
+    struct simd_reducer_traits<math::maximum<T>>
+        : detail::simd_apply_reducer_traits<math::maximum<T>>
+    {
+    };
+
     /**
      * @ingroup basic_functions
      * @brief Elementwise maximum
@@ -2027,20 +2039,22 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      * \em axis (or flattened).
      * @param e an \ref xexpression
      * @param axis the axes along which the cumulative sum is computed (optional)
-     * @return an \ref xarray<T>
+     * @param es evaluation strategy of the accumulation (immediate (default) or lazy)
+     * @return an \ref xarray<T>, or an \ref xaccumulator if \c es is lazy
      */
-    template <class E>
-    inline auto cumsum(E&& e, std::ptrdiff_t axis)
+    template <class E, class EVS = DEFAULT_STRATEGY_ACCUMULATORS>
+    inline auto cumsum(E&& e, std::ptrdiff_t axis, EVS es = EVS())
     {
         using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(std::plus<result_type>()), std::forward<E>(e), axis);
+        return accumulate(make_xaccumulator_functor(std::plus<result_type>()), std::forward<E>(e), axis, es);
     }
 
-    template <class E>
-    inline auto cumsum(E&& e)
+    template <class E, class EVS = DEFAULT_STRATEGY_ACCUMULATORS,
+              XTENSOR_REQUIRE<std::is_base_of<evaluation_strategy::base, std::decay_t<EVS>>::value>>
+    inline auto cumsum(E&& e, EVS es = EVS())
     {
         using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(std::plus<result_type>()), std::forward<E>(e));
+        return accumulate(make_xaccumulator_functor(std::plus<result_type>()), std::forward<E>(e), es);
     }
 
     /**
@@ -2051,20 +2065,22 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      * \em axis (or flattened).
      * @param e an \ref xexpression
      * @param axis the axes along which the cumulative product is computed (optional)
-     * @return an \ref xarray<T>
+     * @param es evaluation strategy of the accumulation (immediate (default) or lazy)
+     * @return an \ref xarray<T>, or an \ref xaccumulator if \c es is lazy
      */
-    template <class E>
-    inline auto cumprod(E&& e, std::ptrdiff_t axis)
+    template <class E, class EVS = DEFAULT_STRATEGY_ACCUMULATORS>
+    inline auto cumprod(E&& e, std::ptrdiff_t axis, EVS es = EVS())
     {
         using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(std::multiplies<result_type>()), std::forward<E>(e), axis);
+        return accumulate(make_xaccumulator_functor(std::multiplies<result_type>()), std::forward<E>(e), axis, es);
     }
 
-    template <class E>
-    inline auto cumprod(E&& e)
+    template <class E, class EVS = DEFAULT_STRATEGY_ACCUMULATORS,
+              XTENSOR_REQUIRE<std::is_base_of<evaluation_strategy::base, std::decay_t<EVS>>::value>>
+    inline auto cumprod(E&& e, EVS es = EVS())
     {
         using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(std::multiplies<result_type>()), std::forward<E>(e));
+        return accumulate(make_xaccumulator_functor(std::multiplies<result_type>()), std::forward<E>(e), es);
     }
 
     /*****************
@@ -2133,6 +2149,16 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
         };
     }
 
+    template <class T>
+    struct accumulator_scan_traits<detail::nan_plus<T>> : accumulator_scan_traits<std::plus<T>>
+    {
+    };
+
+    template <class T>
+    struct accumulator_scan_traits<detail::nan_multiplies<T>> : accumulator_scan_traits<std::multiplies<T>>
+    {
+    };
+
     /**
      * @defgroup  nan_functions nan functions
      */
@@ -2304,20 +2330,22 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      * \em axis, replacing nan with 0.
      * @param e an \ref xexpression
      * @param axis the axis along which the elements are accumulated (optional)
-     * @return an xaccumulator
+     * @param es evaluation strategy of the accumulation (immediate (default) or lazy)
+     * @return an \ref xarray<T>, or an \ref xaccumulator if \c es is lazy
      */
-    template <class E>
-    inline auto nancumsum(E&& e, std::ptrdiff_t axis)
+    template <class E, class EVS = DEFAULT_STRATEGY_ACCUMULATORS>
+    inline auto nancumsum(E&& e, std::ptrdiff_t axis, EVS es = EVS())
     {
         using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(detail::nan_plus<result_type>(), detail::nan_init<result_type, 0>()), std::forward<E>(e), axis);
+        return accumulate(make_xaccumulator_functor(detail::nan_plus<result_type>(), detail::nan_init<result_type, 0>()), std::forward<E>(e), axis, es);
     }
 
-    template <class E>
-    inline auto nancumsum(E&& e)
+    template <class E, class EVS = DEFAULT_STRATEGY_ACCUMULATORS,
+              XTENSOR_REQUIRE<std::is_base_of<evaluation_strategy::base, std::decay_t<EVS>>::value>>
+    inline auto nancumsum(E&& e, EVS es = EVS())
     {
         using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(detail::nan_plus<result_type>(), detail::nan_init<result_type, 0>()), std::forward<E>(e));
+        return accumulate(make_xaccumulator_functor(detail::nan_plus<result_type>(), detail::nan_init<result_type, 0>()), std::forward<E>(e), es);
     }
 
     /**
@@ -2328,20 +2356,22 @@ XTENSOR_INT_SPECIALIZATION_IMPL(FUNC_NAME, RETURN_VAL, unsigned long long);
      * \em axis, replacing nan with 1.
      * @param e an \ref xexpression
      * @param axis the axis along which the elements are accumulated (optional)
-     * @return an xaccumulator
+     * @param es evaluation strategy of the accumulation (immediate (default) or lazy)
+     * @return an \ref xarray<T>, or an \ref xaccumulator if \c es is lazy
      */
-    template <class E>
-    inline auto nancumprod(E&& e, std::ptrdiff_t axis)
+    template <class E, class EVS = DEFAULT_STRATEGY_ACCUMULATORS>
+    inline auto nancumprod(E&& e, std::ptrdiff_t axis, EVS es = EVS())
     {
         using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(detail::nan_multiplies<result_type>(), detail::nan_init<result_type, 1>()), std::forward<E>(e), axis);
+        return accumulate(make_xaccumulator_functor(detail::nan_multiplies<result_type>(), detail::nan_init<result_type, 1>()), std::forward<E>(e), axis, es);
     }
 
-    template <class E>
-    inline auto nancumprod(E&& e)
+    template <class E, class EVS = DEFAULT_STRATEGY_ACCUMULATORS,
+              XTENSOR_REQUIRE<std::is_base_of<evaluation_strategy::base, std::decay_t<EVS>>::value>>
+    inline auto nancumprod(E&& e, EVS es = EVS())
     {
         using result_type = big_promote_type_t<typename std::decay_t<E>::value_type>;
-        return accumulate(make_xaccumulator_functor(detail::nan_multiplies<result_type>(), detail::nan_init<result_type, 1>()), std::forward<E>(e));
+        return accumulate(make_xaccumulator_functor(detail::nan_multiplies<result_type>(), detail::nan_init<result_type, 1>()), std::forward<E>(e), es);
     }
 
     namespace detail
@@ -199,7 +199,31 @@ namespace xt
 
 #define XTENSOR_EMPTY
 #define XTENSOR_COMMA ,
-#define XTENSOR_NORM_FUNCTION(NAME, RESULT_TYPE, REDUCE_EXPR, REDUCE_OP, MERGE_FUNC) \
+#define XTENSOR_NORM_FUNCTORS(NAME, REDUCE_EXPR, REDUCE_OP)                        \
+    namespace detail                                                                 \
+    {                                                                                \
+        template <class R>                                                           \
+        struct NAME##_init_fun                                                       \
+        {                                                                            \
+            template <class T>                                                       \
+            R operator()(const T& v) const                                           \
+            {                                                                        \
+                return NAME(v);                                                      \
+            }                                                                        \
+        };                                                                           \
+                                                                                     \
+        template <class R>                                                           \
+        struct NAME##_reduce_fun                                                     \
+        {                                                                            \
+            template <class T>                                                       \
+            R operator()(const R& r, const T& v) const                               \
+            {                                                                        \
+                return REDUCE_EXPR(r REDUCE_OP NAME(v));                             \
+            }                                                                        \
+        };                                                                           \
+    }
+
+#define XTENSOR_NORM_FUNCTION(NAME, RESULT_TYPE, MERGE_FUNC)                         \
     template <class E, class X, class EVS = DEFAULT_STRATEGY_REDUCERS,               \
               class = disable_evaluation_strategy<X>>                                \
     inline auto NAME(E&& e, X&& axes, EVS es = EVS()) noexcept                       \
@@ -207,14 +231,8 @@ namespace xt
         using value_type = typename std::decay_t<E>::value_type;                     \
         using result_type = RESULT_TYPE;                                             \
                                                                                      \
-        auto reduce_func = [](result_type const& r, value_type const& v) {           \
-            return REDUCE_EXPR(r REDUCE_OP NAME(v));                                 \
-        };                                                                           \
-        auto init_func = [](value_type const& v) {                                   \
-            return NAME(v);                                                          \
-        };                                                                           \
-        return reduce(make_xreducer_functor(std::move(reduce_func),                  \
-                                            std::move(init_func),                    \
+        return reduce(make_xreducer_functor(detail::NAME##_reduce_fun<result_type>(), \
+                                            detail::NAME##_init_fun<result_type>(),  \
                                             MERGE_FUNC<result_type>()),              \
                       std::forward<E>(e), std::forward<X>(axes), es);                \
     }                                                                                \
@@ -227,13 +245,39 @@ namespace xt
     }                                                                                \
     XTENSOR_NORM_FUNCTION_AXES(NAME)
 
-    XTENSOR_NORM_FUNCTION(norm_l0, unsigned long long, XTENSOR_EMPTY, +, std::plus)
-    XTENSOR_NORM_FUNCTION(norm_l1, big_promote_type_t<value_type>, XTENSOR_EMPTY, +, std::plus)
-    XTENSOR_NORM_FUNCTION(norm_sq, big_promote_type_t<value_type>, XTENSOR_EMPTY, +, std::plus)
-    XTENSOR_NORM_FUNCTION(norm_linf, decltype(norm_linf(std::declval<value_type>())), (std::max<result_type>), XTENSOR_COMMA, math::maximum)
+    XTENSOR_NORM_FUNCTORS(norm_l0, XTENSOR_EMPTY, +)
+    XTENSOR_NORM_FUNCTORS(norm_l1, XTENSOR_EMPTY, +)
+    XTENSOR_NORM_FUNCTORS(norm_sq, XTENSOR_EMPTY, +)
+    XTENSOR_NORM_FUNCTORS(norm_linf, (std::max<R>), XTENSOR_COMMA)
+
+#define XTENSOR_NORM_SIMD_FUNCTOR(FUNCTOR, ARGS, EXPR)                               \
+    template <class R>                                                               \
+    struct simd_reducer_traits<detail::FUNCTOR<R>> : std::is_floating_point<R>       \
+    {                                                                                \
+        template <class B>                                                           \
+        static B apply(const detail::FUNCTOR<R>&, ARGS)                              \
+        {                                                                            \
+            using std::abs;                                                          \
+            return EXPR;                                                             \
+        }                                                                            \
+    };
+
+    XTENSOR_NORM_SIMD_FUNCTOR(norm_l1_init_fun, const B& v, abs(v))
+    XTENSOR_NORM_SIMD_FUNCTOR(norm_l1_reduce_fun, const B& r XTENSOR_COMMA const B& v, r + abs(v))
+    XTENSOR_NORM_SIMD_FUNCTOR(norm_sq_init_fun, const B& v, v * v)
+    XTENSOR_NORM_SIMD_FUNCTOR(norm_sq_reduce_fun, const B& r XTENSOR_COMMA const B& v, r + v * v)
+    XTENSOR_NORM_SIMD_FUNCTOR(norm_linf_init_fun, const B& v, abs(v))
+    XTENSOR_NORM_SIMD_FUNCTOR(norm_linf_reduce_fun, const B& r XTENSOR_COMMA const B& v, xsimd::select(r > abs(v), r, abs(v)))
+
+    XTENSOR_NORM_FUNCTION(norm_l0, unsigned long long, std::plus)
+    XTENSOR_NORM_FUNCTION(norm_l1, big_promote_type_t<value_type>, std::plus)
+    XTENSOR_NORM_FUNCTION(norm_sq, big_promote_type_t<value_type>, std::plus)
+    XTENSOR_NORM_FUNCTION(norm_linf, decltype(norm_linf(std::declval<value_type>())), math::maximum)
 
 #undef XTENSOR_EMPTY
 #undef XTENSOR_COMMA
+#undef XTENSOR_NORM_FUNCTORS
+#undef XTENSOR_NORM_SIMD_FUNCTOR
 #undef XTENSOR_NORM_FUNCTION
 #undef XTENSOR_NORM_FUNCTION_AXES
     /// @endcond
@@ -20,6 +20,8 @@
 #include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <limits>
+#include <numeric>
 #include <regex>
 #include <sstream>
 #include <stdexcept>
@@ -346,9 +348,12 @@ namespace xt
             }
         }
 
+        // Writes the magic string and the header, padded so that the metadata
+        // spans at least min_size bytes, and returns the size of the metadata.
         template <class O, class S>
-        inline void write_header(O& out, const std::string& descr,
-                                 bool fortran_order, const S& shape)
+        inline std::size_t write_header(O& out, const std::string& descr,
+                                        bool fortran_order, const S& shape,
+                                        std::size_t min_size = 0)
         {
             std::ostringstream ss_header;
             std::string s_fortran_order;
@@ -387,13 +392,17 @@ namespace xt
             std::size_t metadata_len = magic_string_length + 2 + 2 + header_len_pre;
 
             unsigned char version[2] = {1, 0};
-            if (metadata_len >= 255 * 255)
+            if (std::max(metadata_len, min_size) >= 255 * 255)
             {
                 metadata_len = magic_string_length + 2 + 4 + header_len_pre;
                 version[0] = 2;
                 version[1] = 0;
             }
             std::size_t padding_len = 16 - metadata_len % 16;
+            if (metadata_len + padding_len < min_size)
+            {
+                padding_len = min_size - metadata_len;
+            }
             std::string padding(padding_len, ' ');
             ss_header << padding;
             ss_header << std::endl;
@@ -426,6 +435,7 @@ namespace xt
             }
 
             out << header;
+            return metadata_len + padding_len;
         }
 
         inline std::string read_header_1_0(std::istream& istream)
@@ -471,6 +481,78 @@ namespace xt
             return header;
         }
 
+        // Description of the array stored in a npy file, read from its header.
+        struct npy_header
+        {
+            std::size_t word_size() const
+            {
+                return std::size_t(atoi(&m_typestring[2]));
+            }
+
+            std::size_t n_bytes() const
+            {
+                return compute_size(m_shape) * word_size();
+            }
+
+            std::vector<std::size_t> m_shape;
+            bool m_fortran_order;
+            std::string m_typestring;
+        };
+
+        // Reads the magic string and the header of a npy file, leaving the
+        // stream at the beginning of the data.
+        inline npy_header read_npy_header(std::istream& stream)
+        {
+            // check magic bytes an version number
+            unsigned char v_major, v_minor;
+            detail::read_magic(stream, &v_major, &v_minor);
+
+            std::string header;
+
+            if (v_major == 1 && v_minor == 0)
+            {
+                header = detail::read_header_1_0(stream);
+            }
+            else if (v_major == 2 && v_minor == 0)
+            {
+                header = detail::read_header_2_0(stream);
+            }
+            else
+            {
+                throw std::runtime_error("unsupported file format version");
+            }
+
+            npy_header result;
+            detail::parse_header(header, result.m_typestring, &result.m_fortran_order, result.m_shape);
+            return result;
+        }
+
+        // Checks that the data of a npy file can be viewed as values of
+        // type T in the layout L, and returns its strides.
+        template <class T, layout_type L>
+        inline std::vector<std::size_t> check_npy_cast(const std::vector<std::size_t>& shape, bool fortran_order,
+                                                       const std::string& typestring, bool check_type)
+        {
+            // check if the typestring matches the given one
+            if (check_type && typestring != detail::build_typestring<T>())
+            {
+                throw std::runtime_error("Cast error: formats not matching "s + typestring +
+                                         " vs "s + detail::build_typestring<T>());
+            }
+
+            if ((L == layout_type::column_major && !fortran_order) ||
+                (L == layout_type::row_major && fortran_order))
+            {
+                throw std::runtime_error("Cast error: layout mismatch between npy file and requested layout.");
+            }
+
+            std::vector<std::size_t> strides(shape.size());
+            compute_strides(shape,
+                            fortran_order ? layout_type::column_major : layout_type::row_major,
+                            strides);
+            return strides;
+        }
+
         struct npy_file
         {
             npy_file() = default;
@@ -489,7 +571,7 @@ namespace xt
             {
                 if (m_buffer != nullptr)
                 {
-                    delete m_buffer;
+                    std::allocator<char>{}.deallocate(m_buffer, m_n_bytes);
                 }
             }
 
@@ -513,6 +595,10 @@ namespace xt
             {
                 if (this != &rhs)
                 {
+                    if (m_buffer != nullptr)
+                    {
+                        std::allocator<char>{}.deallocate(m_buffer, m_n_bytes);
+                    }
                     m_shape = std::move(rhs.m_shape);
                     m_fortran_order = std::move(rhs.m_fortran_order);
                     m_word_size = std::move(rhs.m_word_size);
@@ -532,25 +618,8 @@ namespace xt
                     throw std::runtime_error("This npy_file has already been cast.");
                 }
                 T* ptr = reinterpret_cast<T*>(&m_buffer[0]);
-                std::vector<std::size_t> strides(m_shape.size());
                 std::size_t sz = compute_size(m_shape);
-
-                // check if the typestring matches the given one
-                if (check_type && m_typestring != detail::build_typestring<T>())
-                {
-                    throw std::runtime_error("Cast error: formats not matching "s + m_typestring +
-                                             " vs "s + detail::build_typestring<T>());
-                }
-
-                if ((L == layout_type::column_major && !m_fortran_order) ||
-                    (L == layout_type::row_major && m_fortran_order))
-                {
-                    throw std::runtime_error("Cast error: layout mismatch between npy file and requested layout.");
-                }
-
-                compute_strides(m_shape,
-                                m_fortran_order ? layout_type::column_major : layout_type::row_major,
-                                strides);
+                std::vector<std::size_t> strides = check_npy_cast<T, L>(m_shape, m_fortran_order, m_typestring, check_type);
                 std::vector<std::size_t> shape(m_shape);
 
                 return std::make_tuple(ptr, sz, std::move(shape), std::move(strides));
@@ -601,33 +670,9 @@ namespace xt
 
         inline npy_file load_npy_file(std::istream& stream)
         {
-            // check magic bytes an version number
-            unsigned char v_major, v_minor;
-            detail::read_magic(stream, &v_major, &v_minor);
-
-            std::string header;
-
-            if (v_major == 1 && v_minor == 0)
-            {
-                header = detail::read_header_1_0(stream);
-            }
-            else if (v_major == 2 && v_minor == 0)
-            {
-                header = detail::read_header_2_0(stream);
-            }
-            else
-            {
-                throw std::runtime_error("unsupported file format version");
-            }
-
-            // parse header
-            bool fortran_order;
-            std::string typestr;
+            npy_header header = read_npy_header(stream);
 
-            std::vector<std::size_t> shape;
-            detail::parse_header(header, typestr, &fortran_order, shape);
-
-            npy_file result(shape, fortran_order, typestr);
+            npy_file result(header.m_shape, header.m_fortran_order, header.m_typestring);
             // read the data
             stream.read(result.ptr(), std::streamsize((result.n_bytes())));
             return result;
@@ -656,7 +701,6 @@ namespace xt
         }
     }  // namespace detail
 
-
     /**
      * Save xexpression to NumPy npy format
      *
@@ -697,6 +741,391 @@ namespace xt
         return std::move(file).cast<T, L>();
     }
 
+    /**************
+     * npy_reader *
+     **************/
+
+    /**
+     * @class npy_reader
+     * @brief Chunked reader of npy files.
+     *
+     * The npy_reader reads a row-major npy file by chunks of slabs along
+     * its leading axis, so that arrays larger than the available memory
+     * can be processed. Each chunk is read into the same buffer, which
+     * is allocated once for the requested number of rows.
+     *
+     * @code{.cpp}
+     * xt::npy_reader<double> reader("data.npy", 1024);
+     * while (reader.read_chunk())
+     * {
+     *     process(reader.chunk());
+     * }
+     * @endcode
+     *
+     * @tparam T the value type of the npy file (there is no dynamic casting,
+     *           the type must match the one of the file)
+     */
+    template <class T>
+    class npy_reader
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using shape_type = std::vector<size_type>;
+
+        npy_reader(const std::string& filename, size_type chunk_rows = 1);
+
+        const shape_type& shape() const noexcept;
+        size_type chunk_rows() const noexcept;
+        size_type rows_read() const noexcept;
+
+        size_type read_chunk();
+        void rewind();
+
+        auto chunk() noexcept;
+        auto chunk() const noexcept;
+
+    private:
+
+        std::ifstream m_stream;
+        std::streampos m_data_pos;
+        shape_type m_shape;
+        shape_type m_chunk_shape;
+        size_type m_row_size;
+        size_type m_chunk_rows;
+        size_type m_rows_read;
+        uvector<T> m_buffer;
+    };
+
+    /****************
+     * npy_appender *
+     ****************/
+
+    /**
+     * @class npy_appender
+     * @brief Incremental writer of npy files.
+     *
+     * The npy_appender writes a row-major npy file row by row, without
+     * holding the whole array in memory. The leading dimension of the
+     * array is the number of appended rows, it is written in the header
+     * when the appender is closed or destroyed.
+     *
+     * @tparam T the value type of the npy file
+     */
+    template <class T>
+    class npy_appender
+    {
+    public:
+
+        using value_type = T;
+        using size_type = std::size_t;
+        using shape_type = std::vector<size_type>;
+
+        template <class S = shape_type>
+        npy_appender(const std::string& filename, const S& row_shape = S());
+        ~npy_appender();
+
+        npy_appender(const npy_appender&) = delete;
+        npy_appender& operator=(const npy_appender&) = delete;
+
+        const shape_type& row_shape() const noexcept;
+        size_type rows() const noexcept;
+
+        template <class E>
+        void append(const xexpression<E>& e);
+
+        void close();
+
+    private:
+
+        template <class E>
+        size_type check_rows(const E& e) const;
+
+        template <class E>
+        void write_rows(const E& e, size_type n, std::true_type);
+        template <class E>
+        void write_rows(const E& e, size_type n, std::false_type);
+
+        void write_header();
+
+        std::ofstream m_stream;
+        shape_type m_row_shape;
+        size_type m_row_size;
+        size_type m_rows;
+        std::size_t m_header_size;
+    };
+
+    /*****************************
+     * npy_reader implementation *
+     *****************************/
+
+    /**
+     * Opens a npy file and reads its header.
+     * @param filename the filename or path to the file
+     * @param chunk_rows the maximal number of slabs along the leading axis read by each chunk
+     */
+    template <class T>
+    inline npy_reader<T>::npy_reader(const std::string& filename, size_type chunk_rows)
+        : m_stream(filename, std::ifstream::binary), m_rows_read(0)
+    {
+        if (!m_stream)
+        {
+            throw std::runtime_error("io error: failed to open file: "s + filename);
+        }
+        if (chunk_rows == 0)
+        {
+            throw std::runtime_error("npy_reader: chunks must have at least one row.");
+        }
+
+        detail::npy_header header = detail::read_npy_header(m_stream);
+        if (header.m_fortran_order && header.m_shape.size() > 1)
+        {
+            throw std::runtime_error("npy_reader: Fortran ordered arrays cannot be read by chunks.");
+        }
+        // 1-D arrays have the same layout in both orders
+        detail::check_npy_cast<T, layout_type::dynamic>(header.m_shape, header.m_fortran_order,
+                                                        header.m_typestring, true);
+        if (header.m_shape.empty())
+        {
+            throw std::runtime_error("npy_reader: 0-D arrays cannot be read by chunks.");
+        }
+
+        m_data_pos = m_stream.tellg();
+        m_shape = std::move(header.m_shape);
+        m_chunk_shape = m_shape;
+        m_row_size = std::accumulate(m_shape.cbegin() + 1, m_shape.cend(), size_type(1), std::multiplies<size_type>());
+        m_chunk_rows = std::min(chunk_rows, m_shape[0]);
+        m_buffer.resize(m_chunk_rows * m_row_size);
+        m_chunk_shape[0] = 0;
+    }
+
+    /**
+     * Returns the shape of the whole array stored in the file.
+     */
+    template <class T>
+    inline auto npy_reader<T>::shape() const noexcept -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    /**
+     * Returns the maximal number of rows of a chunk.
+     */
+    template <class T>
+    inline auto npy_reader<T>::chunk_rows() const noexcept -> size_type
+    {
+        return m_chunk_rows;
+    }
+
+    /**
+     * Returns the number of rows read so far, including the current chunk.
+     */
+    template <class T>
+    inline auto npy_reader<T>::rows_read() const noexcept -> size_type
+    {
+        return m_rows_read;
+    }
+
+    /**
+     * Reads the next chunk into the buffer.
+     * @return the number of rows of the chunk, 0 when the whole file has been read
+     */
+    template <class T>
+    inline auto npy_reader<T>::read_chunk() -> size_type
+    {
+        size_type n = std::min(m_chunk_rows, m_shape[0] - m_rows_read);
+        std::streamsize n_bytes = static_cast<std::streamsize>(n * m_row_size * sizeof(T));
+        m_stream.read(reinterpret_cast<char*>(m_buffer.data()), n_bytes);
+        if (m_stream.gcount() != n_bytes)
+        {
+            throw std::runtime_error("io error: npy file is truncated.");
+        }
+        m_rows_read += n;
+        m_chunk_shape[0] = n;
+        return n;
+    }
+
+    /**
+     * Goes back to the beginning of the data, the next chunk is the first
+     * one of the file.
+     */
+    template <class T>
+    inline void npy_reader<T>::rewind()
+    {
+        m_stream.clear();
+        m_stream.seekg(m_data_pos);
+        m_rows_read = 0;
+        m_chunk_shape[0] = 0;
+    }
+
+    /**
+     * Returns an array adaptor on the current chunk. Its leading dimension
+     * is the number of rows of the chunk, the adaptor is invalidated by the
+     * next call to read_chunk.
+     */
+    template <class T>
+    inline auto npy_reader<T>::chunk() noexcept
+    {
+        return adapt<layout_type::row_major>(m_buffer.data(), m_chunk_shape[0] * m_row_size, no_ownership(), m_chunk_shape);
+    }
+
+    /**
+     * Returns a constant array adaptor on the current chunk.
+     */
+    template <class T>
+    inline auto npy_reader<T>::chunk() const noexcept
+    {
+        return adapt<layout_type::row_major>(m_buffer.data(), m_chunk_shape[0] * m_row_size, no_ownership(), m_chunk_shape);
+    }
+
+    /*******************************
+     * npy_appender implementation *
+     *******************************/
+
+    /**
+     * Creates the npy file and writes a header for an empty array.
+     * @param filename the filename or path to the file
+     * @param row_shape the shape of a row, i.e. of the array without its leading axis
+     */
+    template <class T>
+    template <class S>
+    inline npy_appender<T>::npy_appender(const std::string& filename, const S& row_shape)
+        : m_stream(filename, std::ofstream::binary),
+          m_row_shape(std::begin(row_shape), std::end(row_shape)),
+          m_rows(0)
+    {
+        if (!m_stream)
+        {
+            throw std::runtime_error("IO Error: failed to open file: "s + filename);
+        }
+        m_row_size = compute_size(m_row_shape);
+
+        // Reserve room in the header for the largest leading dimension
+        shape_type max_shape(m_row_shape.size() + 1, std::numeric_limits<size_type>::max());
+        std::ostringstream max_header;
+        m_header_size = detail::write_header(max_header, detail::build_typestring<T>(), false, max_shape);
+        write_header();
+    }
+
+    /**
+     * Closes the appender, see close.
+     */
+    template <class T>
+    inline npy_appender<T>::~npy_appender()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /**
+     * Returns the shape of a row.
+     */
+    template <class T>
+    inline auto npy_appender<T>::row_shape() const noexcept -> const shape_type&
+    {
+        return m_row_shape;
+    }
+
+    /**
+     * Returns the number of rows appended so far.
+     */
+    template <class T>
+    inline auto npy_appender<T>::rows() const noexcept -> size_type
+    {
+        return m_rows;
+    }
+
+    /**
+     * Appends rows to the file. The expression is either a single row,
+     * whose shape is the row shape, or a block of rows, whose shape is the
+     * row shape preceded by the number of rows.
+     * @param e the xexpression to append
+     */
+    template <class T>
+    template <class E>
+    inline void npy_appender<T>::append(const xexpression<E>& e)
+    {
+        if (!m_stream.is_open())
+        {
+            throw std::runtime_error("npy_appender: cannot append to a closed file.");
+        }
+        const E& de = e.derived_cast();
+        size_type n = check_rows(de);
+        using is_contiguous = xtl::conjunction<std::is_same<typename E::value_type, T>,
+                                               has_data_interface<E>,
+                                               std::integral_constant<bool, E::contiguous_layout &&
+                                                                                E::static_layout == layout_type::row_major>>;
+        write_rows(de, n, is_contiguous());
+        m_rows += n;
+    }
+
+    /**
+     * Writes the final shape in the header and closes the file. Calling
+     * close on a closed appender has no effect.
+     */
+    template <class T>
+    inline void npy_appender<T>::close()
+    {
+        if (m_stream.is_open())
+        {
+            m_stream.seekp(0);
+            write_header();
+            m_stream.close();
+            if (m_stream.fail())
+            {
+                throw std::runtime_error("io error: failed writing npy file.");
+            }
+        }
+    }
+
+    template <class T>
+    template <class E>
+    inline auto npy_appender<T>::check_rows(const E& e) const -> size_type
+    {
+        const auto& shape = e.shape();
+        std::size_t dim = shape.size();
+        if (dim == m_row_shape.size() && std::equal(shape.cbegin(), shape.cend(), m_row_shape.cbegin()))
+        {
+            return 1;
+        }
+        if (dim == m_row_shape.size() + 1 && std::equal(shape.cbegin() + 1, shape.cend(), m_row_shape.cbegin()))
+        {
+            return shape[0];
+        }
+        throw std::runtime_error("npy_appender: shape mismatch, cannot append rows.");
+    }
+
+    template <class T>
+    template <class E>
+    inline void npy_appender<T>::write_rows(const E& e, size_type n, std::true_type)
+    {
+        m_stream.write(reinterpret_cast<const char*>(e.data() + e.data_offset()),
+                       static_cast<std::streamsize>(n * m_row_size * sizeof(T)));
+    }
+
+    template <class T>
+    template <class E>
+    inline void npy_appender<T>::write_rows(const E& e, size_type n, std::false_type)
+    {
+        xarray<T, layout_type::row_major> tmp = e;
+        write_rows(tmp, n, std::true_type());
+    }
+
+    template <class T>
+    inline void npy_appender<T>::write_header()
+    {
+        shape_type shape(m_row_shape.size() + 1);
+        shape[0] = m_rows;
+        std::copy(m_row_shape.cbegin(), m_row_shape.cend(), shape.begin() + 1);
+        detail::write_header(m_stream, detail::build_typestring<T>(), false, shape, m_header_size);
+    }
+
 }  // namespace xt
 
 #endif
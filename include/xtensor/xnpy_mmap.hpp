@@ -0,0 +1,375 @@
+/***************************************************************************
+* Copyright (c) 2016, Leon Merten Lohse, Johan Mabille, Sylvain Corlay and *
+*                     Wolf Vollprecht                                      *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_NPY_MMAP_HPP
+#define XTENSOR_NPY_MMAP_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// The platform headers are only included by the memory mapping API, so
+// that xnpy.hpp does not expose the Windows macros to its users.
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#define XTENSOR_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#define XTENSOR_UNDEF_NOMINMAX
+#endif
+#include <windows.h>
+#ifdef XTENSOR_UNDEF_WIN32_LEAN_AND_MEAN
+#undef WIN32_LEAN_AND_MEAN
+#undef XTENSOR_UNDEF_WIN32_LEAN_AND_MEAN
+#endif
+#ifdef XTENSOR_UNDEF_NOMINMAX
+#undef NOMINMAX
+#undef XTENSOR_UNDEF_NOMINMAX
+#endif
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "xtensor/xadapt.hpp"
+#include "xtensor/xnpy.hpp"
+
+namespace xt
+{
+    namespace detail
+    {
+        /****************
+         * xmapped_file *
+         ****************/
+
+        // Read-only or private (copy-on-write) memory mapping of a whole file.
+        class xmapped_file
+        {
+        public:
+
+            xmapped_file(const std::string& filename, bool copy_on_write);
+            ~xmapped_file();
+
+            xmapped_file(const xmapped_file&) = delete;
+            xmapped_file& operator=(const xmapped_file&) = delete;
+
+            char* data() const noexcept;
+            std::size_t size() const noexcept;
+
+        private:
+
+            char* p_data;
+            std::size_t m_size;
+#if defined(_WIN32)
+            HANDLE m_file;
+            HANDLE m_mapping;
+#endif
+        };
+
+#if defined(_WIN32)
+
+        inline xmapped_file::xmapped_file(const std::string& filename, bool copy_on_write)
+            : p_data(nullptr), m_size(0), m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+        {
+            m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                 OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (m_file == INVALID_HANDLE_VALUE)
+            {
+                throw std::runtime_error("io error: failed to open file: "s + filename);
+            }
+            LARGE_INTEGER file_size;
+            if (!GetFileSizeEx(m_file, &file_size))
+            {
+                CloseHandle(m_file);
+                throw std::runtime_error("io error: failed to get the size of file: "s + filename);
+            }
+            m_size = static_cast<std::size_t>(file_size.QuadPart);
+            m_mapping = CreateFileMappingA(m_file, nullptr, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY,
+                                           0, 0, nullptr);
+            if (m_mapping != nullptr)
+            {
+                p_data = static_cast<char*>(MapViewOfFile(m_mapping, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ,
+                                                          0, 0, 0));
+            }
+            if (p_data == nullptr)
+            {
+                if (m_mapping != nullptr)
+                {
+                    CloseHandle(m_mapping);
+                }
+                CloseHandle(m_file);
+                throw std::runtime_error("io error: failed to map file: "s + filename);
+            }
+        }
+
+        inline xmapped_file::~xmapped_file()
+        {
+            UnmapViewOfFile(p_data);
+            CloseHandle(m_mapping);
+            CloseHandle(m_file);
+        }
+
+#else
+
+        inline xmapped_file::xmapped_file(const std::string& filename, bool copy_on_write)
+            : p_data(nullptr), m_size(0)
+        {
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd == -1)
+            {
+                throw std::runtime_error("io error: failed to open file: "s + filename);
+            }
+            struct stat file_stat;
+            if (::fstat(fd, &file_stat) == -1)
+            {
+                ::close(fd);
+                throw std::runtime_error("io error: failed to get the size of file: "s + filename);
+            }
+            m_size = static_cast<std::size_t>(file_stat.st_size);
+            void* ptr = ::mmap(nullptr, m_size, copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ,
+                               copy_on_write ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+            // The mapping stays valid after the file descriptor is closed
+            ::close(fd);
+            if (ptr == MAP_FAILED)
+            {
+                throw std::runtime_error("io error: failed to map file: "s + filename);
+            }
+            p_data = static_cast<char*>(ptr);
+        }
+
+        inline xmapped_file::~xmapped_file()
+        {
+            ::munmap(p_data, m_size);
+        }
+
+#endif
+
+        inline char* xmapped_file::data() const noexcept
+        {
+            return p_data;
+        }
+
+        inline std::size_t xmapped_file::size() const noexcept
+        {
+            return m_size;
+        }
+    }  // namespace detail
+
+    /****************************
+     * memory mapped npy arrays *
+     ****************************/
+
+    /**
+     * Access mode of a memory mapped npy file.
+     * - read_only: the data can only be read and the pages of the file
+     *   are shared with the other processes mapping it.
+     * - copy_on_write: the data can be modified, the modified pages are
+     *   private copies and the file is left unchanged.
+     */
+    enum class mmap_mode
+    {
+        read_only,
+        copy_on_write
+    };
+
+    /**
+     * @class xmmap_allocator
+     * @brief Allocator of the buffer of a memory mapped npy array.
+     *
+     * The buffer adaptor of an array returned by load_npy_mmap owns its data
+     * through this allocator, which keeps the file mapped as long as the
+     * array, or a copy of the allocator, is alive. Memory allocated after a
+     * resize of the array comes from std::allocator.
+     *
+     * @tparam T the value type of the array
+     * @tparam M the access mode of the mapping
+     */
+    template <class T, mmap_mode M>
+    class xmmap_allocator
+    {
+    public:
+
+        using value_type = T;
+        using pointer = std::conditional_t<M == mmap_mode::read_only, const T*, T*>;
+        using const_pointer = const T*;
+        using reference = std::conditional_t<M == mmap_mode::read_only, const T&, T&>;
+        using const_reference = const T&;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = xmmap_allocator<U, M>;
+        };
+
+        xmmap_allocator() = default;
+        explicit xmmap_allocator(std::shared_ptr<detail::xmapped_file> file) noexcept;
+
+        template <class U>
+        xmmap_allocator(const xmmap_allocator<U, M>& rhs) noexcept;
+
+        pointer allocate(size_type n);
+        void deallocate(pointer p, size_type n);
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args);
+        template <class U>
+        void destroy(U* p);
+
+        const std::shared_ptr<detail::xmapped_file>& file() const noexcept;
+
+    private:
+
+        std::shared_ptr<detail::xmapped_file> p_file;
+    };
+
+    template <class T, class U, mmap_mode M>
+    bool operator==(const xmmap_allocator<T, M>& lhs, const xmmap_allocator<U, M>& rhs) noexcept;
+
+    template <class T, class U, mmap_mode M>
+    bool operator!=(const xmmap_allocator<T, M>& lhs, const xmmap_allocator<U, M>& rhs) noexcept;
+
+    template <class T, mmap_mode M>
+    inline xmmap_allocator<T, M>::xmmap_allocator(std::shared_ptr<detail::xmapped_file> file) noexcept
+        : p_file(std::move(file))
+    {
+    }
+
+    template <class T, mmap_mode M>
+    template <class U>
+    inline xmmap_allocator<T, M>::xmmap_allocator(const xmmap_allocator<U, M>& rhs) noexcept
+        : p_file(rhs.file())
+    {
+    }
+
+    template <class T, mmap_mode M>
+    inline auto xmmap_allocator<T, M>::allocate(size_type n) -> pointer
+    {
+        return std::allocator<T>().allocate(n);
+    }
+
+    template <class T, mmap_mode M>
+    inline void xmmap_allocator<T, M>::deallocate(pointer p, size_type n)
+    {
+        const char* c = reinterpret_cast<const char*>(p);
+        bool mapped = p_file != nullptr && c >= p_file->data() && c < p_file->data() + p_file->size();
+        if (!mapped)
+        {
+            std::allocator<T>().deallocate(const_cast<T*>(p), n);
+        }
+    }
+
+    template <class T, mmap_mode M>
+    template <class U, class... Args>
+    inline void xmmap_allocator<T, M>::construct(U* p, Args&&... args)
+    {
+        ::new (const_cast<void*>(static_cast<const void*>(p))) std::remove_const_t<U>(std::forward<Args>(args)...);
+    }
+
+    template <class T, mmap_mode M>
+    template <class U>
+    inline void xmmap_allocator<T, M>::destroy(U* p)
+    {
+        p->~U();
+    }
+
+    template <class T, mmap_mode M>
+    inline auto xmmap_allocator<T, M>::file() const noexcept -> const std::shared_ptr<detail::xmapped_file>&
+    {
+        return p_file;
+    }
+
+    template <class T, class U, mmap_mode M>
+    inline bool operator==(const xmmap_allocator<T, M>& lhs, const xmmap_allocator<U, M>& rhs) noexcept
+    {
+        return lhs.file() == rhs.file();
+    }
+
+    template <class T, class U, mmap_mode M>
+    inline bool operator!=(const xmmap_allocator<T, M>& lhs, const xmmap_allocator<U, M>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    namespace detail
+    {
+        // Maps the npy array starting at the given offset of a file.
+        template <class T, mmap_mode M, layout_type L>
+        inline auto map_npy(const std::string& filename, std::size_t npy_offset)
+        {
+            using allocator_type = xmmap_allocator<T, M>;
+            using pointer = typename allocator_type::pointer;
+
+            npy_header header;
+            std::size_t offset;
+            {
+                std::ifstream stream(filename, std::ifstream::binary);
+                if (!stream)
+                {
+                    throw std::runtime_error("io error: failed to open a file.");
+                }
+                stream.seekg(static_cast<std::streamoff>(npy_offset));
+                header = read_npy_header(stream);
+                offset = static_cast<std::size_t>(stream.tellg());
+            }
+            std::vector<std::size_t> strides = check_npy_cast<T, L>(header.m_shape, header.m_fortran_order,
+                                                                    header.m_typestring, true);
+
+            auto file = std::make_shared<xmapped_file>(filename, M == mmap_mode::copy_on_write);
+            if (file->size() < offset + header.n_bytes())
+            {
+                throw std::runtime_error("io error: npy file is truncated.");
+            }
+            if (offset % alignof(T) != 0)
+            {
+                throw std::runtime_error("io error: npy data is not aligned for memory mapping.");
+            }
+
+            pointer ptr = reinterpret_cast<pointer>(file->data() + offset);
+            return adapt(std::move(ptr), compute_size(header.m_shape), acquire_ownership(),
+                         std::move(header.m_shape), std::move(strides), allocator_type(std::move(file)));
+        }
+    }
+
+    /**
+     * Maps a npy file in memory and returns an array pointing to the data
+     * of the mapping, without reading nor copying it. The file stays mapped
+     * as long as the returned array (or a copy of its allocator) is alive,
+     * the pages of the file are loaded on first access and are shared with
+     * the page cache.
+     *
+     * @param filename The filename or path to the file
+     * @tparam T select the type of the npy file (note: there is no dynamic
+     *           casting, the type must match the one of the file)
+     * @tparam M mmap_mode::read_only returns an array of constant values,
+     *           mmap_mode::copy_on_write an array whose modifications are
+     *           private to the process and never written to the file
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray_adaptor on the mapped data
+     */
+    template <typename T, mmap_mode M = mmap_mode::read_only, layout_type L = layout_type::dynamic>
+    inline auto load_npy_mmap(const std::string& filename)
+    {
+        return detail::map_npy<T, M, L>(filename, 0);
+    }
+
+}  // namespace xt
+
+#endif
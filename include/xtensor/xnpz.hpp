@@ -0,0 +1,954 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_NPZ_HPP
+#define XTENSOR_NPZ_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(XTENSOR_USE_ZLIB)
+#include <zlib.h>
+#endif
+
+#include "xtensor/xnpy.hpp"
+#include "xtensor/xnpy_mmap.hpp"
+#include "xtensor/xparallel.hpp"
+
+namespace xt
+{
+    /**
+     * Compression of the members of a npz archive.
+     * - stored: members are not compressed, their data can be memory mapped.
+     * - deflated: members are compressed with the deflate algorithm, this
+     *   requires zlib (define XTENSOR_USE_ZLIB).
+     */
+    enum class npz_compression
+    {
+        stored,
+        deflated
+    };
+
+    namespace detail
+    {
+        constexpr std::uint32_t zip_local_signature = 0x04034b50;
+        constexpr std::uint32_t zip_central_signature = 0x02014b50;
+        constexpr std::uint32_t zip_end_signature = 0x06054b50;
+        constexpr std::uint32_t zip64_end_signature = 0x06064b50;
+        constexpr std::uint32_t zip64_locator_signature = 0x07064b50;
+
+        constexpr std::size_t zip_local_header_size = 30;
+        constexpr std::size_t zip_central_header_size = 46;
+        constexpr std::size_t zip_end_size = 22;
+        constexpr std::size_t zip64_end_size = 56;
+        constexpr std::size_t zip64_locator_size = 20;
+
+        constexpr std::uint16_t zip_version = 20;
+        constexpr std::uint16_t zip64_version = 45;
+        constexpr std::uint16_t zip_stored = 0;
+        constexpr std::uint16_t zip_deflated = 8;
+        constexpr std::uint16_t zip64_extra_id = 0x0001;
+        constexpr std::uint16_t zip_padding_extra_id = 0xd935;
+        // 1980-01-01 00:00, the archives do not depend on the time they are written
+        constexpr std::uint16_t zip_dos_time = 0;
+        constexpr std::uint16_t zip_dos_date = 0x21;
+
+        constexpr std::uint64_t zip32_max = 0xffffffff;
+        constexpr std::uint64_t zip16_max = 0xffff;
+
+        // Stored members are aligned so that their data can be mapped
+        constexpr std::size_t npz_alignment = 64;
+
+        /*******
+         * crc *
+         *******/
+
+        inline const std::array<std::uint32_t, 256>& crc32_table()
+        {
+            static const std::array<std::uint32_t, 256> table = []()
+            {
+                std::array<std::uint32_t, 256> res;
+                for (std::uint32_t i = 0; i < 256; ++i)
+                {
+                    std::uint32_t c = i;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+                    }
+                    res[i] = c;
+                }
+                return res;
+            }();
+            return table;
+        }
+
+        inline std::uint32_t zip_crc32(const char* data, std::size_t size)
+        {
+#if defined(XTENSOR_USE_ZLIB)
+            uLong crc = ::crc32(0L, Z_NULL, 0);
+            while (size != 0)
+            {
+                uInt n = static_cast<uInt>(std::min(size, std::size_t(std::numeric_limits<uInt>::max())));
+                crc = ::crc32(crc, reinterpret_cast<const Bytef*>(data), n);
+                data += n;
+                size -= n;
+            }
+            return static_cast<std::uint32_t>(crc);
+#else
+            const auto& table = crc32_table();
+            std::uint32_t crc = 0xffffffff;
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
+            }
+            return crc ^ 0xffffffff;
+#endif
+        }
+
+        /***********
+         * deflate *
+         ***********/
+
+#if defined(XTENSOR_USE_ZLIB)
+
+        inline std::string zip_deflate(const std::string& data)
+        {
+            z_stream zs;
+            std::memset(&zs, 0, sizeof(zs));
+            if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                throw std::runtime_error("npz: failed to initialize compression.");
+            }
+
+            std::string res(deflateBound(&zs, 0) + data.size() / 1000 + 64, '\0');
+            std::size_t in_pos = 0;
+            std::size_t out_pos = 0;
+            int ret = Z_OK;
+            while (ret != Z_STREAM_END)
+            {
+                if (out_pos == res.size())
+                {
+                    res.resize(2 * res.size());
+                }
+                std::size_t in_size = std::min(data.size() - in_pos, std::size_t(std::numeric_limits<uInt>::max()));
+                std::size_t out_size = std::min(res.size() - out_pos, std::size_t(std::numeric_limits<uInt>::max()));
+                zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data() + in_pos));
+                zs.avail_in = static_cast<uInt>(in_size);
+                zs.next_out = reinterpret_cast<Bytef*>(&res[out_pos]);
+                zs.avail_out = static_cast<uInt>(out_size);
+                bool last = in_pos + in_size == data.size();
+                ret = deflate(&zs, last ? Z_FINISH : Z_NO_FLUSH);
+                if (ret == Z_STREAM_ERROR)
+                {
+                    deflateEnd(&zs);
+                    throw std::runtime_error("npz: compression failed.");
+                }
+                in_pos += in_size - zs.avail_in;
+                out_pos += out_size - zs.avail_out;
+            }
+            deflateEnd(&zs);
+            res.resize(out_pos);
+            return res;
+        }
+
+        inline std::string zip_inflate(const std::string& data, std::size_t size)
+        {
+            z_stream zs;
+            std::memset(&zs, 0, sizeof(zs));
+            if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+            {
+                throw std::runtime_error("npz: failed to initialize decompression.");
+            }
+
+            std::string res(size, '\0');
+            std::size_t in_pos = 0;
+            std::size_t out_pos = 0;
+            int ret = Z_OK;
+            while (ret != Z_STREAM_END)
+            {
+                std::size_t in_size = std::min(data.size() - in_pos, std::size_t(std::numeric_limits<uInt>::max()));
+                std::size_t out_size = std::min(res.size() - out_pos, std::size_t(std::numeric_limits<uInt>::max()));
+                zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data() + in_pos));
+                zs.avail_in = static_cast<uInt>(in_size);
+                zs.next_out = reinterpret_cast<Bytef*>(&res[0] + out_pos);
+                zs.avail_out = static_cast<uInt>(out_size);
+                ret = inflate(&zs, Z_NO_FLUSH);
+                in_pos += in_size - zs.avail_in;
+                out_pos += out_size - zs.avail_out;
+                bool stalled = (in_size == zs.avail_in && out_size == zs.avail_out);
+                if ((ret != Z_OK && ret != Z_STREAM_END) || (ret == Z_OK && stalled))
+                {
+                    inflateEnd(&zs);
+                    throw std::runtime_error("npz: corrupted compressed member.");
+                }
+            }
+            inflateEnd(&zs);
+            if (out_pos != size)
+            {
+                throw std::runtime_error("npz: corrupted compressed member.");
+            }
+            return res;
+        }
+
+#else
+
+        inline std::string zip_deflate(const std::string&)
+        {
+            throw std::runtime_error("npz: deflated members require zlib, define XTENSOR_USE_ZLIB.");
+        }
+
+        inline std::string zip_inflate(const std::string&, std::size_t)
+        {
+            throw std::runtime_error("npz: deflated members require zlib, define XTENSOR_USE_ZLIB.");
+        }
+
+#endif
+
+        /************************
+         * little endian fields *
+         ************************/
+
+        template <class T>
+        inline void put_le(std::string& out, std::uint64_t value)
+        {
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+            {
+                out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+            }
+        }
+
+        template <class T>
+        inline T get_le(const char* in)
+        {
+            std::uint64_t res = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+            {
+                res |= std::uint64_t(static_cast<unsigned char>(in[i])) << (8 * i);
+            }
+            return static_cast<T>(res);
+        }
+
+        inline void read_zip_bytes(std::istream& stream, std::uint64_t offset, char* buffer, std::size_t size)
+        {
+            stream.clear();
+            stream.seekg(static_cast<std::streamoff>(offset));
+            stream.read(buffer, static_cast<std::streamsize>(size));
+            if (stream.gcount() != static_cast<std::streamsize>(size))
+            {
+                throw std::runtime_error("npz: truncated archive.");
+            }
+        }
+
+        /***************
+         * zip members *
+         ***************/
+
+        struct zip_member
+        {
+            std::string m_name;
+            std::uint16_t m_method;
+            std::uint32_t m_crc;
+            std::uint64_t m_compressed_size;
+            std::uint64_t m_size;
+            std::uint64_t m_offset;
+        };
+
+        // Istream on a memory buffer, to parse inflated members.
+        class xmemory_streambuf : public std::streambuf
+        {
+        public:
+
+            xmemory_streambuf(char* data, std::size_t size)
+            {
+                setg(data, data, data + size);
+            }
+        };
+    }
+
+    /***************
+     * npz_archive *
+     ***************/
+
+    /**
+     * @class npz_archive
+     * @brief Lazy reader of npz archives.
+     *
+     * A npz archive is a zip file of npy members, as written by numpy.savez
+     * and numpy.savez_compressed. Only the directory of the archive is read
+     * when it is opened, each member is read when it is loaded.
+     */
+    class npz_archive
+    {
+    public:
+
+        explicit npz_archive(const std::string& filename);
+
+        std::vector<std::string> names() const;
+        bool contains(const std::string& name) const;
+        npz_compression compression(const std::string& name) const;
+
+        template <class T, layout_type L = layout_type::dynamic>
+        auto load(const std::string& name) const;
+
+        template <class T, mmap_mode M = mmap_mode::read_only, layout_type L = layout_type::dynamic>
+        auto load_mmap(const std::string& name) const;
+
+    private:
+
+        const detail::zip_member& member(const std::string& name) const;
+        std::uint64_t data_offset(std::istream& stream, const detail::zip_member& m) const;
+        detail::npy_file load_file(const detail::zip_member& m) const;
+
+        void read_directory();
+
+        std::string m_filename;
+        std::map<std::string, detail::zip_member> m_members;
+    };
+
+    /**************
+     * npz_writer *
+     **************/
+
+    /**
+     * @class npz_writer
+     * @brief Writer of npz archives.
+     *
+     * Arrays are added to the archive as npy members, that are written in
+     * a single sequential file. Deflated members are compressed by batches,
+     * each member of a batch on its own thread when a parallel backend is
+     * enabled. The directory of the archive is written when the writer is
+     * closed or destroyed.
+     */
+    class npz_writer
+    {
+    public:
+
+        explicit npz_writer(const std::string& filename, npz_compression compression = npz_compression::stored);
+        ~npz_writer();
+
+        npz_writer(const npz_writer&) = delete;
+        npz_writer& operator=(const npz_writer&) = delete;
+
+        template <class E>
+        void add(const std::string& name, const xexpression<E>& e);
+
+        void close();
+
+    private:
+
+        struct pending_member
+        {
+            std::string m_name;
+            std::string m_data;
+            std::uint32_t m_crc;
+            std::uint64_t m_size;
+        };
+
+        void flush();
+        void write_member(pending_member& m, std::uint16_t method);
+        void write_directory();
+
+        std::ofstream m_stream;
+        npz_compression m_compression;
+        std::uint64_t m_offset;
+        std::vector<detail::zip_member> m_members;
+        std::vector<pending_member> m_pending;
+    };
+
+    /******************************
+     * npz_archive implementation *
+     ******************************/
+
+    /**
+     * Opens a npz archive and reads its directory.
+     * @param filename the filename or path to the archive
+     */
+    inline npz_archive::npz_archive(const std::string& filename)
+        : m_filename(filename)
+    {
+        read_directory();
+    }
+
+    /**
+     * Returns the names of the arrays stored in the archive.
+     */
+    inline std::vector<std::string> npz_archive::names() const
+    {
+        std::vector<std::string> res;
+        res.reserve(m_members.size());
+        for (const auto& m : m_members)
+        {
+            res.push_back(m.first);
+        }
+        return res;
+    }
+
+    /**
+     * Checks if the archive holds an array with the given name.
+     */
+    inline bool npz_archive::contains(const std::string& name) const
+    {
+        return m_members.find(name) != m_members.end();
+    }
+
+    /**
+     * Returns the compression of the given member.
+     */
+    inline npz_compression npz_archive::compression(const std::string& name) const
+    {
+        return member(name).m_method == detail::zip_stored ? npz_compression::stored : npz_compression::deflated;
+    }
+
+    /**
+     * Reads an array of the archive.
+     * @param name the name of the array
+     * @tparam T select the type of the array (note: currently there is
+     *           no dynamic casting if types do not match)
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray with contents of the member
+     */
+    template <class T, layout_type L>
+    inline auto npz_archive::load(const std::string& name) const
+    {
+        return load_file(member(name)).cast<T, L>();
+    }
+
+    /**
+     * Maps a stored (uncompressed) array of the archive in memory, see
+     * load_npy_mmap.
+     * @param name the name of the array
+     * @tparam T select the type of the array
+     * @tparam M the access mode of the mapping
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray_adaptor on the mapped data
+     */
+    template <class T, mmap_mode M, layout_type L>
+    inline auto npz_archive::load_mmap(const std::string& name) const
+    {
+        const detail::zip_member& m = member(name);
+        if (m.m_method != detail::zip_stored)
+        {
+            throw std::runtime_error("npz: only stored members can be memory mapped.");
+        }
+        std::ifstream stream(m_filename, std::ifstream::binary);
+        std::uint64_t offset = data_offset(stream, m);
+        return detail::map_npy<T, M, L>(m_filename, static_cast<std::size_t>(offset));
+    }
+
+    inline const detail::zip_member& npz_archive::member(const std::string& name) const
+    {
+        auto it = m_members.find(name);
+        if (it == m_members.end())
+        {
+            throw std::runtime_error("npz: no array named "s + name + " in archive.");
+        }
+        return it->second;
+    }
+
+    inline std::uint64_t npz_archive::data_offset(std::istream& stream, const detail::zip_member& m) const
+    {
+        char header[detail::zip_local_header_size];
+        detail::read_zip_bytes(stream, m.m_offset, header, detail::zip_local_header_size);
+        if (detail::get_le<std::uint32_t>(header) != detail::zip_local_signature)
+        {
+            throw std::runtime_error("npz: corrupted archive.");
+        }
+        std::uint64_t name_size = detail::get_le<std::uint16_t>(header + 26);
+        std::uint64_t extra_size = detail::get_le<std::uint16_t>(header + 28);
+        return m.m_offset + detail::zip_local_header_size + name_size + extra_size;
+    }
+
+    inline detail::npy_file npz_archive::load_file(const detail::zip_member& m) const
+    {
+        std::ifstream stream(m_filename, std::ifstream::binary);
+        if (!stream)
+        {
+            throw std::runtime_error("io error: failed to open file: "s + m_filename);
+        }
+        std::uint64_t offset = data_offset(stream, m);
+
+        if (m.m_method == detail::zip_stored)
+        {
+            stream.clear();
+            stream.seekg(static_cast<std::streamoff>(offset));
+            return detail::load_npy_file(stream);
+        }
+        else if (m.m_method == detail::zip_deflated)
+        {
+            std::string compressed(static_cast<std::size_t>(m.m_compressed_size), '\0');
+            detail::read_zip_bytes(stream, offset, &compressed[0], compressed.size());
+            std::string data = detail::zip_inflate(compressed, static_cast<std::size_t>(m.m_size));
+            compressed = std::string();
+            if (detail::zip_crc32(data.data(), data.size()) != m.m_crc)
+            {
+                throw std::runtime_error("npz: CRC mismatch in member "s + m.m_name);
+            }
+            detail::xmemory_streambuf buf(&data[0], data.size());
+            std::istream data_stream(&buf);
+            return detail::load_npy_file(data_stream);
+        }
+        throw std::runtime_error("npz: unsupported compression method in member "s + m.m_name);
+    }
+
+    inline void npz_archive::read_directory()
+    {
+        std::ifstream stream(m_filename, std::ifstream::binary);
+        if (!stream)
+        {
+            throw std::runtime_error("io error: failed to open file: "s + m_filename);
+        }
+        stream.seekg(0, std::ios::end);
+        std::uint64_t file_size = static_cast<std::uint64_t>(stream.tellg());
+
+        // The end of central directory record is followed by a comment of at most 64 KiB
+        std::size_t tail_size = static_cast<std::size_t>(std::min(file_size, std::uint64_t(detail::zip_end_size + 0xffff)));
+        if (tail_size < detail::zip_end_size)
+        {
+            throw std::runtime_error("npz: "s + m_filename + " is not a zip archive.");
+        }
+        std::string tail(tail_size, '\0');
+        detail::read_zip_bytes(stream, file_size - tail_size, &tail[0], tail_size);
+        std::size_t end_pos = tail_size - detail::zip_end_size + 1;
+        do
+        {
+            --end_pos;
+        } while (end_pos != 0 && detail::get_le<std::uint32_t>(&tail[end_pos]) != detail::zip_end_signature);
+        if (detail::get_le<std::uint32_t>(&tail[end_pos]) != detail::zip_end_signature)
+        {
+            throw std::runtime_error("npz: "s + m_filename + " is not a zip archive.");
+        }
+
+        const char* end = &tail[end_pos];
+        std::uint64_t n_entries = detail::get_le<std::uint16_t>(end + 10);
+        std::uint64_t dir_size = detail::get_le<std::uint32_t>(end + 12);
+        std::uint64_t dir_offset = detail::get_le<std::uint32_t>(end + 16);
+        std::uint64_t end_offset = file_size - tail_size + end_pos;
+        if ((n_entries == detail::zip16_max || dir_size == detail::zip32_max || dir_offset == detail::zip32_max) &&
+            end_offset >= detail::zip64_locator_size)
+        {
+            char locator[detail::zip64_locator_size];
+            detail::read_zip_bytes(stream, end_offset - detail::zip64_locator_size, locator, detail::zip64_locator_size);
+            if (detail::get_le<std::uint32_t>(locator) == detail::zip64_locator_signature)
+            {
+                char end64[detail::zip64_end_size];
+                detail::read_zip_bytes(stream, detail::get_le<std::uint64_t>(locator + 8), end64, detail::zip64_end_size);
+                if (detail::get_le<std::uint32_t>(end64) != detail::zip64_end_signature)
+                {
+                    throw std::runtime_error("npz: corrupted archive.");
+                }
+                n_entries = detail::get_le<std::uint64_t>(end64 + 32);
+                dir_size = detail::get_le<std::uint64_t>(end64 + 40);
+                dir_offset = detail::get_le<std::uint64_t>(end64 + 48);
+            }
+        }
+
+        std::string dir(static_cast<std::size_t>(dir_size), '\0');
+        detail::read_zip_bytes(stream, dir_offset, &dir[0], dir.size());
+        std::size_t pos = 0;
+        for (std::uint64_t i = 0; i < n_entries; ++i)
+        {
+            if (pos + detail::zip_central_header_size > dir.size() ||
+                detail::get_le<std::uint32_t>(&dir[pos]) != detail::zip_central_signature)
+            {
+                throw std::runtime_error("npz: corrupted archive.");
+            }
+            const char* h = &dir[pos];
+            detail::zip_member m;
+            m.m_method = detail::get_le<std::uint16_t>(h + 10);
+            m.m_crc = detail::get_le<std::uint32_t>(h + 16);
+            m.m_compressed_size = detail::get_le<std::uint32_t>(h + 20);
+            m.m_size = detail::get_le<std::uint32_t>(h + 24);
+            std::size_t name_size = detail::get_le<std::uint16_t>(h + 28);
+            std::size_t extra_size = detail::get_le<std::uint16_t>(h + 30);
+            std::size_t comment_size = detail::get_le<std::uint16_t>(h + 32);
+            m.m_offset = detail::get_le<std::uint32_t>(h + 42);
+            if (pos + detail::zip_central_header_size + name_size + extra_size + comment_size > dir.size())
+            {
+                throw std::runtime_error("npz: corrupted archive.");
+            }
+            m.m_name.assign(h + detail::zip_central_header_size, name_size);
+
+            // The zip64 extra field holds the values that overflow the header
+            const char* extra = h + detail::zip_central_header_size + name_size;
+            const char* extra_end = extra + extra_size;
+            while (extra + 4 <= extra_end)
+            {
+                std::uint16_t id = detail::get_le<std::uint16_t>(extra);
+                std::uint16_t size = detail::get_le<std::uint16_t>(extra + 2);
+                const char* field = extra + 4;
+                const char* field_end = std::min(field + size, extra_end);
+                if (id == detail::zip64_extra_id)
+                {
+                    for (std::uint64_t* value : {&m.m_size, &m.m_compressed_size, &m.m_offset})
+                    {
+                        if (*value == detail::zip32_max && field + 8 <= field_end)
+                        {
+                            *value = detail::get_le<std::uint64_t>(field);
+                            field += 8;
+                        }
+                    }
+                }
+                extra += 4 + size;
+            }
+            pos += detail::zip_central_header_size + name_size + extra_size + comment_size;
+
+            std::string key = m.m_name;
+            if (key.size() > 4 && key.compare(key.size() - 4, 4, ".npy") == 0)
+            {
+                key.erase(key.size() - 4);
+            }
+            m_members[key] = std::move(m);
+        }
+    }
+
+    /*****************************
+     * npz_writer implementation *
+     *****************************/
+
+    /**
+     * Creates a npz archive.
+     * @param filename the filename or path to the archive
+     * @param compression the compression of the members of the archive
+     */
+    inline npz_writer::npz_writer(const std::string& filename, npz_compression compression)
+        : m_stream(filename, std::ofstream::binary), m_compression(compression), m_offset(0)
+    {
+        if (!m_stream)
+        {
+            throw std::runtime_error("IO Error: failed to open file: "s + filename);
+        }
+#if !defined(XTENSOR_USE_ZLIB)
+        if (compression == npz_compression::deflated)
+        {
+            throw std::runtime_error("npz: deflated members require zlib, define XTENSOR_USE_ZLIB.");
+        }
+#endif
+    }
+
+    /**
+     * Closes the writer, see close.
+     */
+    inline npz_writer::~npz_writer()
+    {
+        try
+        {
+            close();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    /**
+     * Adds an array to the archive. The array is evaluated and serialized
+     * immediately, it can be modified or destroyed after this call.
+     * @param name the name of the array, the member is named name.npy
+     * @param e the xexpression to add
+     */
+    template <class E>
+    inline void npz_writer::add(const std::string& name, const xexpression<E>& e)
+    {
+        if (!m_stream.is_open())
+        {
+            throw std::runtime_error("npz: cannot add an array to a closed archive.");
+        }
+        std::ostringstream out;
+        detail::dump_npy_stream(out, e);
+        pending_member m;
+        m.m_name = name + ".npy";
+        m.m_data = out.str();
+        m.m_size = m.m_data.size();
+        if (m_compression == npz_compression::stored)
+        {
+            m.m_crc = detail::zip_crc32(m.m_data.data(), m.m_data.size());
+            write_member(m, detail::zip_stored);
+        }
+        else
+        {
+            m_pending.push_back(std::move(m));
+            if (m_pending.size() >= num_threads())
+            {
+                flush();
+            }
+        }
+    }
+
+    /**
+     * Writes the pending members and the directory of the archive, and
+     * closes the file. Calling close on a closed writer has no effect.
+     */
+    inline void npz_writer::close()
+    {
+        if (m_stream.is_open())
+        {
+            flush();
+            write_directory();
+            m_stream.close();
+            if (m_stream.fail())
+            {
+                throw std::runtime_error("io error: failed writing npz archive.");
+            }
+        }
+    }
+
+    inline void npz_writer::flush()
+    {
+        std::vector<std::exception_ptr> errors(m_pending.size());
+        parallel_for(0, m_pending.size(), 1, [this, &errors](std::size_t first, std::size_t last)
+        {
+            for (std::size_t i = first; i < last; ++i)
+            {
+                try
+                {
+                    pending_member& m = m_pending[i];
+                    m.m_crc = detail::zip_crc32(m.m_data.data(), m.m_data.size());
+                    m.m_data = detail::zip_deflate(m.m_data);
+                }
+                catch (...)
+                {
+                    errors[i] = std::current_exception();
+                }
+            }
+        });
+        for (const auto& error : errors)
+        {
+            if (error)
+            {
+                m_pending.clear();
+                std::rethrow_exception(error);
+            }
+        }
+        for (auto& m : m_pending)
+        {
+            write_member(m, detail::zip_deflated);
+        }
+        m_pending.clear();
+    }
+
+    inline void npz_writer::write_member(pending_member& m, std::uint16_t method)
+    {
+        detail::zip_member entry;
+        entry.m_name = std::move(m.m_name);
+        entry.m_method = method;
+        entry.m_crc = m.m_crc;
+        entry.m_compressed_size = m.m_data.size();
+        entry.m_size = m.m_size;
+        entry.m_offset = m_offset;
+
+        bool zip64 = entry.m_size >= detail::zip32_max || entry.m_compressed_size >= detail::zip32_max;
+        std::string extra;
+        if (zip64)
+        {
+            detail::put_le<std::uint16_t>(extra, detail::zip64_extra_id);
+            detail::put_le<std::uint16_t>(extra, 16);
+            detail::put_le<std::uint64_t>(extra, entry.m_size);
+            detail::put_le<std::uint64_t>(extra, entry.m_compressed_size);
+        }
+        if (method == detail::zip_stored)
+        {
+            std::size_t data_offset = static_cast<std::size_t>(m_offset) + detail::zip_local_header_size +
+                                      entry.m_name.size() + extra.size();
+            std::size_t padding = (detail::npz_alignment - data_offset % detail::npz_alignment) % detail::npz_alignment;
+            if (padding != 0 && padding < 4)
+            {
+                padding += detail::npz_alignment;
+            }
+            if (padding != 0)
+            {
+                detail::put_le<std::uint16_t>(extra, detail::zip_padding_extra_id);
+                detail::put_le<std::uint16_t>(extra, static_cast<std::uint16_t>(padding - 4));
+                extra.append(padding - 4, '\0');
+            }
+        }
+
+        std::string header;
+        detail::put_le<std::uint32_t>(header, detail::zip_local_signature);
+        detail::put_le<std::uint16_t>(header, zip64 ? detail::zip64_version : detail::zip_version);
+        detail::put_le<std::uint16_t>(header, 0);
+        detail::put_le<std::uint16_t>(header, method);
+        detail::put_le<std::uint16_t>(header, detail::zip_dos_time);
+        detail::put_le<std::uint16_t>(header, detail::zip_dos_date);
+        detail::put_le<std::uint32_t>(header, entry.m_crc);
+        detail::put_le<std::uint32_t>(header, zip64 ? detail::zip32_max : entry.m_compressed_size);
+        detail::put_le<std::uint32_t>(header, zip64 ? detail::zip32_max : entry.m_size);
+        detail::put_le<std::uint16_t>(header, entry.m_name.size());
+        detail::put_le<std::uint16_t>(header, extra.size());
+        header += entry.m_name;
+        header += extra;
+
+        m_stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+        m_stream.write(m.m_data.data(), static_cast<std::streamsize>(m.m_data.size()));
+        m_offset += header.size() + m.m_data.size();
+        m.m_data = std::string();
+        m_members.push_back(std::move(entry));
+    }
+
+    inline void npz_writer::write_directory()
+    {
+        std::string dir;
+        for (const auto& m : m_members)
+        {
+            bool size64 = m.m_size >= detail::zip32_max || m.m_compressed_size >= detail::zip32_max;
+            bool offset64 = m.m_offset >= detail::zip32_max;
+            std::string extra;
+            if (size64 || offset64)
+            {
+                detail::put_le<std::uint16_t>(extra, detail::zip64_extra_id);
+                detail::put_le<std::uint16_t>(extra, (size64 ? 16u : 0u) + (offset64 ? 8u : 0u));
+                if (size64)
+                {
+                    detail::put_le<std::uint64_t>(extra, m.m_size);
+                    detail::put_le<std::uint64_t>(extra, m.m_compressed_size);
+                }
+                if (offset64)
+                {
+                    detail::put_le<std::uint64_t>(extra, m.m_offset);
+                }
+            }
+            std::uint16_t version = (size64 || offset64) ? detail::zip64_version : detail::zip_version;
+            detail::put_le<std::uint32_t>(dir, detail::zip_central_signature);
+            detail::put_le<std::uint16_t>(dir, version);
+            detail::put_le<std::uint16_t>(dir, version);
+            detail::put_le<std::uint16_t>(dir, 0);
+            detail::put_le<std::uint16_t>(dir, m.m_method);
+            detail::put_le<std::uint16_t>(dir, detail::zip_dos_time);
+            detail::put_le<std::uint16_t>(dir, detail::zip_dos_date);
+            detail::put_le<std::uint32_t>(dir, m.m_crc);
+            detail::put_le<std::uint32_t>(dir, size64 ? detail::zip32_max : m.m_compressed_size);
+            detail::put_le<std::uint32_t>(dir, size64 ? detail::zip32_max : m.m_size);
+            detail::put_le<std::uint16_t>(dir, m.m_name.size());
+            detail::put_le<std::uint16_t>(dir, extra.size());
+            detail::put_le<std::uint16_t>(dir, 0);
+            detail::put_le<std::uint16_t>(dir, 0);
+            detail::put_le<std::uint16_t>(dir, 0);
+            detail::put_le<std::uint32_t>(dir, 0);
+            detail::put_le<std::uint32_t>(dir, offset64 ? detail::zip32_max : m.m_offset);
+            dir += m.m_name;
+            dir += extra;
+        }
+
+        std::uint64_t dir_offset = m_offset;
+        std::uint64_t n_entries = m_members.size();
+        bool zip64 = n_entries >= detail::zip16_max || dir.size() >= detail::zip32_max || dir_offset >= detail::zip32_max;
+        if (zip64)
+        {
+            std::uint64_t end64_offset = dir_offset + dir.size();
+            detail::put_le<std::uint32_t>(dir, detail::zip64_end_signature);
+            detail::put_le<std::uint64_t>(dir, detail::zip64_end_size - 12);
+            detail::put_le<std::uint16_t>(dir, detail::zip64_version);
+            detail::put_le<std::uint16_t>(dir, detail::zip64_version);
+            detail::put_le<std::uint32_t>(dir, 0);
+            detail::put_le<std::uint32_t>(dir, 0);
+            detail::put_le<std::uint64_t>(dir, n_entries);
+            detail::put_le<std::uint64_t>(dir, n_entries);
+            detail::put_le<std::uint64_t>(dir, end64_offset - dir_offset);
+            detail::put_le<std::uint64_t>(dir, dir_offset);
+
+            detail::put_le<std::uint32_t>(dir, detail::zip64_locator_signature);
+            detail::put_le<std::uint32_t>(dir, 0);
+            detail::put_le<std::uint64_t>(dir, end64_offset);
+            detail::put_le<std::uint32_t>(dir, 1);
+        }
+        std::uint64_t dir_size = zip64 ? dir.size() - detail::zip64_end_size - detail::zip64_locator_size : dir.size();
+
+        detail::put_le<std::uint32_t>(dir, detail::zip_end_signature);
+        detail::put_le<std::uint16_t>(dir, 0);
+        detail::put_le<std::uint16_t>(dir, 0);
+        detail::put_le<std::uint16_t>(dir, std::min(n_entries, detail::zip16_max));
+        detail::put_le<std::uint16_t>(dir, std::min(n_entries, detail::zip16_max));
+        detail::put_le<std::uint32_t>(dir, std::min(dir_size, detail::zip32_max));
+        detail::put_le<std::uint32_t>(dir, std::min(dir_offset, detail::zip32_max));
+        detail::put_le<std::uint16_t>(dir, 0);
+
+        m_stream.write(dir.data(), static_cast<std::streamsize>(dir.size()));
+        m_offset += dir.size();
+    }
+
+    /*************************
+     * load_npz and dump_npz *
+     *************************/
+
+    /**
+     * Opens a npz archive (the numpy storage format of several arrays), the
+     * arrays are read when they are loaded from the returned archive.
+     *
+     * @param filename The filename or path to the archive
+     * @return npz_archive on the file
+     */
+    inline npz_archive load_npz(const std::string& filename)
+    {
+        return npz_archive(filename);
+    }
+
+    /**
+     * Loads an array of a npz archive.
+     *
+     * @param filename The filename or path to the archive
+     * @param name The name of the array in the archive
+     * @tparam T select the type of the array (note: currently there is
+     *           no dynamic casting if types do not match)
+     * @tparam L select layout_type::column_major if you stored data in
+     *           Fortran format
+     * @return xarray with contents of the member
+     */
+    template <class T, layout_type L = layout_type::dynamic>
+    inline auto load_npz(const std::string& filename, const std::string& name)
+    {
+        return npz_archive(filename).load<T, L>(name);
+    }
+
+    namespace detail
+    {
+        inline void add_npz(npz_writer&)
+        {
+        }
+
+        template <class E, class... Args>
+        inline void add_npz(npz_writer& writer, const std::string& name, const xexpression<E>& e, const Args&... args)
+        {
+            writer.add(name, e);
+            add_npz(writer, args...);
+        }
+    }
+
+    /**
+     * Saves arrays to a npz archive, given as a list of names and
+     * expressions.
+     *
+     * @code{.cpp}
+     * xt::dump_npz("checkpoint.npz", xt::npz_compression::deflated, "weights", w, "bias", b);
+     * @endcode
+     *
+     * @param filename The filename or path to the archive
+     * @param compression the compression of the members of the archive
+     * @param args the names and the xexpressions to save
+     */
+    template <class... Args>
+    inline void dump_npz(const std::string& filename, npz_compression compression, const Args&... args)
+    {
+        npz_writer writer(filename, compression);
+        detail::add_npz(writer, args...);
+        writer.close();
+    }
+}
+
+#endif
@@ -10,14 +10,20 @@
 #define XTENSOR_OPERATION_HPP
 
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <functional>
+#include <numeric>
 #include <type_traits>
+#include <vector>
 
 #include <xtl/xsequence.hpp>
 
 #include "xconcepts.hpp"
 #include "xfunction.hpp"
+#include "xparallel.hpp"
 #include "xscalar.hpp"
+#include "xstorage.hpp"
 #include "xstrides.hpp"
 #include "xstrided_view.hpp"
 #include "xmanipulation.hpp"
@@ -796,6 +802,210 @@ namespace xt
             // return empty index, happens at last iteration step, but remains unused
             return I();
         }
+
+        // Number of elements of the mask evaluated at once by the compaction
+        constexpr std::size_t compact_block_size = 256;
+
+        // Checks if the elements of e are visited in the traversal order L
+        // by its linear iterator.
+        template <layout_type L, class E>
+        inline bool is_flat_linear(const E& e)
+        {
+            using strides_type = svector<std::ptrdiff_t, 4>;
+            strides_type strides = xtl::make_sequence<strides_type>(e.dimension(), std::ptrdiff_t(0));
+            compute_strides(e.shape(), L, strides);
+            return e.has_linear_assign(strides);
+        }
+
+        // Calls f with an iterator on the elements of e in the traversal
+        // order L, starting at the flat index first.
+        template <layout_type L, class E, class F>
+        inline void visit_flat(const E& e, bool linear, std::size_t first, F&& f)
+        {
+            if (linear)
+            {
+                auto it = linear_begin(e);
+                it += static_cast<std::ptrdiff_t>(first);
+                f(it);
+            }
+            else
+            {
+                auto it = e.template cbegin<L>();
+                it += static_cast<std::ptrdiff_t>(first);
+                f(it);
+            }
+        }
+
+        // Iterator yielding the flat indices of a traversal
+        struct flat_index_iterator
+        {
+            std::size_t index;
+
+            std::size_t operator*() const noexcept
+            {
+                return index;
+            }
+
+            flat_index_iterator& operator++() noexcept
+            {
+                ++index;
+                return *this;
+            }
+        };
+
+        // Source of the flat indices selected by a compaction
+        struct flat_index_source
+        {
+            static constexpr bool parallel_safe = true;
+
+            template <class F>
+            void operator()(std::size_t first, F&& f) const
+            {
+                f(flat_index_iterator{first});
+            }
+        };
+
+        // Source of the values of an expression selected by a compaction
+        template <layout_type L, class E>
+        struct flat_value_source
+        {
+            static constexpr bool parallel_safe = is_parallel_safe<E>::value;
+
+            const E& e;
+            bool linear;
+
+            template <class F>
+            void operator()(std::size_t first, F&& f) const
+            {
+                visit_flat<L>(e, linear, first, std::forward<F>(f));
+            }
+        };
+
+        template <layout_type L, class E>
+        inline flat_value_source<L, E> make_flat_value_source(const E& e)
+        {
+            return flat_value_source<L, E>{e, is_flat_linear<L>(e)};
+        }
+
+        // Counts the true elements of [first, last) in the mask.
+        template <layout_type L, class E>
+        inline std::size_t compact_count(const E& mask, bool linear, std::size_t first, std::size_t last)
+        {
+            std::size_t count = 0;
+            visit_flat<L>(mask, linear, first, [&](auto it)
+            {
+                for (std::size_t i = first; i < last; ++i, ++it)
+                {
+                    count += static_cast<bool>(*it) ? std::size_t(1) : std::size_t(0);
+                }
+            });
+            return count;
+        }
+
+        // Compacts the elements of source at which the mask is true in
+        // [first, last), and calls write(values, n) on every block of
+        // selected values. The mask is first evaluated in a block of flags,
+        // then the values are compacted without branches.
+        template <class T, layout_type L, class E, class S, class W>
+        inline void compact_range(const E& mask, bool linear, const S& source,
+                                  std::size_t first, std::size_t last, W&& write)
+        {
+            std::array<unsigned char, compact_block_size> flags;
+            std::array<T, compact_block_size> values;
+            visit_flat<L>(mask, linear, first, [&](auto mask_it)
+            {
+                source(first, [&](auto value_it)
+                {
+                    for (std::size_t i = first; i < last; i += compact_block_size)
+                    {
+                        std::size_t n = std::min(compact_block_size, last - i);
+                        for (std::size_t j = 0; j < n; ++j, ++mask_it)
+                        {
+                            flags[j] = static_cast<bool>(*mask_it) ? 1 : 0;
+                        }
+                        std::size_t k = 0;
+                        for (std::size_t j = 0; j < n; ++j, ++value_it)
+                        {
+                            values[k] = static_cast<T>(*value_it);
+                            k += flags[j];
+                        }
+                        write(values.data(), k);
+                    }
+                });
+            });
+        }
+
+        template <class T>
+        inline void move_compacted(std::vector<T>& buffer, std::vector<T>& result)
+        {
+            result.swap(buffer);
+        }
+
+        template <class T, class R>
+        inline void move_compacted(const std::vector<T>& buffer, R& result)
+        {
+            result.resize(buffer.size());
+            std::copy(buffer.cbegin(), buffer.cend(), result.begin());
+        }
+
+        // Stream compaction: resizes result to the number of true elements
+        // of the mask and fills it with the corresponding elements of source,
+        // in the traversal order L. With a parallel backend, the flat range is
+        // split in chunks whose true elements are counted in a first pass;
+        // the chunks are then compacted at their final offsets in a second
+        // pass.
+        template <layout_type L, class E, class S, class R>
+        inline void compact(const E& mask, const S& source, R& result)
+        {
+            using value_type = typename R::value_type;
+            std::size_t size = mask.size();
+            bool linear = is_flat_linear<L>(mask);
+            if (!(is_parallel_safe<E>::value && S::parallel_safe && use_parallel(size)))
+            {
+                std::vector<value_type> buffer;
+                compact_range<value_type, L>(mask, linear, source, 0, size, [&buffer](const value_type* values, std::size_t n)
+                {
+                    buffer.insert(buffer.end(), values, values + n);
+                });
+                move_compacted(buffer, result);
+                return;
+            }
+
+            std::size_t chunk = balanced_grain(size);
+            std::size_t n_chunks = (size + chunk - 1) / chunk;
+            std::vector<std::size_t> offsets(n_chunks + 1, std::size_t(0));
+            parallel_for(0, n_chunks, 1, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    offsets[c + 1] = compact_count<L>(mask, linear, c * chunk, std::min(size, (c + 1) * chunk));
+                }
+            });
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+            result.resize(offsets.back());
+            parallel_for(0, n_chunks, 1, [&](std::size_t first, std::size_t last)
+            {
+                for (std::size_t c = first; c < last; ++c)
+                {
+                    value_type* out = result.data() + offsets[c];
+                    compact_range<value_type, L>(mask, linear, source, c * chunk, std::min(size, (c + 1) * chunk),
+                                                 [&out](const value_type* values, std::size_t n)
+                    {
+                        out = std::copy(values, values + n, out);
+                    });
+                }
+            });
+        }
+
+        // Flat indices, in the traversal order L, of the true elements of e
+        template <layout_type L, class E>
+        inline std::vector<std::size_t> flat_nonzero_indices(const E& e)
+        {
+            std::vector<std::size_t> indices;
+            compact<L>(e, flat_index_source{}, indices);
+            return indices;
+        }
     }
 
     /**
@@ -809,25 +1019,22 @@ namespace xt
     template <class T>
     inline auto nonzero(const T& arr)
     {
-        auto shape = arr.shape();
-        using index_type = xindex_type_t<typename T::shape_type>;
         using size_type = typename T::size_type;
+        const auto& shape = arr.shape();
+        std::size_t dim = arr.dimension();
 
-        auto idx = xtl::make_sequence<index_type>(arr.dimension(), 0);
-        std::vector<std::vector<size_type>> indices(arr.dimension());
-
-        size_type total_size = compute_size(shape);
-        for (size_type i = 0; i < total_size; i++, detail::next_idx(shape, idx))
+        std::vector<std::size_t> offsets = detail::flat_nonzero_indices<layout_type::row_major>(arr);
+        std::vector<std::vector<size_type>> indices(dim, std::vector<size_type>(offsets.size()));
+        for (std::size_t k = 0; k < offsets.size(); ++k)
         {
-            if (arr.element(std::begin(idx), std::end(idx)))
+            std::size_t offset = offsets[k];
+            for (std::size_t d = dim; d != 0; --d)
             {
-                for (std::size_t n = 0; n < indices.size(); ++n)
-                {
-                    indices.at(n).push_back(idx[n]);
-                }
+                std::size_t extent = static_cast<std::size_t>(shape[d - 1]);
+                indices[d - 1][k] = static_cast<size_type>(offset % extent);
+                offset /= extent;
             }
         }
-
         return indices;
     }
 
@@ -842,7 +1049,9 @@ namespace xt
     template <layout_type L, class T>
     inline auto flatnonzero(const T& arr)
     {
-        return nonzero(ravel<L>(arr))[0];
+        std::vector<typename T::size_type> indices;
+        detail::compact<L>(arr, detail::flat_index_source{}, indices);
+        return indices;
     }
 
     /**
@@ -871,22 +1080,25 @@ namespace xt
     template <class T>
     inline auto argwhere(const T& arr)
     {
-        auto shape = arr.shape();
         using index_type = xindex_type_t<typename T::shape_type>;
         using size_type = typename T::size_type;
+        const auto& shape = arr.shape();
+        std::size_t dim = arr.dimension();
 
-        auto idx = xtl::make_sequence<index_type>(arr.dimension(), 0);
+        std::vector<std::size_t> offsets = detail::flat_nonzero_indices<layout_type::row_major>(arr);
         std::vector<index_type> indices;
-
-        size_type total_size = compute_size(shape);
-        for (size_type i = 0; i < total_size; i++, detail::next_idx(shape, idx))
+        indices.reserve(offsets.size());
+        auto idx = xtl::make_sequence<index_type>(dim, size_type(0));
+        for (std::size_t offset : offsets)
         {
-            if (arr.element(std::begin(idx), std::end(idx)))
+            for (std::size_t d = dim; d != 0; --d)
             {
-                indices.push_back(idx);
+                std::size_t extent = static_cast<std::size_t>(shape[d - 1]);
+                idx[d - 1] = static_cast<size_type>(offset % extent);
+                offset /= extent;
             }
+            indices.push_back(idx);
         }
-
         return indices;
     }
 
@@ -0,0 +1,283 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_PAGE_ALLOCATOR_HPP
+#define XTENSOR_PAGE_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "xtensor_config.hpp"
+#include "xparallel.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#ifndef XTENSOR_HUGE_PAGE_THRESHOLD
+#define XTENSOR_HUGE_PAGE_THRESHOLD 4194304
+#endif
+
+#ifndef XTENSOR_HUGE_PAGE_SIZE
+#define XTENSOR_HUGE_PAGE_SIZE 2097152
+#endif
+
+namespace xt
+{
+    namespace detail
+    {
+        inline std::size_t round_to_huge_page(std::size_t bytes) noexcept
+        {
+            std::size_t page = XTENSOR_HUGE_PAGE_SIZE;
+            return (bytes + page - 1) / page * page;
+        }
+
+#if defined(__linux__)
+
+        // Maps anonymous memory aligned on huge pages. Explicit huge pages
+        // (MAP_HUGETLB) require pages reserved by the system, they are only
+        // used when XTENSOR_USE_HUGETLB is defined; otherwise the mapping is
+        // advised to be backed by transparent huge pages.
+        inline void* map_huge_pages(std::size_t bytes)
+        {
+            std::size_t page = XTENSOR_HUGE_PAGE_SIZE;
+            std::size_t size = round_to_huge_page(bytes);
+#if defined(XTENSOR_USE_HUGETLB) && defined(MAP_HUGETLB)
+            void* huge = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (huge != MAP_FAILED)
+            {
+                return huge;
+            }
+#endif
+            void* raw = ::mmap(nullptr, size + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED)
+            {
+                throw std::bad_alloc();
+            }
+            char* first = static_cast<char*>(raw);
+            std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(raw);
+            char* aligned = first + ((page - addr % page) % page);
+            if (aligned != first)
+            {
+                ::munmap(first, static_cast<std::size_t>(aligned - first));
+            }
+            std::size_t tail = page - static_cast<std::size_t>(aligned - first);
+            if (tail != 0)
+            {
+                ::munmap(aligned + size, tail);
+            }
+#if defined(MADV_HUGEPAGE)
+            ::madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+            return aligned;
+        }
+
+        inline void unmap_huge_pages(void* p, std::size_t bytes) noexcept
+        {
+            ::munmap(p, round_to_huge_page(bytes));
+        }
+
+#endif
+
+        // Touches the huge pages of a new buffer from the threads of the
+        // parallel backend, so that they are placed on NUMA nodes (first
+        // touch policy) instead of all on the node of the allocating thread.
+        // The buffer is split in one contiguous range of whole huge pages per
+        // thread. The backends distribute these ranges dynamically, so the
+        // thread touching a page is not necessarily the one that will compute
+        // on it: the pages are spread over the nodes, not bound to their
+        // users.
+        inline void touch_pages(void* p, std::size_t bytes)
+        {
+#if defined(XTENSOR_PARALLEL)
+            std::size_t n_threads = num_threads();
+            if (n_threads > 1)
+            {
+                char* data = static_cast<char*>(p);
+                std::size_t page = XTENSOR_HUGE_PAGE_SIZE;
+                std::size_t n_pages = (bytes + page - 1) / page;
+                std::size_t grain = (n_pages + n_threads - 1) / n_threads;
+                parallel_for(0, n_pages, grain, [data, page](std::size_t first, std::size_t last)
+                {
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        reinterpret_cast<volatile char*>(data)[i * page] = 0;
+                    }
+                });
+            }
+#else
+            (void)p;
+            (void)bytes;
+#endif
+        }
+    }
+
+    /***********************
+     * huge_page_allocator *
+     ***********************/
+
+    /**
+     * @class huge_page_allocator
+     * @brief Allocator backing large buffers with huge pages.
+     *
+     * Buffers of at least ``XTENSOR_HUGE_PAGE_THRESHOLD`` bytes are mapped
+     * directly from the system, aligned on huge pages and backed by
+     * transparent huge pages (or by reserved huge pages when
+     * ``XTENSOR_USE_HUGETLB`` is defined), which reduces the TLB misses on
+     * large tensors. When a parallel backend is enabled, the huge pages of
+     * these buffers are first touched by the threads of the backend, so that
+     * they are spread over the NUMA nodes of these threads. The placement
+     * does not follow the split of later computations, which the backends
+     * schedule dynamically.
+     * Smaller buffers, and all the buffers on other systems than Linux, are
+     * allocated with the allocator \c A.
+     *
+     * The allocator can be used as the default allocator of xtensor:
+     *
+     * @code{.cpp}
+     * #define XTENSOR_DEFAULT_ALLOCATOR(T) xt::huge_page_allocator<T>
+     * #include "xtensor/xpage_allocator.hpp"
+     * #include "xtensor/xarray.hpp"
+     * @endcode
+     *
+     * @tparam T the type of the allocated values
+     * @tparam A the allocator of small buffers
+     */
+    template <class T, class A = std::allocator<T>>
+    class huge_page_allocator
+        : private A
+    {
+    public:
+
+        using base_type = A;
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = huge_page_allocator<U, typename std::allocator_traits<A>::template rebind_alloc<U>>;
+        };
+
+        huge_page_allocator() = default;
+
+        template <class U, class B>
+        huge_page_allocator(const huge_page_allocator<U, B>& rhs) noexcept;
+
+        pointer allocate(size_type n);
+        void deallocate(pointer p, size_type n) noexcept;
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args);
+
+        template <class U>
+        void destroy(U* p);
+
+        const base_type& base() const noexcept;
+
+        static bool is_huge(size_type n) noexcept;
+    };
+
+    template <class T, class AT, class U, class AU>
+    bool operator==(const huge_page_allocator<T, AT>& lhs, const huge_page_allocator<U, AU>& rhs) noexcept;
+
+    template <class T, class AT, class U, class AU>
+    bool operator!=(const huge_page_allocator<T, AT>& lhs, const huge_page_allocator<U, AU>& rhs) noexcept;
+
+    /**************************************
+     * huge_page_allocator implementation *
+     **************************************/
+
+    template <class T, class A>
+    template <class U, class B>
+    inline huge_page_allocator<T, A>::huge_page_allocator(const huge_page_allocator<U, B>& rhs) noexcept
+        : base_type(rhs.base())
+    {
+    }
+
+    template <class T, class A>
+    inline auto huge_page_allocator<T, A>::allocate(size_type n) -> pointer
+    {
+#if defined(__linux__)
+        if (is_huge(n))
+        {
+            static_assert(alignof(T) <= XTENSOR_HUGE_PAGE_SIZE, "huge_page_allocator: over-aligned type");
+            void* p = detail::map_huge_pages(n * sizeof(T));
+            detail::touch_pages(p, n * sizeof(T));
+            return static_cast<pointer>(p);
+        }
+#endif
+        return std::allocator_traits<A>::allocate(*this, n);
+    }
+
+    template <class T, class A>
+    inline void huge_page_allocator<T, A>::deallocate(pointer p, size_type n) noexcept
+    {
+#if defined(__linux__)
+        if (is_huge(n))
+        {
+            detail::unmap_huge_pages(p, n * sizeof(T));
+            return;
+        }
+#endif
+        std::allocator_traits<A>::deallocate(*this, p, n);
+    }
+
+    template <class T, class A>
+    template <class U, class... Args>
+    inline void huge_page_allocator<T, A>::construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <class T, class A>
+    template <class U>
+    inline void huge_page_allocator<T, A>::destroy(U* p)
+    {
+        p->~U();
+    }
+
+    template <class T, class A>
+    inline auto huge_page_allocator<T, A>::base() const noexcept -> const base_type&
+    {
+        return *this;
+    }
+
+    /**
+     * Checks if a buffer of \c n values is mapped on huge pages.
+     */
+    template <class T, class A>
+    inline bool huge_page_allocator<T, A>::is_huge(size_type n) noexcept
+    {
+        return n != 0 && n >= (std::size_t(XTENSOR_HUGE_PAGE_THRESHOLD) + sizeof(T) - 1) / sizeof(T);
+    }
+
+    template <class T, class AT, class U, class AU>
+    inline bool operator==(const huge_page_allocator<T, AT>& lhs, const huge_page_allocator<U, AU>& rhs) noexcept
+    {
+        return lhs.base() == rhs.base();
+    }
+
+    template <class T, class AT, class U, class AU>
+    inline bool operator!=(const huge_page_allocator<T, AT>& lhs, const huge_page_allocator<U, AU>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+}
+
+#endif
@@ -0,0 +1,443 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_PARALLEL_HPP
+#define XTENSOR_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include <xtl/xtype_traits.hpp>
+
+#include "xtensor_config.hpp"
+
+#if defined(XTENSOR_USE_TBB)
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tbb/tbb.h>
+#elif defined(XTENSOR_USE_THREADS)
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+#if defined(XTENSOR_USE_TBB) || defined(XTENSOR_USE_THREADS)
+#define XTENSOR_PARALLEL
+#endif
+
+namespace xt
+{
+
+    /****************
+     * declarations *
+     ****************/
+
+    std::size_t num_threads();
+    void set_num_threads(std::size_t n);
+
+    template <class F>
+    void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& f);
+
+    template <class E>
+    struct is_parallel_safe;
+
+    /****************************
+     * is_parallel_safe         *
+     ****************************/
+
+    /**
+     * Traits class indicating whether the elements of an expression
+     * can be evaluated concurrently from several threads. Leaf expressions
+     * are safe by default, closures are safe if all their template
+     * arguments are. Expressions with a mutable evaluation state (e.g.
+     * generators drawing from a random engine) must specialize this
+     * class with a false value.
+     */
+    template <class E>
+    struct is_parallel_safe : std::true_type
+    {
+    };
+
+    template <template <class...> class T, class... A>
+    struct is_parallel_safe<T<A...>>
+        : xtl::conjunction<is_parallel_safe<std::remove_cv_t<std::remove_reference_t<A>>>...>
+    {
+    };
+
+    namespace detail
+    {
+
+        /*****************
+         * thread_pool   *
+         *****************/
+
+#if defined(XTENSOR_USE_THREADS)
+
+        // Persistent pool of worker threads. The calling thread takes part in
+        // the work, so a pool of size n owns n - 1 workers. Calls to run from
+        // a worker thread, or while the pool is busy, are executed serially.
+        class thread_pool
+        {
+        public:
+
+            using task_type = std::function<void(std::size_t)>;
+
+            static thread_pool& instance();
+
+            ~thread_pool();
+
+            thread_pool(const thread_pool&) = delete;
+            thread_pool& operator=(const thread_pool&) = delete;
+
+            std::size_t size() const noexcept;
+            void resize(std::size_t n);
+
+            void run(std::size_t n_tasks, const task_type& task);
+
+        private:
+
+            thread_pool();
+
+            void start(std::size_t n_workers);
+            void stop();
+            void worker_loop();
+            void execute();
+
+            static bool& in_worker() noexcept;
+
+            std::vector<std::thread> m_workers;
+            std::mutex m_run_mutex;
+            std::mutex m_mutex;
+            std::condition_variable m_start;
+            std::condition_variable m_done;
+
+            const task_type* p_task;
+            std::size_t m_n_tasks;
+            std::atomic<std::size_t> m_next;
+            std::size_t m_slots;
+            std::size_t m_active;
+            std::exception_ptr m_exception;
+            bool m_stop;
+        };
+
+        inline thread_pool& thread_pool::instance()
+        {
+            static thread_pool pool;
+            return pool;
+        }
+
+        inline thread_pool::thread_pool()
+            : p_task(nullptr), m_n_tasks(0), m_next(0), m_slots(0), m_active(0), m_stop(false)
+        {
+            std::size_t n = std::thread::hardware_concurrency();
+            start(n > 1 ? n - 1 : 0);
+        }
+
+        inline thread_pool::~thread_pool()
+        {
+            stop();
+        }
+
+        inline std::size_t thread_pool::size() const noexcept
+        {
+            return m_workers.size() + 1;
+        }
+
+        inline void thread_pool::resize(std::size_t n)
+        {
+            std::lock_guard<std::mutex> run_lock(m_run_mutex);
+            stop();
+            start(n > 1 ? n - 1 : 0);
+        }
+
+        inline void thread_pool::run(std::size_t n_tasks, const task_type& task)
+        {
+            std::unique_lock<std::mutex> run_lock(m_run_mutex, std::try_to_lock);
+            if (!run_lock.owns_lock() || in_worker() || m_workers.empty() || n_tasks < 2)
+            {
+                for (std::size_t i = 0; i < n_tasks; ++i)
+                {
+                    task(i);
+                }
+                return;
+            }
+
+            std::size_t slots = std::min(m_workers.size(), n_tasks - 1);
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                p_task = &task;
+                m_n_tasks = n_tasks;
+                m_next.store(0);
+                m_slots = slots;
+                m_active = slots;
+                m_exception = nullptr;
+            }
+            if (slots == m_workers.size())
+            {
+                m_start.notify_all();
+            }
+            else
+            {
+                for (std::size_t i = 0; i < slots; ++i)
+                {
+                    m_start.notify_one();
+                }
+            }
+
+            in_worker() = true;
+            execute();
+            in_worker() = false;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // Slots that no worker picked up yet are not waited for,
+            // all the tasks have been executed at this point.
+            m_active -= m_slots;
+            m_slots = 0;
+            m_done.wait(lock, [this]() { return m_active == 0; });
+            p_task = nullptr;
+            if (m_exception)
+            {
+                std::exception_ptr e = m_exception;
+                m_exception = nullptr;
+                std::rethrow_exception(e);
+            }
+        }
+
+        inline void thread_pool::start(std::size_t n_workers)
+        {
+            m_stop = false;
+            m_workers.reserve(n_workers);
+            for (std::size_t i = 0; i < n_workers; ++i)
+            {
+                m_workers.emplace_back([this]() { worker_loop(); });
+            }
+        }
+
+        inline void thread_pool::stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_start.notify_all();
+            for (auto& w : m_workers)
+            {
+                w.join();
+            }
+            m_workers.clear();
+        }
+
+        inline void thread_pool::worker_loop()
+        {
+            in_worker() = true;
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (true)
+            {
+                m_start.wait(lock, [this]() { return m_stop || m_slots != 0; });
+                if (m_stop)
+                {
+                    return;
+                }
+                --m_slots;
+                lock.unlock();
+                execute();
+                lock.lock();
+                if (--m_active == 0)
+                {
+                    m_done.notify_one();
+                }
+            }
+        }
+
+        inline void thread_pool::execute()
+        {
+            for (std::size_t i = m_next++; i < m_n_tasks; i = m_next++)
+            {
+                try
+                {
+                    (*p_task)(i);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (!m_exception)
+                    {
+                        m_exception = std::current_exception();
+                    }
+                }
+            }
+        }
+
+        inline bool& thread_pool::in_worker() noexcept
+        {
+            static thread_local bool flag = false;
+            return flag;
+        }
+
+#elif defined(XTENSOR_USE_TBB)
+
+        inline std::unique_ptr<tbb::global_control>& tbb_control()
+        {
+            static std::unique_ptr<tbb::global_control> control;
+            return control;
+        }
+
+        inline std::mutex& tbb_control_mutex()
+        {
+            static std::mutex m;
+            return m;
+        }
+
+#endif
+
+        /**
+         * Returns true if an evaluation of \c size elements is worth
+         * being split across threads.
+         */
+        inline bool use_parallel(std::size_t size) noexcept
+        {
+#if defined(XTENSOR_PARALLEL)
+            return size >= std::size_t(XTENSOR_PARALLEL_THRESHOLD) && num_threads() > 1;
+#else
+            (void)size;
+            return false;
+#endif
+        }
+
+        /**
+         * Returns the number of elements of type \c T fitting in
+         * XTENSOR_PARALLEL_CHUNK_BYTES, rounded down to a multiple
+         * of \c multiple (and at least \c multiple).
+         */
+        template <class T>
+        inline std::size_t cache_chunk_size(std::size_t multiple = 1) noexcept
+        {
+            std::size_t n = std::size_t(XTENSOR_PARALLEL_CHUNK_BYTES) / sizeof(T);
+            n -= n % multiple;
+            return std::max(n, multiple);
+        }
+
+        /**
+         * Returns a grain size splitting \c size iterations into a few
+         * chunks per thread, for loops whose iterations are already large.
+         */
+        inline std::size_t balanced_grain(std::size_t size) noexcept
+        {
+            std::size_t n_chunks = 4 * num_threads();
+            return std::max(std::size_t(1), (size + n_chunks - 1) / n_chunks);
+        }
+    }
+
+    /*********************************
+     * num_threads / set_num_threads *
+     *********************************/
+
+    /**
+     * Returns the number of threads used by the parallel evaluation
+     * of expressions, including the calling thread. Returns 1 when
+     * neither XTENSOR_USE_THREADS nor XTENSOR_USE_TBB is defined.
+     */
+    inline std::size_t num_threads()
+    {
+#if defined(XTENSOR_USE_THREADS)
+        return detail::thread_pool::instance().size();
+#elif defined(XTENSOR_USE_TBB)
+        return static_cast<std::size_t>(tbb::global_control::active_value(tbb::global_control::max_allowed_parallelism));
+#else
+        return 1;
+#endif
+    }
+
+    /**
+     * Sets the number of threads used by the parallel evaluation of
+     * expressions. A value of 0 restores the default, i.e. the number
+     * of hardware threads. This function has no effect when no parallel
+     * backend is enabled.
+     * @param n the number of threads
+     */
+    inline void set_num_threads(std::size_t n)
+    {
+#if defined(XTENSOR_USE_THREADS)
+        if (n == 0)
+        {
+            n = std::max(std::size_t(std::thread::hardware_concurrency()), std::size_t(1));
+        }
+        detail::thread_pool::instance().resize(n);
+#elif defined(XTENSOR_USE_TBB)
+        std::lock_guard<std::mutex> lock(detail::tbb_control_mutex());
+        auto& control = detail::tbb_control();
+        control.reset();
+        if (n != 0)
+        {
+            control.reset(new tbb::global_control(tbb::global_control::max_allowed_parallelism, n));
+        }
+#else
+        (void)n;
+#endif
+    }
+
+    /*****************************
+     * parallel_for              *
+     *****************************/
+
+    /**
+     * Splits the range [first, last) into chunks of \c grain iterations
+     * and calls \c f(chunk_first, chunk_last) on each of them, possibly
+     * from different threads. Chunks boundaries are always of the form
+     * first + k * grain. When no parallel backend is enabled, or when the
+     * range holds a single chunk, \c f is called once on the whole range
+     * from the calling thread.
+     * @param first the beginning of the range
+     * @param last the end of the range
+     * @param grain the size of the chunks
+     * @param f the function to call on each chunk
+     */
+    template <class F>
+    inline void parallel_for(std::size_t first, std::size_t last, std::size_t grain, F&& f)
+    {
+        if (first >= last)
+        {
+            return;
+        }
+        grain = std::max(grain, std::size_t(1));
+        std::size_t n_chunks = (last - first + grain - 1) / grain;
+#if defined(XTENSOR_USE_THREADS)
+        if (n_chunks > 1)
+        {
+            detail::thread_pool::task_type task = [&f, first, last, grain](std::size_t i)
+            {
+                std::size_t chunk_first = first + i * grain;
+                f(chunk_first, std::min(chunk_first + grain, last));
+            };
+            detail::thread_pool::instance().run(n_chunks, task);
+            return;
+        }
+#elif defined(XTENSOR_USE_TBB)
+        if (n_chunks > 1)
+        {
+            tbb::parallel_for(std::size_t(0), n_chunks, [&f, first, last, grain](std::size_t i)
+            {
+                std::size_t chunk_first = first + i * grain;
+                f(chunk_first, std::min(chunk_first + grain, last));
+            });
+            return;
+        }
+#else
+        (void)n_chunks;
+#endif
+        f(first, last);
+    }
+}
+
+#endif
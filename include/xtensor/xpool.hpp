@@ -0,0 +1,573 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XTENSOR_POOL_HPP
+#define XTENSOR_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "xarray.hpp"
+#include "xstorage.hpp"
+#include "xtensor.hpp"
+#include "xtensor_config.hpp"
+
+#ifndef XTENSOR_POOL_MAX_CACHED_BYTES
+#define XTENSOR_POOL_MAX_CACHED_BYTES 1073741824
+#endif
+
+namespace xt
+{
+    /*******************
+     * pool_statistics *
+     *******************/
+
+    /**
+     * @struct pool_statistics
+     * @brief Counters of a tensor_pool.
+     *
+     * \c hits counts the buffers taken from the pool, including the
+     * \c steals taken from the free list of another thread, \c misses
+     * counts the buffers allocated on the heap, and \c releases the
+     * buffers given back to the pool.
+     */
+    struct pool_statistics
+    {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t steals = 0;
+        std::size_t releases = 0;
+        std::size_t cached_buffers = 0;
+        std::size_t cached_bytes = 0;
+    };
+
+    namespace detail
+    {
+        // The free lists are split in shards protected by their own mutex.
+        // Each thread releases its buffers to its home shard and looks there
+        // first for new buffers, before trying to steal from the other ones.
+        class pool_state
+        {
+        public:
+
+            explicit pool_state(std::size_t max_cached_bytes);
+            ~pool_state();
+
+            pool_state(const pool_state&) = delete;
+            pool_state& operator=(const pool_state&) = delete;
+
+            void* acquire(std::size_t bytes);
+            void release(void* p, std::size_t bytes) noexcept;
+
+            void clear() noexcept;
+            pool_statistics statistics() const;
+            void reset_statistics() noexcept;
+
+        private:
+
+            struct shard
+            {
+                std::mutex m_mutex;
+                std::unordered_map<std::size_t, std::vector<void*>> m_buffers;
+            };
+
+            static void* pop(shard& s, std::size_t bytes);
+            shard& home_shard() noexcept;
+
+            std::vector<std::unique_ptr<shard>> m_shards;
+            std::size_t m_max_cached_bytes;
+            std::atomic<std::size_t> m_cached_bytes;
+            std::atomic<std::size_t> m_cached_buffers;
+            std::atomic<std::size_t> m_hits;
+            std::atomic<std::size_t> m_misses;
+            std::atomic<std::size_t> m_steals;
+            std::atomic<std::size_t> m_releases;
+        };
+
+        inline const std::shared_ptr<pool_state>& default_pool_state()
+        {
+            static std::shared_ptr<pool_state> state = std::make_shared<pool_state>(XTENSOR_POOL_MAX_CACHED_BYTES);
+            return state;
+        }
+    }
+
+    /******************
+     * pool_allocator *
+     ******************/
+
+    /**
+     * @class pool_allocator
+     * @brief Allocator recycling its buffers through a tensor_pool.
+     *
+     * Deallocated buffers are kept in the free lists of the pool, and handed
+     * out again to the next allocation of the same size in bytes. A default
+     * constructed allocator uses the default pool, see default_tensor_pool.
+     * The allocator shares the ownership of the pool state, so buffers can
+     * outlive the tensor_pool object they come from.
+     *
+     * @tparam T the type of the allocated values
+     */
+    template <class T>
+    class pool_allocator
+    {
+    public:
+
+        using value_type = T;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        template <class U>
+        struct rebind
+        {
+            using other = pool_allocator<U>;
+        };
+
+        pool_allocator() noexcept;
+        explicit pool_allocator(std::shared_ptr<detail::pool_state> state) noexcept;
+
+        template <class U>
+        pool_allocator(const pool_allocator<U>& rhs) noexcept;
+
+        pointer allocate(size_type n);
+        void deallocate(pointer p, size_type n) noexcept;
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args);
+
+        template <class U>
+        void destroy(U* p);
+
+        const std::shared_ptr<detail::pool_state>& state() const noexcept;
+
+    private:
+
+        std::shared_ptr<detail::pool_state> p_state;
+    };
+
+    template <class T, class U>
+    bool operator==(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs) noexcept;
+
+    template <class T, class U>
+    bool operator!=(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs) noexcept;
+
+    /**
+     * @typedef pooled_tensor
+     * Alias template on xtensor_container whose buffer is recycled
+     * through a tensor_pool.
+     */
+    template <class T, std::size_t N, layout_type L = XTENSOR_DEFAULT_LAYOUT>
+    using pooled_tensor = xtensor_container<uvector<T, pool_allocator<T>>, N, L>;
+
+    /**
+     * @typedef pooled_array
+     * Alias template on xarray_container whose buffer is recycled
+     * through a tensor_pool.
+     */
+    template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT>
+    using pooled_array = xarray_container<uvector<T, pool_allocator<T>>, L>;
+
+    /***************
+     * tensor_pool *
+     ***************/
+
+    /**
+     * @class tensor_pool
+     * @brief Pool of recycled tensor buffers.
+     *
+     * The containers made by the pool allocate their buffer with a
+     * pool_allocator; when they are destroyed or resized, their buffer goes
+     * back to the pool instead of the heap, and the next container of the
+     * same size in bytes reuses it. The free lists are keyed by size in bytes
+     * rather than by shape, value type and layout, so that tensors of
+     * different shapes or types with the same number of bytes share their
+     * buffers.
+     *
+     * The pool is thread-safe: each thread gives its buffers back to its own
+     * free list, and steals from the free lists of the other threads when
+     * its own is empty. The buffers kept by the pool are limited to
+     * \c max_cached_bytes, further buffers are freed.
+     *
+     * @code{.cpp}
+     * xt::tensor_pool pool;
+     * for (auto& frame : frames)
+     * {
+     *     auto tmp = pool.make_tensor<float, 3>({480, 640, 3});
+     *     xt::noalias(tmp) = process(frame);
+     * }
+     * @endcode
+     */
+    class tensor_pool
+    {
+    public:
+
+        explicit tensor_pool(std::size_t max_cached_bytes = XTENSOR_POOL_MAX_CACHED_BYTES);
+        explicit tensor_pool(std::shared_ptr<detail::pool_state> state) noexcept;
+
+        template <class T>
+        pool_allocator<T> get_allocator() const noexcept;
+
+        template <class T, std::size_t N, layout_type L = XTENSOR_DEFAULT_LAYOUT, class S>
+        pooled_tensor<T, N, L> make_tensor(const S& shape) const;
+        template <class T, std::size_t N, layout_type L = XTENSOR_DEFAULT_LAYOUT, class I>
+        pooled_tensor<T, N, L> make_tensor(std::initializer_list<I> shape) const;
+
+        template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class S>
+        pooled_array<T, L> make_array(const S& shape) const;
+        template <class T, layout_type L = XTENSOR_DEFAULT_LAYOUT, class I>
+        pooled_array<T, L> make_array(std::initializer_list<I> shape) const;
+
+        pool_statistics statistics() const;
+        void reset_statistics() noexcept;
+        void clear() noexcept;
+
+    private:
+
+        template <class C, class S>
+        C make_container(const S& shape) const;
+
+        std::shared_ptr<detail::pool_state> p_state;
+    };
+
+    tensor_pool& default_tensor_pool();
+
+    /*****************************
+     * pool_state implementation *
+     *****************************/
+
+    namespace detail
+    {
+        inline pool_state::pool_state(std::size_t max_cached_bytes)
+            : m_max_cached_bytes(max_cached_bytes),
+              m_cached_bytes(0), m_cached_buffers(0),
+              m_hits(0), m_misses(0), m_steals(0), m_releases(0)
+        {
+            std::size_t n_shards = std::max(std::size_t(std::thread::hardware_concurrency()), std::size_t(1));
+            m_shards.reserve(n_shards);
+            for (std::size_t i = 0; i < n_shards; ++i)
+            {
+                m_shards.push_back(std::make_unique<shard>());
+            }
+        }
+
+        inline pool_state::~pool_state()
+        {
+            clear();
+        }
+
+        inline void* pool_state::acquire(std::size_t bytes)
+        {
+            shard& home = home_shard();
+            void* p = pop(home, bytes);
+            if (p == nullptr && m_cached_buffers.load(std::memory_order_relaxed) != 0)
+            {
+                for (auto& s : m_shards)
+                {
+                    if (s.get() != &home && (p = pop(*s, bytes)) != nullptr)
+                    {
+                        m_steals.fetch_add(1, std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+            if (p != nullptr)
+            {
+                m_cached_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+                m_cached_buffers.fetch_sub(1, std::memory_order_relaxed);
+                m_hits.fetch_add(1, std::memory_order_relaxed);
+                return p;
+            }
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(bytes);
+        }
+
+        inline void pool_state::release(void* p, std::size_t bytes) noexcept
+        {
+            std::size_t cached = m_cached_bytes.fetch_add(bytes, std::memory_order_relaxed);
+            if (cached + bytes > m_max_cached_bytes)
+            {
+                m_cached_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+                ::operator delete(p);
+                return;
+            }
+            shard& home = home_shard();
+            try
+            {
+                std::lock_guard<std::mutex> lock(home.m_mutex);
+                home.m_buffers[bytes].push_back(p);
+            }
+            catch (...)
+            {
+                m_cached_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+                ::operator delete(p);
+                return;
+            }
+            m_cached_buffers.fetch_add(1, std::memory_order_relaxed);
+            m_releases.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline void pool_state::clear() noexcept
+        {
+            for (auto& s : m_shards)
+            {
+                std::lock_guard<std::mutex> lock(s->m_mutex);
+                for (auto& entry : s->m_buffers)
+                {
+                    for (void* p : entry.second)
+                    {
+                        ::operator delete(p);
+                        m_cached_bytes.fetch_sub(entry.first, std::memory_order_relaxed);
+                        m_cached_buffers.fetch_sub(1, std::memory_order_relaxed);
+                    }
+                }
+                s->m_buffers.clear();
+            }
+        }
+
+        inline pool_statistics pool_state::statistics() const
+        {
+            pool_statistics res;
+            res.hits = m_hits.load(std::memory_order_relaxed);
+            res.misses = m_misses.load(std::memory_order_relaxed);
+            res.steals = m_steals.load(std::memory_order_relaxed);
+            res.releases = m_releases.load(std::memory_order_relaxed);
+            res.cached_buffers = m_cached_buffers.load(std::memory_order_relaxed);
+            res.cached_bytes = m_cached_bytes.load(std::memory_order_relaxed);
+            return res;
+        }
+
+        inline void pool_state::reset_statistics() noexcept
+        {
+            m_hits.store(0, std::memory_order_relaxed);
+            m_misses.store(0, std::memory_order_relaxed);
+            m_steals.store(0, std::memory_order_relaxed);
+            m_releases.store(0, std::memory_order_relaxed);
+        }
+
+        inline void* pool_state::pop(shard& s, std::size_t bytes)
+        {
+            std::lock_guard<std::mutex> lock(s.m_mutex);
+            auto it = s.m_buffers.find(bytes);
+            if (it == s.m_buffers.end() || it->second.empty())
+            {
+                return nullptr;
+            }
+            void* p = it->second.back();
+            it->second.pop_back();
+            return p;
+        }
+
+        inline auto pool_state::home_shard() noexcept -> shard&
+        {
+            static std::atomic<std::size_t> next_thread(0);
+            thread_local std::size_t thread_index = next_thread.fetch_add(1, std::memory_order_relaxed);
+            return *m_shards[thread_index % m_shards.size()];
+        }
+    }
+
+    /*********************************
+     * pool_allocator implementation *
+     *********************************/
+
+    template <class T>
+    inline pool_allocator<T>::pool_allocator() noexcept
+        : p_state(detail::default_pool_state())
+    {
+    }
+
+    template <class T>
+    inline pool_allocator<T>::pool_allocator(std::shared_ptr<detail::pool_state> state) noexcept
+        : p_state(std::move(state))
+    {
+    }
+
+    template <class T>
+    template <class U>
+    inline pool_allocator<T>::pool_allocator(const pool_allocator<U>& rhs) noexcept
+        : p_state(rhs.state())
+    {
+    }
+
+    template <class T>
+    inline auto pool_allocator<T>::allocate(size_type n) -> pointer
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "pool_allocator: over-aligned type");
+        return static_cast<pointer>(p_state->acquire(n * sizeof(T)));
+    }
+
+    template <class T>
+    inline void pool_allocator<T>::deallocate(pointer p, size_type n) noexcept
+    {
+        p_state->release(p, n * sizeof(T));
+    }
+
+    template <class T>
+    template <class U, class... Args>
+    inline void pool_allocator<T>::construct(U* p, Args&&... args)
+    {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <class T>
+    template <class U>
+    inline void pool_allocator<T>::destroy(U* p)
+    {
+        p->~U();
+    }
+
+    template <class T>
+    inline auto pool_allocator<T>::state() const noexcept -> const std::shared_ptr<detail::pool_state>&
+    {
+        return p_state;
+    }
+
+    template <class T, class U>
+    inline bool operator==(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs) noexcept
+    {
+        return lhs.state() == rhs.state();
+    }
+
+    template <class T, class U>
+    inline bool operator!=(const pool_allocator<T>& lhs, const pool_allocator<U>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    /******************************
+     * tensor_pool implementation *
+     ******************************/
+
+    /**
+     * Builds a new pool.
+     * @param max_cached_bytes the maximum number of bytes kept in the free lists
+     */
+    inline tensor_pool::tensor_pool(std::size_t max_cached_bytes)
+        : p_state(std::make_shared<detail::pool_state>(max_cached_bytes))
+    {
+    }
+
+    inline tensor_pool::tensor_pool(std::shared_ptr<detail::pool_state> state) noexcept
+        : p_state(std::move(state))
+    {
+    }
+
+    /**
+     * Returns an allocator recycling its buffers through this pool.
+     */
+    template <class T>
+    inline pool_allocator<T> tensor_pool::get_allocator() const noexcept
+    {
+        return pool_allocator<T>(p_state);
+    }
+
+    /**
+     * Makes a tensor whose buffer is taken from the pool. The elements
+     * are default-initialized, see uninitialized_t.
+     * @param shape the shape of the tensor
+     */
+    template <class T, std::size_t N, layout_type L, class S>
+    inline pooled_tensor<T, N, L> tensor_pool::make_tensor(const S& shape) const
+    {
+        return make_container<pooled_tensor<T, N, L>>(shape);
+    }
+
+    template <class T, std::size_t N, layout_type L, class I>
+    inline pooled_tensor<T, N, L> tensor_pool::make_tensor(std::initializer_list<I> shape) const
+    {
+        return make_container<pooled_tensor<T, N, L>>(shape);
+    }
+
+    /**
+     * Makes an array whose buffer is taken from the pool. The elements
+     * are default-initialized, see uninitialized_t.
+     * @param shape the shape of the array
+     */
+    template <class T, layout_type L, class S>
+    inline pooled_array<T, L> tensor_pool::make_array(const S& shape) const
+    {
+        return make_container<pooled_array<T, L>>(shape);
+    }
+
+    template <class T, layout_type L, class I>
+    inline pooled_array<T, L> tensor_pool::make_array(std::initializer_list<I> shape) const
+    {
+        return make_container<pooled_array<T, L>>(shape);
+    }
+
+    /**
+     * Returns the counters of the pool.
+     */
+    inline pool_statistics tensor_pool::statistics() const
+    {
+        return p_state->statistics();
+    }
+
+    /**
+     * Resets the hit, miss, steal and release counters of the pool.
+     */
+    inline void tensor_pool::reset_statistics() noexcept
+    {
+        p_state->reset_statistics();
+    }
+
+    /**
+     * Frees the buffers kept in the free lists of the pool.
+     */
+    inline void tensor_pool::clear() noexcept
+    {
+        p_state->clear();
+    }
+
+    template <class C, class S>
+    inline C tensor_pool::make_container(const S& shape) const
+    {
+        using storage_type = typename C::storage_type;
+        using inner_shape_type = typename C::inner_shape_type;
+        using inner_strides_type = typename C::inner_strides_type;
+        using value_type = typename C::value_type;
+        constexpr std::ptrdiff_t static_dim = static_dimension<inner_shape_type>::value;
+        if (static_dim != -1 && static_cast<std::ptrdiff_t>(shape.size()) != static_dim)
+        {
+            throw std::runtime_error("tensor_pool: shape of " + std::to_string(shape.size()) +
+                                     " dimensions for a container of dimension " + std::to_string(static_dim));
+        }
+        inner_shape_type sh = xtl::make_sequence<inner_shape_type>(shape.size(), std::size_t(0));
+        std::copy(shape.begin(), shape.end(), sh.begin());
+        inner_strides_type strides = xtl::make_sequence<inner_strides_type>(shape.size(), std::size_t(0));
+        layout_type l = C::static_layout == layout_type::dynamic ? XTENSOR_DEFAULT_LAYOUT : C::static_layout;
+        std::size_t size = compute_strides(sh, l, strides);
+        storage_type storage(size, uninitialized, get_allocator<value_type>());
+        return C(std::move(storage), std::move(sh), std::move(strides));
+    }
+
+    /**
+     * Returns the pool used by default constructed pool_allocator objects,
+     * and therefore by the pooled_tensor and pooled_array containers that
+     * are not made by another pool.
+     */
+    inline tensor_pool& default_tensor_pool()
+    {
+        static tensor_pool pool(detail::default_pool_state());
+        return pool;
+    }
+}
+
+#endif
@@ -13,12 +13,21 @@
 #ifndef XTENSOR_RANDOM_HPP
 #define XTENSOR_RANDOM_HPP
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <random>
+#include <type_traits>
 #include <utility>
 
 #include "xbuilder.hpp"
 #include "xgenerator.hpp"
+#include "xparallel.hpp"
+#include "xstorage.hpp"
 #include "xtensor.hpp"
 #include "xview.hpp"
 
@@ -48,6 +57,18 @@ namespace xt
         auto randn(const S& shape, T mean = 0, T std_dev = 1,
                    E& engine = random::get_default_random_engine());
 
+        template <class T, class S, class E = random::default_engine_type>
+        auto exponential(const S& shape, T rate = 1,
+                         E& engine = random::get_default_random_engine());
+
+        template <class T, class S, class E = random::default_engine_type>
+        auto gamma(const S& shape, T alpha = 1, T beta = 1,
+                   E& engine = random::get_default_random_engine());
+
+        template <class T, class S, class E = random::default_engine_type>
+        auto poisson(const S& shape, double mean = 1,
+                     E& engine = random::get_default_random_engine());
+
 #ifdef X_OLD_CLANG
         template <class T, class I, class E = random::default_engine_type>
         auto rand(std::initializer_list<I> shape, T lower = 0, T upper = 1,
@@ -61,6 +82,18 @@ namespace xt
         template <class T, class I, class E = random::default_engine_type>
         auto randn(std::initializer_list<I>, T mean = 0, T std_dev = 1,
                    E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto exponential(std::initializer_list<I> shape, T rate = 1,
+                         E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto gamma(std::initializer_list<I> shape, T alpha = 1, T beta = 1,
+                   E& engine = random::get_default_random_engine());
+
+        template <class T, class I, class E = random::default_engine_type>
+        auto poisson(std::initializer_list<I> shape, double mean = 1,
+                     E& engine = random::get_default_random_engine());
 #else
         template <class T, class I, std::size_t L, class E = random::default_engine_type>
         auto rand(const I (&shape)[L], T lower = 0, T upper = 1,
@@ -73,6 +106,18 @@ namespace xt
         template <class T, class I, std::size_t L, class E = random::default_engine_type>
         auto randn(const I (&shape)[L], T mean = 0, T std_dev = 1,
                    E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto exponential(const I (&shape)[L], T rate = 1,
+                         E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto gamma(const I (&shape)[L], T alpha = 1, T beta = 1,
+                   E& engine = random::get_default_random_engine());
+
+        template <class T, class I, std::size_t L, class E = random::default_engine_type>
+        auto poisson(const I (&shape)[L], double mean = 1,
+                     E& engine = random::get_default_random_engine());
 #endif
 
         template <class T, class E = random::default_engine_type>
@@ -86,11 +131,813 @@ namespace xt
         std::enable_if_t<is_xexpression<std::decay_t<T>>::value, std::decay_t<T>>
         permutation(T&& e, E& engine = random::get_default_random_engine());
 
-        template <class T, class E = random::default_engine_type>
-        xtensor<typename T::value_type, 1> choice(const xexpression<T>& e, std::size_t n, bool replace = true,
-                                                  E& engine = random::get_default_random_engine());
+        template <class T, class E = random::default_engine_type>
+        xtensor<typename T::value_type, 1> choice(const xexpression<T>& e, std::size_t n, bool replace = true,
+                                                  E& engine = random::get_default_random_engine());
+    }
+
+    /*************************
+     * Counter-based engines *
+     *************************/
+
+    namespace detail
+    {
+        // Philox4x32-10 and Threefry2x64-20 bijections, from "Parallel random
+        // numbers: as easy as 1, 2, 3" (Salmon et al., SC11). The counter of a
+        // block is made of a position and a stream, both 64-bit.
+
+        struct philox4x32_bijection
+        {
+            using value_type = std::uint32_t;
+            using block_type = std::array<std::uint32_t, 4>;
+            using key_type = std::array<std::uint32_t, 2>;
+
+            static key_type make_key(std::uint64_t seed) noexcept
+            {
+                return {{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)}};
+            }
+
+            static block_type make_counter(std::uint64_t stream, std::uint64_t position) noexcept
+            {
+                return {{static_cast<std::uint32_t>(position), static_cast<std::uint32_t>(position >> 32),
+                         static_cast<std::uint32_t>(stream), static_cast<std::uint32_t>(stream >> 32)}};
+            }
+
+            static std::uint64_t word64(const block_type& b, std::size_t i) noexcept
+            {
+                return (std::uint64_t(b[2 * i + 1]) << 32) | b[2 * i];
+            }
+
+            static void round(block_type& c, const key_type& k) noexcept
+            {
+                std::uint64_t p0 = std::uint64_t(0xD2511F53u) * c[0];
+                std::uint64_t p1 = std::uint64_t(0xCD9E8D57u) * c[2];
+                c = {{static_cast<std::uint32_t>(p1 >> 32) ^ c[1] ^ k[0], static_cast<std::uint32_t>(p1),
+                      static_cast<std::uint32_t>(p0 >> 32) ^ c[3] ^ k[1], static_cast<std::uint32_t>(p0)}};
+            }
+
+            static block_type apply(block_type c, key_type k) noexcept
+            {
+                round(c, k);
+                for (std::size_t r = 1; r < 10; ++r)
+                {
+                    k[0] += 0x9E3779B9u;
+                    k[1] += 0xBB67AE85u;
+                    round(c, k);
+                }
+                return c;
+            }
+        };
+
+        struct threefry2x64_bijection
+        {
+            using value_type = std::uint64_t;
+            using block_type = std::array<std::uint64_t, 2>;
+            using key_type = std::array<std::uint64_t, 2>;
+
+            static key_type make_key(std::uint64_t seed) noexcept
+            {
+                return {{seed, 0}};
+            }
+
+            static block_type make_counter(std::uint64_t stream, std::uint64_t position) noexcept
+            {
+                return {{position, stream}};
+            }
+
+            static void mix(block_type& x, unsigned rot) noexcept
+            {
+                x[0] += x[1];
+                x[1] = (x[1] << rot) | (x[1] >> (64 - rot));
+                x[1] ^= x[0];
+            }
+
+            static std::uint64_t word64(const block_type& b, std::size_t i) noexcept
+            {
+                return b[i];
+            }
+
+            static block_type apply(block_type x, const key_type& k) noexcept
+            {
+                const std::uint64_t ks[3] = {k[0], k[1], 0x1BD11BDAA9FC1A22ull ^ k[0] ^ k[1]};
+                x[0] += ks[0];
+                x[1] += ks[1];
+                // Five groups of four rounds, each followed by a key injection
+                for (std::uint64_t s = 1; s <= 5; ++s)
+                {
+                    if (s % 2 == 1)
+                    {
+                        mix(x, 16);
+                        mix(x, 42);
+                        mix(x, 12);
+                        mix(x, 31);
+                    }
+                    else
+                    {
+                        mix(x, 16);
+                        mix(x, 32);
+                        mix(x, 24);
+                        mix(x, 21);
+                    }
+                    x[0] += ks[s % 3];
+                    x[1] += ks[(s + 1) % 3] + s;
+                }
+                return x;
+            }
+        };
+    }
+
+    namespace random
+    {
+        /**
+         * @class counter_based_engine
+         * @brief Counter-based random number engine.
+         *
+         * The numbers are blocks of a keyed bijection applied to a counter,
+         * instead of the successive states of a recurrence: the block at a
+         * given counter only depends on the seed and on the counter, and can
+         * be computed without the previous ones. The counter is made of a
+         * stream and a position in this stream.
+         *
+         * Used sequentially, the engine meets the requirements of a random
+         * number engine of the standard library, drawing the words of the
+         * successive blocks of its current stream. When it is passed to the
+         * xtensor random functions such as rand or randn, each element of the
+         * returned expression is drawn from its own stream, so that the value
+         * at the flat index \c i (in row-major order) only depends on the seed
+         * and on \c i. The expression can then be evaluated in parallel, or
+         * through views in any order, and always gives the same values.
+         *
+         * An expression of \c n elements takes the \c n streams starting at
+         * the current stream of the engine, or at the next one if numbers
+         * have already been drawn from the current stream, and leaves the
+         * engine at the beginning of the stream following them. Numbers
+         * drawn sequentially and expressions built from the same engine
+         * thus never share a block.
+         *
+         * @code{.cpp}
+         * xt::random::philox4x32 engine(42);
+         * auto a = xt::random::randn<double>({1000, 1000}, 0., 1., engine);
+         * xt::xtensor<double, 2> b = a; // same values with any number of threads
+         * double v = a(3, 4);           // same as b(3, 4)
+         * @endcode
+         *
+         * @tparam B the bijection, see philox4x32 and threefry2x64
+         */
+        template <class B>
+        class counter_based_engine
+        {
+        public:
+
+            using bijection_type = B;
+            using result_type = typename B::value_type;
+            using block_type = typename B::block_type;
+            using key_type = typename B::key_type;
+            using seed_type = std::uint64_t;
+
+            static constexpr std::size_t block_size = std::tuple_size<block_type>::value;
+            static constexpr seed_type default_seed = 0;
+
+            explicit counter_based_engine(seed_type s = default_seed, std::uint64_t stream = 0) noexcept;
+
+            void seed(seed_type s = default_seed) noexcept;
+
+            result_type operator()() noexcept;
+            void discard(unsigned long long n) noexcept;
+
+            std::uint64_t stream() const noexcept;
+            void set_stream(std::uint64_t stream) noexcept;
+            std::uint64_t position() const noexcept;
+
+            block_type block(std::uint64_t stream, std::uint64_t position) const noexcept;
+            std::uint64_t word64(std::uint64_t stream, std::size_t i) const noexcept;
+
+            static constexpr result_type min() noexcept;
+            static constexpr result_type max() noexcept;
+
+            template <class B2>
+            friend bool operator==(const counter_based_engine<B2>& lhs, const counter_based_engine<B2>& rhs) noexcept;
+
+        private:
+
+            key_type m_key;
+            std::uint64_t m_stream;
+            std::uint64_t m_position;
+            block_type m_block;
+            std::size_t m_word;
+        };
+
+        template <class B>
+        bool operator!=(const counter_based_engine<B>& lhs, const counter_based_engine<B>& rhs) noexcept;
+
+        /**
+         * @typedef philox4x32
+         * Philox4x32-10 engine, drawing 32-bit numbers. It relies on
+         * multiplications and is usually the fastest.
+         */
+        using philox4x32 = counter_based_engine<detail::philox4x32_bijection>;
+
+        /**
+         * @typedef threefry2x64
+         * Threefry2x64-20 engine, drawing 64-bit numbers. It only relies on
+         * additions, rotations and xors.
+         */
+        using threefry2x64 = counter_based_engine<detail::threefry2x64_bijection>;
+
+        /**
+         * Traits class telling if a random number engine is counter-based.
+         */
+        template <class E>
+        struct is_counter_based_engine : std::false_type
+        {
+        };
+
+        template <class B>
+        struct is_counter_based_engine<counter_based_engine<B>> : std::true_type
+        {
+        };
+    }
+
+    /************
+     * Samplers *
+     ************/
+
+    namespace detail
+    {
+        template <class E>
+        constexpr std::uint64_t engine_range() noexcept
+        {
+            return static_cast<std::uint64_t>(E::max()) - static_cast<std::uint64_t>(E::min());
+        }
+
+        // Number of random bits of the numbers drawn by an engine: 32, 64,
+        // or 0 for the other ranges
+        template <class E>
+        struct engine_bits
+            : std::integral_constant<int, engine_range<E>() == ~std::uint64_t(0) ? 64 : (engine_range<E>() == 0xFFFFFFFFull ? 32 : 0)>
+        {
+        };
+
+        template <class E>
+        inline std::uint64_t random_bits(E& e, std::integral_constant<int, 64>)
+        {
+            return static_cast<std::uint64_t>(e() - E::min());
+        }
+
+        template <class E>
+        inline std::uint64_t random_bits(E& e, std::integral_constant<int, 32>)
+        {
+            std::uint64_t low = static_cast<std::uint64_t>(e() - E::min());
+            std::uint64_t high = static_cast<std::uint64_t>(e() - E::min());
+            return (high << 32) | low;
+        }
+
+        template <class E>
+        inline std::uint64_t random_bits(E& e, std::integral_constant<int, 0>)
+        {
+            return std::uniform_int_distribution<std::uint64_t>()(e);
+        }
+
+        // 64 random bits drawn from e
+        template <class E>
+        inline std::uint64_t random_bits(E& e)
+        {
+            return random_bits(e, engine_bits<E>());
+        }
+
+        // Uniform number in [0, 1) made of the high bits of w
+        template <class T>
+        inline T canonical_from_bits(std::uint64_t w) noexcept
+        {
+            using float_type = std::conditional_t<std::numeric_limits<T>::digits <= 24, float, double>;
+            constexpr int digits = std::numeric_limits<float_type>::digits;
+            constexpr float_type scale = float_type(1) / float_type(std::uint64_t(1) << digits);
+            return static_cast<T>(static_cast<float_type>(w >> (64 - digits)) * scale);
+        }
+
+        // Uniform number in (0, 1]
+        template <class E>
+        inline double open_canonical(E& e)
+        {
+            return 1. - canonical_from_bits<double>(random_bits(e));
+        }
+
+        // Algorithm of std::generate_canonical<T, digits> in libstdc++, without
+        // its generic computation of the number of random bits of the engine
+        // when it draws 32 or 64 bits. The numbers match the ones of libstdc++
+        // only, other standard libraries may implement it differently.
+        template <class T, class E, int B = engine_bits<E>::value>
+        struct canonical_generator
+        {
+            static constexpr int digits = std::numeric_limits<T>::digits;
+            static constexpr std::size_t words = (std::size_t(digits) + B - 1) / B;
+
+            static T generate(E& e)
+            {
+                const T radix = T(2) * T(std::uint64_t(1) << (B - 1));
+                T sum = T(0);
+                T scale = T(1);
+                for (std::size_t k = 0; k < words; ++k)
+                {
+                    sum += T(e() - E::min()) * scale;
+                    scale *= radix;
+                }
+                T res = sum / scale;
+                return res < T(1) ? res : T(1) - std::numeric_limits<T>::epsilon() / T(2);
+            }
+        };
+
+        template <class T, class E>
+        struct canonical_generator<T, E, 0>
+        {
+            static T generate(E& e)
+            {
+                return std::generate_canonical<T, std::numeric_limits<T>::digits>(e);
+            }
+        };
+
+        // Ziggurat of 256 layers of the same area v under a decreasing density
+        // f, with a tail starting at r ("The ziggurat method for generating
+        // random variables", Marsaglia and Tsang, 2000). A random 64-bit word
+        // selects a layer with its 8 low bits and a position in the layer with
+        // its 52 high bits; the position is accepted without evaluating f
+        // in about 99% of the cases.
+        struct ziggurat_table
+        {
+            std::array<double, 256> width;
+            std::array<std::uint64_t, 256> inner;
+            std::array<double, 257> density;
+            double tail;
+
+            template <class F, class FI>
+            ziggurat_table(double r, double v, F f, FI f_inverse)
+                : tail(r)
+            {
+                constexpr double scale = 4503599627370496.;  // 2^52
+                std::array<double, 257> x;
+                x[0] = v / f(r);
+                x[1] = r;
+                for (std::size_t i = 1; i < 255; ++i)
+                {
+                    x[i + 1] = f_inverse(f(x[i]) + v / x[i]);
+                }
+                x[256] = 0.;
+                for (std::size_t i = 0; i < 256; ++i)
+                {
+                    width[i] = x[i] / scale;
+                    inner[i] = static_cast<std::uint64_t>(x[i + 1] / x[i] * scale);
+                }
+                for (std::size_t i = 0; i < 257; ++i)
+                {
+                    density[i] = f(x[i]);
+                }
+            }
+
+            // Position in the layer selected by w, and whether it is accepted
+            // without further test
+            double candidate(std::uint64_t w, bool& accepted) const noexcept
+            {
+                std::size_t i = static_cast<std::size_t>(w & 0xFF);
+                std::uint64_t m = w >> 12;
+                accepted = m < inner[i];
+                return static_cast<double>(m) * width[i];
+            }
+        };
+
+        inline const ziggurat_table& normal_ziggurat()
+        {
+            static const ziggurat_table table(3.6541528853610088, 0.00492867323399,
+                                              [](double x) { return std::exp(-0.5 * x * x); },
+                                              [](double y) { return std::sqrt(-2. * std::log(y)); });
+            return table;
+        }
+
+        inline const ziggurat_table& exponential_ziggurat()
+        {
+            static const ziggurat_table table(7.69711747013104972, 0.0039496598225815571993,
+                                              [](double x) { return std::exp(-x); },
+                                              [](double y) { return -std::log(y); });
+            return table;
+        }
+
+        // Standard normal number drawn with the ziggurat from the word w, and
+        // from the next words of e when w is rejected
+        template <class E>
+        inline double standard_normal(E& e, std::uint64_t w)
+        {
+            const ziggurat_table& t = normal_ziggurat();
+            for (;;)
+            {
+                bool accepted;
+                double x = t.candidate(w, accepted);
+                double sign = (w & 0x100) ? -1. : 1.;
+                std::size_t i = static_cast<std::size_t>(w & 0xFF);
+                if (accepted)
+                {
+                    return sign * x;
+                }
+                else if (i == 0)
+                {
+                    double tx, ty;
+                    do
+                    {
+                        tx = -std::log(open_canonical(e)) / t.tail;
+                        ty = -std::log(open_canonical(e));
+                    } while (ty + ty < tx * tx);
+                    return sign * (t.tail + tx);
+                }
+                else if (t.density[i] + canonical_from_bits<double>(random_bits(e)) * (t.density[i + 1] - t.density[i]) < std::exp(-0.5 * x * x))
+                {
+                    return sign * x;
+                }
+                w = random_bits(e);
+            }
+        }
+
+        template <class E>
+        inline double standard_normal(E& e)
+        {
+            std::uint64_t w = random_bits(e);
+            bool accepted;
+            double x = normal_ziggurat().candidate(w, accepted);
+            return accepted ? ((w & 0x100) ? -x : x) : standard_normal(e, w);
+        }
+
+        template <class E>
+        inline double standard_exponential(E& e, std::uint64_t w)
+        {
+            const ziggurat_table& t = exponential_ziggurat();
+            for (;;)
+            {
+                bool accepted;
+                double x = t.candidate(w, accepted);
+                std::size_t i = static_cast<std::size_t>(w & 0xFF);
+                if (accepted)
+                {
+                    return x;
+                }
+                else if (i == 0)
+                {
+                    return t.tail - std::log(open_canonical(e));
+                }
+                else if (t.density[i] + canonical_from_bits<double>(random_bits(e)) * (t.density[i + 1] - t.density[i]) < std::exp(-x))
+                {
+                    return x;
+                }
+                w = random_bits(e);
+            }
+        }
+
+        template <class E>
+        inline double standard_exponential(E& e)
+        {
+            std::uint64_t w = random_bits(e);
+            bool accepted;
+            double x = exponential_ziggurat().candidate(w, accepted);
+            return accepted ? x : standard_exponential(e, w);
+        }
+
+        // Fills [first, last) with a * z + b, where z is drawn with the
+        // ziggurat t from the word returned by word(i) for the element i.
+        // The candidates of a block of words are computed in a loop without
+        // branch, the few rejected ones are drawn again with slow(i, w).
+        // There is no XTENSOR_USE_XSIMD path: the supported xsimd version has
+        // no gather to read the layer tables, so the loop is left to the
+        // auto-vectorizer.
+        template <bool Signed, class It, class T, class W, class F>
+        inline void ziggurat_fill(const ziggurat_table& t, It first, It last, T a, T b, W word, F slow)
+        {
+            constexpr std::size_t block_size = 256;
+            std::array<std::uint64_t, block_size> words;
+            std::array<double, block_size> values;
+            std::array<bool, block_size> accepted;
+            std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+            for (std::size_t offset = 0; offset < size; offset += block_size)
+            {
+                std::size_t n = (std::min)(block_size, size - offset);
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    words[i] = word(offset + i);
+                }
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    bool acc;
+                    double x = t.candidate(words[i], acc);
+                    values[i] = (Signed && (words[i] & 0x100)) ? -x : x;
+                    accepted[i] = acc;
+                }
+                for (std::size_t i = 0; i < n; ++i, ++first)
+                {
+                    double z = accepted[i] ? values[i] : slow(offset + i, words[i]);
+                    *first = a * static_cast<T>(z) + b;
+                }
+            }
+        }
+
+        // log(Gamma(x)) with the Stirling series, which, unlike std::lgamma,
+        // does not write to a global variable
+        inline double log_gamma(double x) noexcept
+        {
+            constexpr double coefficients[10] = {8.333333333333333e-02, -2.777777777777778e-03,
+                                                 7.936507936507937e-04, -5.952380952380952e-04,
+                                                 8.417508417508418e-04, -1.917526917526918e-03,
+                                                 6.410256410256410e-03, -2.955065359477124e-02,
+                                                 1.796443723688307e-01, -1.39243221690590e+00};
+            if (x == 1. || x == 2.)
+            {
+                return 0.;
+            }
+            double n = x < 7. ? std::floor(7. - x) : 0.;
+            double x0 = x + n;
+            double x2 = 1. / (x0 * x0);
+            double series = coefficients[9];
+            for (std::size_t k = 9; k-- > 0;)
+            {
+                series = series * x2 + coefficients[k];
+            }
+            double res = series / x0 + 0.91893853320467274178 + (x0 - 0.5) * std::log(x0) - x0;
+            for (; n > 0.; n -= 1.)
+            {
+                x0 -= 1.;
+                res -= std::log(x0);
+            }
+            return res;
+        }
+
+        // Samplers of the distributions of the standard library, drawing one
+        // number with operator() or filling a range with fill. The generic
+        // one forwards to the distribution.
+        template <class D>
+        class sampler
+        {
+        public:
+
+            using value_type = typename D::result_type;
+
+            explicit sampler(const D& dist)
+                : m_dist(dist)
+            {
+            }
+
+            template <class E>
+            value_type operator()(E& e) const
+            {
+                return m_dist(e);
+            }
+
+            template <class E, class It>
+            void fill(E& e, It first, It last) const
+            {
+                for (; first != last; ++first)
+                {
+                    *first = m_dist(e);
+                }
+            }
+
+        private:
+
+            mutable D m_dist;
+        };
+
+        // Same numbers as std::uniform_real_distribution of libstdc++
+        template <class T>
+        class sampler<std::uniform_real_distribution<T>>
+        {
+        public:
+
+            using value_type = T;
+
+            explicit sampler(const std::uniform_real_distribution<T>& dist)
+                : m_lower(dist.a()), m_range(dist.b() - dist.a())
+            {
+            }
+
+            template <class E>
+            value_type operator()(E& e) const
+            {
+                return canonical_generator<T, E>::generate(e) * m_range + m_lower;
+            }
+
+            template <class E, class It>
+            void fill(E& e, It first, It last) const
+            {
+                for (; first != last; ++first)
+                {
+                    *first = (*this)(e);
+                }
+            }
+
+        private:
+
+            T m_lower;
+            T m_range;
+        };
+
+        // Ziggurat instead of the polar method of the standard library
+        template <class T>
+        class sampler<std::normal_distribution<T>>
+        {
+        public:
+
+            using value_type = T;
+
+            explicit sampler(const std::normal_distribution<T>& dist)
+                : m_mean(dist.mean()), m_stddev(dist.stddev())
+            {
+            }
+
+            template <class E>
+            value_type operator()(E& e) const
+            {
+                return m_stddev * static_cast<T>(standard_normal(e)) + m_mean;
+            }
+
+            template <class E, class It>
+            void fill(E& e, It first, It last) const
+            {
+                ziggurat_fill<true>(normal_ziggurat(), first, last, m_stddev, m_mean,
+                                    [&e](std::size_t) { return random_bits(e); },
+                                    [&e](std::size_t, std::uint64_t w) { return standard_normal(e, w); });
+            }
+
+        private:
+
+            T m_mean;
+            T m_stddev;
+        };
+
+        // Ziggurat instead of the inversion method of the standard library
+        template <class T>
+        class sampler<std::exponential_distribution<T>>
+        {
+        public:
+
+            using value_type = T;
+
+            explicit sampler(const std::exponential_distribution<T>& dist)
+                : m_scale(T(1) / dist.lambda())
+            {
+            }
+
+            template <class E>
+            value_type operator()(E& e) const
+            {
+                return m_scale * static_cast<T>(standard_exponential(e));
+            }
+
+            template <class E, class It>
+            void fill(E& e, It first, It last) const
+            {
+                ziggurat_fill<false>(exponential_ziggurat(), first, last, m_scale, T(0),
+                                     [&e](std::size_t) { return random_bits(e); },
+                                     [&e](std::size_t, std::uint64_t w) { return standard_exponential(e, w); });
+            }
+
+        private:
+
+            T m_scale;
+        };
+
+        // "A simple method for generating gamma variables", Marsaglia and
+        // Tsang (2000), on the ziggurat normal numbers. Shapes below 1 are
+        // boosted to shape + 1.
+        template <class T>
+        class sampler<std::gamma_distribution<T>>
+        {
+        public:
+
+            using value_type = T;
+
+            explicit sampler(const std::gamma_distribution<T>& dist)
+                : m_alpha(static_cast<double>(dist.alpha())), m_beta(static_cast<double>(dist.beta())),
+                  m_d((m_alpha < 1. ? m_alpha + 1. : m_alpha) - 1. / 3.), m_c(1. / std::sqrt(9. * m_d))
+            {
+            }
+
+            template <class E>
+            value_type operator()(E& e) const
+            {
+                double res;
+                for (;;)
+                {
+                    double x, v;
+                    do
+                    {
+                        x = standard_normal(e);
+                        v = 1. + m_c * x;
+                    } while (v <= 0.);
+                    v = v * v * v;
+                    double u = open_canonical(e);
+                    double x2 = x * x;
+                    if (u < 1. - 0.0331 * x2 * x2 || std::log(u) < 0.5 * x2 + m_d * (1. - v + std::log(v)))
+                    {
+                        res = m_d * v;
+                        break;
+                    }
+                }
+                if (m_alpha < 1.)
+                {
+                    res *= std::pow(open_canonical(e), 1. / m_alpha);
+                }
+                return static_cast<T>(res * m_beta);
+            }
+
+            template <class E, class It>
+            void fill(E& e, It first, It last) const
+            {
+                for (; first != last; ++first)
+                {
+                    *first = (*this)(e);
+                }
+            }
+
+        private:
+
+            double m_alpha;
+            double m_beta;
+            double m_d;
+            double m_c;
+        };
+
+        // Multiplication of uniform numbers for means below 10, transformed
+        // rejection ("The transformed rejection method for generating Poisson
+        // random variables", Hörmann, 1993) above.
+        template <class I>
+        class sampler<std::poisson_distribution<I>>
+        {
+        public:
+
+            using value_type = I;
+
+            explicit sampler(const std::poisson_distribution<I>& dist)
+                : m_mean(dist.mean()), m_exp_mean(std::exp(-m_mean)), m_log_mean(std::log(m_mean))
+            {
+                m_b = 0.931 + 2.53 * std::sqrt(m_mean);
+                m_a = -0.059 + 0.02483 * m_b;
+                m_log_inv_alpha = std::log(1.1239 + 1.1328 / (m_b - 3.4));
+                m_vr = 0.9277 - 3.6224 / (m_b - 2.);
+            }
+
+            template <class E>
+            value_type operator()(E& e) const
+            {
+                if (m_mean < 10.)
+                {
+                    I k = 0;
+                    double p = open_canonical(e);
+                    while (p > m_exp_mean)
+                    {
+                        ++k;
+                        p *= open_canonical(e);
+                    }
+                    return k;
+                }
+                for (;;)
+                {
+                    double u = canonical_from_bits<double>(random_bits(e)) - 0.5;
+                    double v = canonical_from_bits<double>(random_bits(e));
+                    double us = 0.5 - std::abs(u);
+                    double k = std::floor((2. * m_a / us + m_b) * u + m_mean + 0.43);
+                    if (us >= 0.07 && v <= m_vr)
+                    {
+                        return static_cast<I>(k);
+                    }
+                    if (k < 0. || (us < 0.013 && v > us))
+                    {
+                        continue;
+                    }
+                    if (std::log(v) + m_log_inv_alpha - std::log(m_a / (us * us) + m_b) <= -m_mean + k * m_log_mean - log_gamma(k + 1.))
+                    {
+                        return static_cast<I>(k);
+                    }
+                }
+            }
+
+            template <class E, class It>
+            void fill(E& e, It first, It last) const
+            {
+                for (; first != last; ++first)
+                {
+                    *first = (*this)(e);
+                }
+            }
+
+        private:
+
+            double m_mean;
+            double m_exp_mean;
+            double m_log_mean;
+            double m_a;
+            double m_b;
+            double m_log_inv_alpha;
+            double m_vr;
+        };
     }
 
+    /**********************
+     * Random expressions *
+     **********************/
+
     namespace detail
     {
         template <class T, class E, class D>
@@ -99,20 +946,20 @@ namespace xt
             using value_type = T;
 
             random_impl(E& engine, D&& dist)
-                : m_engine(engine), m_dist(std::move(dist))
+                : m_engine(engine), m_sampler(dist)
             {
             }
 
             template <class... Args>
             inline value_type operator()(Args...) const
             {
-                return m_dist(m_engine);
+                return m_sampler(m_engine);
             }
 
             template <class It>
             inline value_type element(It, It) const
             {
-                return m_dist(m_engine);
+                return m_sampler(m_engine);
             }
 
             template <class EX>
@@ -120,17 +967,411 @@ namespace xt
             {
                 // Note: we're not going row/col major here
                 auto& ed = e.derived_cast();
-                for (auto&& el : ed.storage())
+                m_sampler.fill(m_engine, ed.storage().begin(), ed.storage().end());
+            }
+
+        private:
+
+            E& m_engine;
+            sampler<D> m_sampler;
+        };
+    }
+
+    // Drawing from a shared engine cannot be done concurrently,
+    // and the result would depend on the evaluation order.
+    template <class T, class E, class D>
+    struct is_parallel_safe<detail::random_impl<T, E, D>> : std::false_type
+    {
+    };
+
+    namespace detail
+    {
+        // Samplers drawing the element of a counter-based expression from its
+        // stream, with operator(), or the elements of consecutive streams
+        // with fill. The generic one runs the sampler of the distribution on a
+        // copy of the engine set on the stream.
+        template <class D>
+        class counter_sampler
+        {
+        public:
+
+            using value_type = typename D::result_type;
+
+            explicit counter_sampler(const D& dist)
+                : m_sampler(dist)
+            {
+            }
+
+            template <class E>
+            value_type operator()(const E& engine, std::uint64_t stream) const
+            {
+                E e = engine;
+                e.set_stream(stream);
+                sampler<D> s = m_sampler;
+                return s(e);
+            }
+
+            template <class E, class It>
+            void fill(const E& engine, std::uint64_t stream, It first, It last) const
+            {
+                for (; first != last; ++first, ++stream)
                 {
-                    el = m_dist(m_engine);
+                    *first = (*this)(engine, stream);
                 }
             }
 
         private:
 
-            E& m_engine;
-            mutable D m_dist;
+            sampler<D> m_sampler;
+        };
+
+        // The blocks of the engine are computed in a loop without branch,
+        // which can be vectorized by the compiler. There is no
+        // XTENSOR_USE_XSIMD path: the supported xsimd version has no 32x32->64
+        // bit multiplication, which the Philox rounds are made of.
+        template <class T>
+        class counter_sampler<std::uniform_real_distribution<T>>
+        {
+        public:
+
+            using value_type = T;
+
+            explicit counter_sampler(const std::uniform_real_distribution<T>& dist)
+                : m_lower(dist.a()), m_range(dist.b() - dist.a())
+            {
+            }
+
+            template <class E>
+            value_type operator()(const E& engine, std::uint64_t stream) const noexcept
+            {
+                return canonical_from_bits<T>(engine.word64(stream, 0)) * m_range + m_lower;
+            }
+
+            template <class E, class It>
+            void fill(const E& engine, std::uint64_t stream, It first, It last) const noexcept
+            {
+                for (; first != last; ++first, ++stream)
+                {
+                    *first = (*this)(engine, stream);
+                }
+            }
+
+        private:
+
+            T m_lower;
+            T m_range;
+        };
+
+        template <class T>
+        class counter_sampler<std::normal_distribution<T>>
+        {
+        public:
+
+            using value_type = T;
+
+            explicit counter_sampler(const std::normal_distribution<T>& dist)
+                : m_mean(dist.mean()), m_stddev(dist.stddev())
+            {
+            }
+
+            template <class E>
+            value_type operator()(const E& engine, std::uint64_t stream) const
+            {
+                E e = engine;
+                e.set_stream(stream);
+                return m_stddev * static_cast<T>(standard_normal(e)) + m_mean;
+            }
+
+            template <class E, class It>
+            void fill(const E& engine, std::uint64_t stream, It first, It last) const
+            {
+                ziggurat_fill<true>(normal_ziggurat(), first, last, m_stddev, m_mean,
+                                    [&engine, stream](std::size_t i) { return engine.word64(stream + i, 0); },
+                                    [&engine, stream](std::size_t i, std::uint64_t) {
+                                        E e = engine;
+                                        e.set_stream(stream + i);
+                                        return standard_normal(e);
+                                    });
+            }
+
+        private:
+
+            T m_mean;
+            T m_stddev;
+        };
+
+        template <class T>
+        class counter_sampler<std::exponential_distribution<T>>
+        {
+        public:
+
+            using value_type = T;
+
+            explicit counter_sampler(const std::exponential_distribution<T>& dist)
+                : m_scale(T(1) / dist.lambda())
+            {
+            }
+
+            template <class E>
+            value_type operator()(const E& engine, std::uint64_t stream) const
+            {
+                E e = engine;
+                e.set_stream(stream);
+                return m_scale * static_cast<T>(standard_exponential(e));
+            }
+
+            template <class E, class It>
+            void fill(const E& engine, std::uint64_t stream, It first, It last) const
+            {
+                ziggurat_fill<false>(exponential_ziggurat(), first, last, m_scale, T(0),
+                                     [&engine, stream](std::size_t i) { return engine.word64(stream + i, 0); },
+                                     [&engine, stream](std::size_t i, std::uint64_t) {
+                                         E e = engine;
+                                         e.set_stream(stream + i);
+                                         return standard_exponential(e);
+                                     });
+            }
+
+        private:
+
+            T m_scale;
+        };
+
+        template <class T, class E, class D>
+        struct counter_random_impl
+        {
+            using value_type = T;
+            using strides_type = svector<std::size_t, 4>;
+
+            template <class S>
+            counter_random_impl(E& engine, const D& dist, const S& shape)
+                : m_engine(engine), m_first_stream(engine.position() == 0 ? engine.stream() : engine.stream() + 1),
+                  m_sampler(dist)
+            {
+                std::size_t dim = static_cast<std::size_t>(std::distance(std::begin(shape), std::end(shape)));
+                m_strides.resize(dim);
+                std::size_t size = 1;
+                auto it = std::end(shape);
+                for (std::size_t d = dim; d-- > 0;)
+                {
+                    m_strides[d] = size;
+                    size *= static_cast<std::size_t>(*--it);
+                }
+                // the next expression drawn from the engine uses the following streams
+                engine.set_stream(m_first_stream + size);
+            }
+
+            template <class... Args>
+            inline value_type operator()(Args... args) const
+            {
+                std::array<std::size_t, sizeof...(Args)> index = {{static_cast<std::size_t>(args)...}};
+                return element(index.cbegin(), index.cend());
+            }
+
+            template <class It>
+            inline value_type element(It first, It last) const
+            {
+                std::size_t dim = m_strides.size();
+                std::size_t n = static_cast<std::size_t>(std::distance(first, last));
+                if (n > dim)
+                {
+                    std::advance(first, static_cast<std::ptrdiff_t>(n - dim));
+                    n = dim;
+                }
+                std::size_t flat_index = 0;
+                for (std::size_t d = dim - n; first != last; ++first, ++d)
+                {
+                    flat_index += static_cast<std::size_t>(*first) * m_strides[d];
+                }
+                return sample(flat_index);
+            }
+
+            template <class EX>
+            inline void assign_to(xexpression<EX>& e) const noexcept
+            {
+                auto& ed = e.derived_cast();
+                if (ed.layout() == layout_type::row_major || ed.dimension() < 2)
+                {
+                    auto* data = ed.data();
+                    std::size_t size = ed.size();
+                    std::size_t grain = use_parallel(size) ? balanced_grain(size) : size;
+                    parallel_for(0, size, grain, [this, data](std::size_t first, std::size_t last) {
+                        m_sampler.fill(m_engine, m_first_stream + first, data + first, data + last);
+                    });
+                }
+                else
+                {
+                    std::size_t i = 0;
+                    auto last = ed.template end<layout_type::row_major>();
+                    for (auto it = ed.template begin<layout_type::row_major>(); it != last; ++it, ++i)
+                    {
+                        *it = sample(i);
+                    }
+                }
+            }
+
+        private:
+
+            inline value_type sample(std::size_t i) const
+            {
+                return static_cast<value_type>(m_sampler(m_engine, m_first_stream + i));
+            }
+
+            E m_engine;
+            std::uint64_t m_first_stream;
+            counter_sampler<D> m_sampler;
+            strides_type m_strides;
         };
+
+        template <class T, class E, class D, class S>
+        inline auto make_random_xgenerator(E& engine, D&& dist, const S& shape, std::false_type /*counter_based*/)
+        {
+            return make_xgenerator(random_impl<T, E, std::decay_t<D>>(engine, std::forward<D>(dist)), shape);
+        }
+
+        template <class T, class E, class D, class S>
+        inline auto make_random_xgenerator(E& engine, D&& dist, const S& shape, std::true_type /*counter_based*/)
+        {
+            return make_xgenerator(counter_random_impl<T, E, std::decay_t<D>>(engine, dist, shape), shape);
+        }
+
+        template <class T, class E, class D, class S>
+        inline auto make_random_xgenerator(E& engine, D&& dist, const S& shape)
+        {
+            return make_random_xgenerator<T>(engine, std::forward<D>(dist), shape, random::is_counter_based_engine<E>());
+        }
+    }
+
+    /***************************************
+     * counter_based_engine implementation *
+     ***************************************/
+
+    namespace random
+    {
+        /**
+         * Builds an engine seeded with @p s, drawing its numbers from @p stream.
+         */
+        template <class B>
+        inline counter_based_engine<B>::counter_based_engine(seed_type s, std::uint64_t stream) noexcept
+            : m_key(B::make_key(s)), m_stream(stream), m_position(0), m_block(), m_word(block_size)
+        {
+        }
+
+        /**
+         * Seeds the engine with @p s, and sets its counter to the beginning of the first stream.
+         */
+        template <class B>
+        inline void counter_based_engine<B>::seed(seed_type s) noexcept
+        {
+            m_key = B::make_key(s);
+            set_stream(0);
+        }
+
+        /**
+         * Draws the next number of the current stream.
+         */
+        template <class B>
+        inline auto counter_based_engine<B>::operator()() noexcept -> result_type
+        {
+            if (m_word == block_size)
+            {
+                m_block = block(m_stream, m_position++);
+                m_word = 0;
+            }
+            return m_block[m_word++];
+        }
+
+        /**
+         * Skips the @p n next numbers of the current stream.
+         */
+        template <class B>
+        inline void counter_based_engine<B>::discard(unsigned long long n) noexcept
+        {
+            unsigned long long available = block_size - m_word;
+            if (n <= available)
+            {
+                m_word += static_cast<std::size_t>(n);
+                return;
+            }
+            n -= available;
+            m_position += n / block_size;
+            m_block = block(m_stream, m_position++);
+            m_word = static_cast<std::size_t>(n % block_size);
+        }
+
+        /**
+         * Returns the current stream of the engine.
+         */
+        template <class B>
+        inline std::uint64_t counter_based_engine<B>::stream() const noexcept
+        {
+            return m_stream;
+        }
+
+        /**
+         * Sets the counter of the engine to the beginning of @p stream.
+         */
+        template <class B>
+        inline void counter_based_engine<B>::set_stream(std::uint64_t stream) noexcept
+        {
+            m_stream = stream;
+            m_position = 0;
+            m_word = block_size;
+        }
+
+        /**
+         * Returns the number of blocks drawn from the current stream.
+         */
+        template <class B>
+        inline std::uint64_t counter_based_engine<B>::position() const noexcept
+        {
+            return m_position;
+        }
+
+        /**
+         * Returns the block at @p position in @p stream. It only depends on the seed
+         * of the engine, and not on its current counter.
+         */
+        template <class B>
+        inline auto counter_based_engine<B>::block(std::uint64_t stream, std::uint64_t position) const noexcept -> block_type
+        {
+            return B::apply(B::make_counter(stream, position), m_key);
+        }
+
+        /**
+         * Returns the 64-bit word at index @p i in @p stream.
+         */
+        template <class B>
+        inline std::uint64_t counter_based_engine<B>::word64(std::uint64_t stream, std::size_t i) const noexcept
+        {
+            constexpr std::size_t words_per_block = sizeof(block_type) / sizeof(std::uint64_t);
+            return B::word64(block(stream, i / words_per_block), i % words_per_block);
+        }
+
+        template <class B>
+        inline constexpr auto counter_based_engine<B>::min() noexcept -> result_type
+        {
+            return (std::numeric_limits<result_type>::min)();
+        }
+
+        template <class B>
+        inline constexpr auto counter_based_engine<B>::max() noexcept -> result_type
+        {
+            return (std::numeric_limits<result_type>::max)();
+        }
+
+        template <class B>
+        inline bool operator==(const counter_based_engine<B>& lhs, const counter_based_engine<B>& rhs) noexcept
+        {
+            return lhs.m_key == rhs.m_key && lhs.m_stream == rhs.m_stream &&
+                lhs.m_position == rhs.m_position && lhs.m_word == rhs.m_word;
+        }
+
+        template <class B>
+        inline bool operator!=(const counter_based_engine<B>& lhs, const counter_based_engine<B>& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
     }
 
     namespace random
@@ -157,7 +1398,11 @@ namespace xt
          * xexpression with specified @p shape containing uniformly distributed random numbers
          * in the interval from @p lower to @p upper, excluding upper.
          *
-         * Numbers are drawn from @c std::uniform_real_distribution.
+         * Numbers are drawn as by @c std::uniform_real_distribution of
+         * libstdc++; with other standard libraries, the numbers obtained for
+         * a given seed may differ from the ones of their distribution.
+         * With a counter_based_engine, the value of each element only depends
+         * on the seed of the engine and on its flat index.
          *
          * @param shape shape of resulting xexpression
          * @param lower lower bound
@@ -169,7 +1414,7 @@ namespace xt
         inline auto rand(const S& shape, T lower, T upper, E& engine)
         {
             std::uniform_real_distribution<T> dist(lower, upper);
-            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
         }
 
         /**
@@ -177,6 +1422,8 @@ namespace xt
          * random integers in the interval from @p lower to @p upper, excluding upper.
          *
          * Numbers are drawn from @c std::uniform_int_distribution.
+         * With a counter_based_engine, the value of each element only depends
+         * on the seed of the engine and on its flat index.
          *
          * @param shape shape of resulting xexpression
          * @param lower lower bound
@@ -188,7 +1435,7 @@ namespace xt
         inline auto randint(const S& shape, T lower, T upper, E& engine)
         {
             std::uniform_int_distribution<T> dist(lower, T(upper - 1));
-            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
         }
 
         /**
@@ -196,7 +1443,10 @@ namespace xt
          * the Normal (Gaussian) random number distribution with mean @p mean and
          * standard deviation @p std_dev.
          *
-         * Numbers are drawn from @c std::normal_distribution.
+         * Numbers are drawn with the ziggurat method, instead of the method of
+         * @c std::normal_distribution.
+         * With a counter_based_engine, the value of each element only depends
+         * on the seed of the engine and on its flat index.
          *
          * @param shape shape of resulting xexpression
          * @param mean mean of normal distribution
@@ -208,7 +1458,69 @@ namespace xt
         inline auto randn(const S& shape, T mean, T std_dev, E& engine)
         {
             std::normal_distribution<T> dist(mean, std_dev);
-            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
+        }
+
+        /**
+         * xexpression with specified @p shape containing numbers sampled from
+         * the exponential distribution with the given @p rate.
+         *
+         * Numbers are drawn with the ziggurat method.
+         * With a counter_based_engine, the value of each element only depends
+         * on the seed of the engine and on its flat index.
+         *
+         * @param shape shape of resulting xexpression
+         * @param rate rate (inverse of the mean) of the exponential distribution
+         * @param engine random number engine
+         * @tparam T number type to use
+         */
+        template <class T, class S, class E>
+        inline auto exponential(const S& shape, T rate, E& engine)
+        {
+            std::exponential_distribution<T> dist(rate);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
+        }
+
+        /**
+         * xexpression with specified @p shape containing numbers sampled from
+         * the gamma distribution with shape @p alpha and scale @p beta.
+         *
+         * Numbers are drawn with the method of Marsaglia and Tsang.
+         * With a counter_based_engine, the value of each element only depends
+         * on the seed of the engine and on its flat index.
+         *
+         * @param shape shape of resulting xexpression
+         * @param alpha shape parameter of the gamma distribution
+         * @param beta scale parameter of the gamma distribution
+         * @param engine random number engine
+         * @tparam T number type to use
+         */
+        template <class T, class S, class E>
+        inline auto gamma(const S& shape, T alpha, T beta, E& engine)
+        {
+            std::gamma_distribution<T> dist(alpha, beta);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
+        }
+
+        /**
+         * xexpression with specified @p shape containing integers sampled from
+         * the Poisson distribution with the given @p mean.
+         *
+         * Numbers are drawn by multiplying uniform numbers for means below 10,
+         * and with the transformed rejection method above.
+         * With a counter_based_engine, the value of each element only depends
+         * on the seed of the engine and on its flat index.
+         *
+         * @param shape shape of resulting xexpression
+         * @param mean mean of the Poisson distribution
+         * @param engine random number engine
+         * @tparam T integer type to use
+         */
+        template <class T, class S, class E>
+        inline auto poisson(const S& shape, double mean, E& engine)
+        {
+            std::poisson_distribution<T> dist(mean);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
         }
 
 #ifdef X_OLD_CLANG
@@ -216,42 +1528,84 @@ namespace xt
         inline auto rand(std::initializer_list<I> shape, T lower, T upper, E& engine)
         {
             std::uniform_real_distribution<T> dist(lower, upper);
-            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
         }
 
         template <class T, class I, class E>
         inline auto randint(std::initializer_list<I> shape, T lower, T upper, E& engine)
         {
             std::uniform_int_distribution<T> dist(lower, T(upper - 1));
-            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
         }
 
         template <class T, class I, class E>
         inline auto randn(std::initializer_list<I> shape, T mean, T std_dev, E& engine)
         {
             std::normal_distribution<T> dist(mean, std_dev);
-            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
+        }
+
+        template <class T, class I, class E>
+        inline auto exponential(std::initializer_list<I> shape, T rate, E& engine)
+        {
+            std::exponential_distribution<T> dist(rate);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
+        }
+
+        template <class T, class I, class E>
+        inline auto gamma(std::initializer_list<I> shape, T alpha, T beta, E& engine)
+        {
+            std::gamma_distribution<T> dist(alpha, beta);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
+        }
+
+        template <class T, class I, class E>
+        inline auto poisson(std::initializer_list<I> shape, double mean, E& engine)
+        {
+            std::poisson_distribution<T> dist(mean);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
         }
 #else
         template <class T, class I, std::size_t L, class E>
         inline auto rand(const I (&shape)[L], T lower, T upper, E& engine)
         {
             std::uniform_real_distribution<T> dist(lower, upper);
-            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
         }
 
         template <class T, class I, std::size_t L, class E>
         inline auto randint(const I (&shape)[L], T lower, T upper, E& engine)
         {
             std::uniform_int_distribution<T> dist(lower, T(upper - 1));
-            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
         }
 
         template <class T, class I, std::size_t L, class E>
         inline auto randn(const I (&shape)[L], T mean, T std_dev, E& engine)
         {
             std::normal_distribution<T> dist(mean, std_dev);
-            return detail::make_xgenerator(detail::random_impl<T, E, decltype(dist)>(engine, std::move(dist)), shape);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto exponential(const I (&shape)[L], T rate, E& engine)
+        {
+            std::exponential_distribution<T> dist(rate);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto gamma(const I (&shape)[L], T alpha, T beta, E& engine)
+        {
+            std::gamma_distribution<T> dist(alpha, beta);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
+        }
+
+        template <class T, class I, std::size_t L, class E>
+        inline auto poisson(const I (&shape)[L], double mean, E& engine)
+        {
+            std::poisson_distribution<T> dist(mean);
+            return detail::make_random_xgenerator<T>(engine, std::move(dist), shape);
         }
 #endif
 
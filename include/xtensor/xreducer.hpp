@@ -11,8 +11,10 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <numeric>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
@@ -29,7 +31,10 @@
 #include "xexpression.hpp"
 #include "xgenerator.hpp"
 #include "xiterable.hpp"
+#include "xparallel.hpp"
 #include "xreducer.hpp"
+#include "xstorage.hpp"
+#include "xtensor_simd.hpp"
 #include "xutils.hpp"
 
 namespace xt
@@ -86,6 +91,342 @@ namespace xt
         using type = xtensor_fixed<result_type, typename fixed_xreducer_shape_type<fixed_shape<I...>, fixed_shape<X...>>::type, L>;
     };
 
+    /***********************
+     * simd_reducer_traits *
+     ***********************/
+
+    /**
+     * Traits class providing the batch counterpart of a functor used in a
+     * reduction. Specializations derive from std::true_type and define a
+     * static apply method taking the functor followed by one batch (init
+     * functors) or two batches (reduce and merge functors). Reductions whose
+     * functors all provide such a counterpart are computed with vectorized
+     * kernels on contiguous data when XTENSOR_USE_XSIMD is defined.
+     */
+    template <class F>
+    struct simd_reducer_traits : std::false_type
+    {
+    };
+
+    namespace detail
+    {
+        // Base of the simd_reducer_traits specializations for functors
+        // providing their batch counterpart as a simd_apply method.
+        template <class F>
+        struct simd_apply_reducer_traits : std::true_type
+        {
+            template <class... B>
+            static auto apply(const F& f, const B&... b)
+            {
+                return f.simd_apply(b...);
+            }
+        };
+    }
+
+    template <>
+    struct simd_reducer_traits<xtl::identity> : std::true_type
+    {
+        template <class B>
+        static B apply(const xtl::identity&, const B& b)
+        {
+            return b;
+        }
+    };
+
+    template <class T>
+    struct simd_reducer_traits<std::plus<T>> : std::true_type
+    {
+        template <class B>
+        static B apply(const std::plus<T>&, const B& lhs, const B& rhs)
+        {
+            return lhs + rhs;
+        }
+    };
+
+    template <class T>
+    struct simd_reducer_traits<std::multiplies<T>> : std::true_type
+    {
+        template <class B>
+        static B apply(const std::multiplies<T>&, const B& lhs, const B& rhs)
+        {
+            return lhs * rhs;
+        }
+    };
+
+    namespace detail
+    {
+        /**************************
+         * simd reduction kernels *
+         **************************/
+
+        template <class R, class T, class... F>
+        using use_simd_reduce = xtl::conjunction<std::is_same<R, T>,
+                                                 std::is_arithmetic<T>,
+                                                 std::integral_constant<bool, (xsimd::simd_traits<T>::size > 1)>,
+                                                 simd_reducer_traits<F>...>;
+
+        // number of independent accumulators, hiding the latency of the reduce functor
+        constexpr std::size_t simd_reduce_accumulators = 4;
+
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_impl(const T* first, std::size_t size, const RF& reduce_fct,
+                                        const IF& init_fct, const MF& /*merge_fct*/, std::false_type)
+        {
+            R tmp = init_fct(*first);
+            return std::accumulate(first + 1, first + size, tmp, reduce_fct);
+        }
+
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous_impl(const T* first, std::size_t size, const RF& reduce_fct,
+                                        const IF& init_fct, const MF& merge_fct, std::true_type)
+        {
+            using batch_type = xsimd::simd_type<T>;
+            constexpr std::size_t simd_size = xsimd::simd_traits<T>::size;
+            constexpr std::size_t n_acc = simd_reduce_accumulators;
+            constexpr std::size_t block_size = n_acc * simd_size;
+
+            if (size < block_size)
+            {
+                return reduce_contiguous_impl<R>(first, size, reduce_fct, init_fct, merge_fct, std::false_type());
+            }
+
+            batch_type acc[n_acc];
+            for (std::size_t k = 0; k < n_acc; ++k)
+            {
+                acc[k] = simd_reducer_traits<IF>::apply(init_fct, xsimd::load_simd<T, T>(first + k * simd_size, unaligned_mode()));
+            }
+            std::size_t i = block_size;
+            for (; i + block_size <= size; i += block_size)
+            {
+                for (std::size_t k = 0; k < n_acc; ++k)
+                {
+                    acc[k] = simd_reducer_traits<RF>::apply(reduce_fct, acc[k],
+                                                            xsimd::load_simd<T, T>(first + i + k * simd_size, unaligned_mode()));
+                }
+            }
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                acc[0] = simd_reducer_traits<RF>::apply(reduce_fct, acc[0], xsimd::load_simd<T, T>(first + i, unaligned_mode()));
+            }
+            for (std::size_t k = 1; k < n_acc; ++k)
+            {
+                acc[0] = simd_reducer_traits<MF>::apply(merge_fct, acc[0], acc[k]);
+            }
+
+            // horizontal merge of the lanes
+            T lanes[simd_size];
+            xsimd::store_simd<T, T>(lanes, acc[0], unaligned_mode());
+            R res = lanes[0];
+            for (std::size_t k = 1; k < simd_size; ++k)
+            {
+                res = merge_fct(res, lanes[k]);
+            }
+            for (; i < size; ++i)
+            {
+                res = reduce_fct(res, first[i]);
+            }
+            return res;
+        }
+
+        /**
+         * Reduces the \c size (> 0) contiguous elements starting at \c first,
+         * with a vectorized kernel when the functors allow it.
+         */
+        template <class R, class T, class RF, class IF, class MF>
+        inline R reduce_contiguous(const T* first, std::size_t size, const RF& reduce_fct,
+                                   const IF& init_fct, const MF& merge_fct)
+        {
+            return reduce_contiguous_impl<R>(first, size, reduce_fct, init_fct, merge_fct,
+                                             use_simd_reduce<R, T, RF, IF, MF>());
+        }
+
+        template <class R, class T, class IF>
+        inline void init_row_impl(R* out, const T* in, std::size_t size, const IF& init_fct, std::false_type)
+        {
+            std::transform(in, in + size, out, [&init_fct](const T& v) { return static_cast<R>(init_fct(v)); });
+        }
+
+        template <class R, class T, class IF>
+        inline void init_row_impl(R* out, const T* in, std::size_t size, const IF& init_fct, std::true_type)
+        {
+            constexpr std::size_t simd_size = xsimd::simd_traits<T>::size;
+            std::size_t i = 0;
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                auto b = simd_reducer_traits<IF>::apply(init_fct, xsimd::load_simd<T, T>(in + i, unaligned_mode()));
+                xsimd::store_simd<R, R>(out + i, b, unaligned_mode());
+            }
+            for (; i < size; ++i)
+            {
+                out[i] = static_cast<R>(init_fct(in[i]));
+            }
+        }
+
+        template <class R, class T, class RF>
+        inline void reduce_row_impl(R* out, const T* in, std::size_t size, const RF& reduce_fct, std::false_type)
+        {
+            std::transform(out, out + size, in, out, reduce_fct);
+        }
+
+        template <class R, class T, class RF>
+        inline void reduce_row_impl(R* out, const T* in, std::size_t size, const RF& reduce_fct, std::true_type)
+        {
+            constexpr std::size_t simd_size = xsimd::simd_traits<T>::size;
+            std::size_t i = 0;
+            for (; i + simd_size <= size; i += simd_size)
+            {
+                auto b = simd_reducer_traits<RF>::apply(reduce_fct,
+                                                        xsimd::load_simd<R, R>(out + i, unaligned_mode()),
+                                                        xsimd::load_simd<T, T>(in + i, unaligned_mode()));
+                xsimd::store_simd<R, R>(out + i, b, unaligned_mode());
+            }
+            for (; i < size; ++i)
+            {
+                out[i] = reduce_fct(out[i], in[i]);
+            }
+        }
+
+        /**
+         * Initializes the \c size elements of \c out with the init functor
+         * applied to the contiguous elements of \c in.
+         */
+        template <class R, class T, class IF>
+        inline void init_row(R* out, const T* in, std::size_t size, const IF& init_fct)
+        {
+            init_row_impl(out, in, size, init_fct, use_simd_reduce<R, T, IF>());
+        }
+
+        /**
+         * Reduces elementwise the \c size elements of \c out with the
+         * contiguous elements of \c in.
+         */
+        template <class R, class T, class RF>
+        inline void reduce_row(R* out, const T* in, std::size_t size, const RF& reduce_fct)
+        {
+            reduce_row_impl(out, in, size, reduce_fct, use_simd_reduce<R, T, RF>());
+        }
+    }
+
+    namespace detail
+    {
+        /**
+         * Reduces the \c size elements starting at \c first by splitting them
+         * into chunks reduced concurrently. Partial results are combined in
+         * order with the merge functor.
+         */
+        template <class R, class T, class RF, class IF, class MF>
+        inline R parallel_reduce_all(const T* first, std::size_t size, const RF& reduce_fct,
+                                     const IF& init_fct, const MF& merge_fct)
+        {
+            std::size_t grain = std::max(cache_chunk_size<R>(), balanced_grain(size));
+            uvector<R> partials((size + grain - 1) / grain);
+            parallel_for(0, size, grain, [&](std::size_t chunk_first, std::size_t chunk_last)
+            {
+                partials[chunk_first / grain] = reduce_contiguous<R>(first + chunk_first, chunk_last - chunk_first,
+                                                                     reduce_fct, init_fct, merge_fct);
+            });
+            return std::accumulate(partials.begin() + 1, partials.end(), partials[0], merge_fct);
+        }
+
+        /**
+         * Parallel counterpart of the axis wise loops of reduce_immediate. The input
+         * is made of contiguous blocks of outer_loop_size * inner_loop_size elements,
+         * iterated over by iter_shape; iter_strides hold the result strides of the kept
+         * dimensions and 0 for the reduced ones. The kept output indices (and chunks of
+         * the inner loop when there are few of them) are distributed among threads,
+         * each of them visiting its reduced blocks in the same order as the serial loop.
+         */
+        template <class R, class T, class RF, class IF, class MF>
+        inline void parallel_reduce_axes(R* out, const T* in,
+                                         const dynamic_shape<std::size_t>& iter_shape,
+                                         const dynamic_shape<std::size_t>& iter_strides,
+                                         std::size_t outer_loop_size, std::size_t inner_loop_size,
+                                         const RF& reduce_fct, const IF& init_fct, const MF& merge_fct)
+        {
+            // splits iterated dimensions into kept and reduced ones, innermost first
+            dynamic_shape<std::size_t> kept_shape, kept_in, kept_out, red_shape, red_in;
+            std::size_t in_stride = outer_loop_size * inner_loop_size;
+            for (std::size_t i = iter_shape.size(); i > 0; --i)
+            {
+                if (iter_strides[i - 1] != 0)
+                {
+                    kept_shape.push_back(iter_shape[i - 1]);
+                    kept_in.push_back(in_stride);
+                    kept_out.push_back(iter_strides[i - 1]);
+                }
+                else
+                {
+                    red_shape.push_back(iter_shape[i - 1]);
+                    red_in.push_back(in_stride);
+                }
+                in_stride *= iter_shape[i - 1];
+            }
+            std::size_t n_out = std::accumulate(kept_shape.cbegin(), kept_shape.cend(), std::size_t(1), std::multiplies<std::size_t>());
+            std::size_t n_red = std::accumulate(red_shape.cbegin(), red_shape.cend(), std::size_t(1), std::multiplies<std::size_t>());
+
+            std::size_t col_chunk = std::min(cache_chunk_size<R>(),
+                                             n_out < num_threads() ? balanced_grain(inner_loop_size) : inner_loop_size);
+            std::size_t n_col = (inner_loop_size + col_chunk - 1) / col_chunk;
+            std::size_t n_tasks = n_out * n_col;
+
+            parallel_for(0, n_tasks, balanced_grain(n_tasks), [&](std::size_t first, std::size_t last)
+            {
+                dynamic_shape<std::size_t> red_idx(red_shape.size());
+                for (std::size_t t = first; t < last; ++t)
+                {
+                    std::size_t o = t / n_col;
+                    std::size_t col_first = (t % n_col) * col_chunk;
+                    std::size_t col_size = std::min(col_chunk, inner_loop_size - col_first);
+                    const T* block = in + col_first;
+                    R* res = out + col_first;
+                    for (std::size_t j = 0; j < kept_shape.size(); ++j)
+                    {
+                        std::size_t k = o % kept_shape[j];
+                        o /= kept_shape[j];
+                        block += k * kept_in[j];
+                        res += k * kept_out[j];
+                    }
+                    std::fill(red_idx.begin(), red_idx.end(), std::size_t(0));
+                    for (std::size_t r = 0; r < n_red; ++r)
+                    {
+                        if (inner_loop_size == 1)
+                        {
+                            R tmp = reduce_contiguous<R>(block, outer_loop_size, reduce_fct, init_fct, merge_fct);
+                            *res = r != 0 ? merge_fct(*res, tmp) : tmp;
+                        }
+                        else
+                        {
+                            const T* row = block;
+                            std::size_t i = 0;
+                            if (r == 0)
+                            {
+                                init_row(res, row, col_size, init_fct);
+                                row += inner_loop_size;
+                                ++i;
+                            }
+                            for (; i < outer_loop_size; ++i)
+                            {
+                                reduce_row(res, row, col_size, reduce_fct);
+                                row += inner_loop_size;
+                            }
+                        }
+
+                        for (std::size_t j = 0; j < red_shape.size(); ++j)
+                        {
+                            if (++red_idx[j] != red_shape[j])
+                            {
+                                block += red_in[j];
+                                break;
+                            }
+                            red_idx[j] = 0;
+                            block -= (red_shape[j] - 1) * red_in[j];
+                        }
+                    }
+                }
+            });
+        }
+    }
+
     template <class F, class E, class X>
     inline auto reduce_immediate(F&& f, E&& e, X&& axes)
     {
@@ -125,10 +466,16 @@ namespace xt
         // Fast track for complete reduction
         if (e.dimension() == axes.size())
         {
-            auto begin = e.storage().begin();
-            result_type tmp = init_fct(*begin);
-            ++begin;
-            result.data()[0] = std::accumulate(begin, e.storage().end(), tmp, reduce_fct);
+            if (detail::use_parallel(e.size()))
+            {
+                result.data()[0] = detail::parallel_reduce_all<result_type>(e.data(), e.size(),
+                                                                            reduce_fct, init_fct, merge_fct);
+            }
+            else
+            {
+                result.data()[0] = detail::reduce_contiguous<result_type>(e.data(), e.size(),
+                                                                          reduce_fct, init_fct, merge_fct);
+            }
             return result;
         }
 
@@ -209,6 +556,13 @@ namespace xt
             throw std::runtime_error("Layout not supported in immediate reduction.");
         }
 
+        if (detail::use_parallel(e.size()))
+        {
+            detail::parallel_reduce_axes(result.data(), e.data(), iter_shape, iter_strides,
+                                         outer_loop_size, inner_loop_size, reduce_fct, init_fct, merge_fct);
+            return result;
+        }
+
         xindex temp_idx(iter_shape.size());
         auto next_idx = [&iter_shape, &iter_strides, &temp_idx]() {
             std::size_t i = iter_shape.size();
@@ -251,11 +605,10 @@ namespace xt
         {
             while (idx_res.first != true)
             {
-                // for unknown reasons it's much faster to use a temporary variable and
-                // std::accumulate here -- probably some cache behavior
-                result_type tmp;
-                tmp = init_fct(*begin);
-                tmp = std::accumulate(begin + 1, begin + outer_loop_size, tmp, reduce_fct);
+                // for unknown reasons it's much faster to use a temporary variable
+                // here -- probably some cache behavior
+                result_type tmp = detail::reduce_contiguous<result_type>(begin, outer_loop_size,
+                                                                         reduce_fct, init_fct, merge_fct);
 
                 // use merge function if necessary
                 *out = merge ? merge_fct(*out, tmp) : tmp;
@@ -282,18 +635,19 @@ namespace xt
         {
             while (idx_res.first != true)
             {
-                std::transform(out, out + inner_loop_size, begin, out,
-                               [merge, &init_fct, &reduce_fct](auto&& v1, auto&& v2) {
-                                    return merge ?
-                                        reduce_fct(v1, v2) :
-                                        // cast because return type of identity function is not upcasted
-                                        static_cast<result_type>(init_fct(v2));
-                               });
+                if (merge)
+                {
+                    detail::reduce_row(out, begin, inner_loop_size, reduce_fct);
+                }
+                else
+                {
+                    detail::init_row(out, begin, inner_loop_size, init_fct);
+                }
 
                 begin += inner_stride;
                 for (std::size_t i = 1; i < outer_loop_size; ++i)
                 {
-                    std::transform(out, out + inner_loop_size, begin, out, reduce_fct);
+                    detail::reduce_row(out, begin, inner_loop_size, reduce_fct);
                     begin += inner_stride;
                 }
 
@@ -626,6 +980,15 @@ namespace xt
         using substepper_type = typename xexpression_type::const_stepper;
         using shape_type = typename xreducer_type::shape_type;
 
+        using use_contiguous_kernel = xtl::conjunction<has_data_interface<xexpression_type>,
+                                                       has_strides<xexpression_type>,
+                                                       std::is_lvalue_reference<decltype(*std::declval<substepper_type>())>,
+                                                       detail::use_simd_reduce<value_type,
+                                                                               typename xexpression_type::value_type,
+                                                                               typename xreducer_type::reduce_functor_type,
+                                                                               typename xreducer_type::init_functor_type,
+                                                                               typename xreducer_type::merge_functor_type>>;
+
         xreducer_stepper(const xreducer_type& red, size_type offset, bool end = false,
                          layout_type l = default_assignable_layout(xexpression_type::static_layout));
 
@@ -644,6 +1007,11 @@ namespace xt
     private:
 
         reference aggregate(size_type dim) const;
+        reference aggregate_impl(substepper_type& stepper, size_type dim, size_type size) const;
+        reference aggregate_inner(substepper_type& stepper, size_type index, size_type size, std::false_type) const;
+        reference aggregate_inner(substepper_type& stepper, size_type index, size_type size, std::true_type) const;
+        reference aggregate_parallel(size_type dim) const;
+        size_type reduced_size(size_type dim) const noexcept;
 
         substepper_type get_substepper_begin() const;
         size_type get_dim(size_type dim) const noexcept;
@@ -1129,33 +1497,111 @@ namespace xt
         {
             res = m_reducer->m_init(*m_stepper);
         }
+        else if (is_parallel_safe<xexpression_type>::value && detail::use_parallel(reduced_size(dim)))
+        {
+            res = aggregate_parallel(dim);
+        }
         else
         {
             size_type index = axis(dim);
-            size_type size = shape(index);
-            if (dim != m_reducer->m_axes.size() - 1)
-            {
-                res = aggregate(dim + 1);
-                for (size_type i = 1; i != size; ++i)
-                {
-                    m_stepper.step(index);
-                    res = m_reducer->m_merge(res, aggregate(dim + 1));
-                }
-            }
-            else
+            res = aggregate_impl(m_stepper, dim, shape(index));
+            m_stepper.reset(index);
+        }
+        return res;
+    }
+
+    // Aggregates the first size elements along axis(dim) and all the
+    // elements along the following reduced axes, leaving stepper on the
+    // last element visited along axis(dim).
+    template <class F, class CT, class X>
+    inline auto xreducer_stepper<F, CT, X>::aggregate_impl(substepper_type& stepper, size_type dim, size_type size) const -> reference
+    {
+        reference res;
+        size_type index = axis(dim);
+        if (dim != m_reducer->m_axes.size() - 1)
+        {
+            size_type next_index = axis(dim + 1);
+            size_type next_size = shape(next_index);
+            res = aggregate_impl(stepper, dim + 1, next_size);
+            stepper.reset(next_index);
+            for (size_type i = 1; i != size; ++i)
             {
-                res = m_reducer->m_init(*m_stepper);
-                for (size_type i = 1; i != size; ++i)
-                {
-                    m_stepper.step(index);
-                    res = m_reducer->m_reduce(res, *m_stepper);
-                }
+                stepper.step(index);
+                res = m_reducer->m_merge(res, aggregate_impl(stepper, dim + 1, next_size));
+                stepper.reset(next_index);
             }
-            m_stepper.reset(index);
+        }
+        else
+        {
+            res = aggregate_inner(stepper, index, size, use_contiguous_kernel());
+        }
+        return res;
+    }
+
+    template <class F, class CT, class X>
+    inline auto xreducer_stepper<F, CT, X>::aggregate_inner(substepper_type& stepper, size_type index,
+                                                            size_type size, std::false_type) const -> reference
+    {
+        reference res = m_reducer->m_init(*stepper);
+        for (size_type i = 1; i != size; ++i)
+        {
+            stepper.step(index);
+            res = m_reducer->m_reduce(res, *stepper);
         }
         return res;
     }
 
+    // The innermost reduced axis of a container is processed with the
+    // vectorized kernel when it is contiguous in memory.
+    template <class F, class CT, class X>
+    inline auto xreducer_stepper<F, CT, X>::aggregate_inner(substepper_type& stepper, size_type index,
+                                                            size_type size, std::true_type) const -> reference
+    {
+        if (size == 1 || m_reducer->m_e.strides()[index] != 1)
+        {
+            return aggregate_inner(stepper, index, size, std::false_type());
+        }
+        reference res = detail::reduce_contiguous<value_type>(&(*stepper), size, m_reducer->m_reduce,
+                                                              m_reducer->m_init, m_reducer->m_merge);
+        stepper.step(index, size - 1);
+        return res;
+    }
+
+    // Splits axis(dim) into chunks aggregated concurrently on copies of the
+    // underlying stepper; partial results are combined in order with the
+    // merge functor.
+    template <class F, class CT, class X>
+    inline auto xreducer_stepper<F, CT, X>::aggregate_parallel(size_type dim) const -> reference
+    {
+        size_type index = axis(dim);
+        size_type size = shape(index);
+        size_type grain = detail::balanced_grain(size);
+        uvector<value_type> partials((size + grain - 1) / grain);
+        parallel_for(0, size, grain, [this, &partials, dim, index, grain](size_type first, size_type last)
+        {
+            substepper_type stepper = m_stepper;
+            stepper.step(index, first);
+            partials[first / grain] = aggregate_impl(stepper, dim, last - first);
+        });
+        reference res = partials[0];
+        for (size_type i = 1; i != partials.size(); ++i)
+        {
+            res = m_reducer->m_merge(res, partials[i]);
+        }
+        return res;
+    }
+
+    template <class F, class CT, class X>
+    inline auto xreducer_stepper<F, CT, X>::reduced_size(size_type dim) const noexcept -> size_type
+    {
+        size_type size = 1;
+        for (size_type i = dim; i != m_reducer->m_axes.size(); ++i)
+        {
+            size *= shape(axis(i));
+        }
+        return size;
+    }
+
     template <class F, class CT, class X>
     inline auto xreducer_stepper<F, CT, X>::get_substepper_begin() const -> substepper_type
     {
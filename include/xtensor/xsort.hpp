@@ -10,16 +10,40 @@
 #define XTENSOR_SORT_HPP
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "xarray.hpp"
 #include "xeval.hpp"
+#include "xreducer.hpp"
 #include "xslice.hpp"  // for xnone
 #include "xmanipulation.hpp"
+#include "xnoalias.hpp"
+#include "xparallel.hpp"
+#include "xstorage.hpp"
+#include "xstrided_view.hpp"
 #include "xtensor.hpp"
 
 namespace xt
 {
+    /**
+     * Sorting algorithm used by argsort. ``quick`` does not preserve the
+     * relative order of equal elements, ``stable`` does.
+     */
+    enum class sorting_method
+    {
+        quick,
+        stable
+    };
+
     namespace detail
     {
         constexpr std::size_t normalize_axis(std::ptrdiff_t axis, std::size_t dim)
@@ -27,92 +51,101 @@ namespace xt
             return axis >= 0 ? static_cast<std::size_t>(axis) : static_cast<std::size_t>(static_cast<std::ptrdiff_t>(dim) + axis);
         }
 
-        template <class E, class F>
-        inline void call_over_leading_axis(E& ev, F&& fct)
+        // Shape of the lanes of e along axis, seen as an (outer, size, inner)
+        // array in memory order: the element k of the lane (o, i) is stored
+        // at o * size * inner + k * inner + i.
+        template <class E>
+        inline std::array<std::size_t, 3> lanes_shape(const E& e, std::size_t axis)
         {
-            std::size_t n_iters = 1;
-            std::ptrdiff_t secondary_stride;
-            if (ev.layout() == layout_type::row_major)
+            auto ax = e.shape().cbegin() + std::ptrdiff_t(axis);
+            std::size_t before = std::accumulate(e.shape().cbegin(), ax, std::size_t(1), std::multiplies<>());
+            std::size_t after = std::accumulate(ax + 1, e.shape().cend(), std::size_t(1), std::multiplies<>());
+            if (e.layout() == layout_type::row_major)
             {
-                n_iters = std::accumulate(ev.shape().begin(), ev.shape().end() - 1,
-                                          std::size_t(1), std::multiplies<>());
-                secondary_stride = static_cast<std::ptrdiff_t>(ev.strides()[ev.dimension() - 2]);
+                return {{before, *ax, after}};
             }
-            else
+            else if (e.layout() == layout_type::column_major)
             {
-                n_iters = std::accumulate(ev.shape().begin() + 1, ev.shape().end(),
-                                          std::size_t(1), std::multiplies<>());
-                secondary_stride = static_cast<std::ptrdiff_t>(ev.strides()[1]);
+                return {{after, *ax, before}};
             }
+            throw std::runtime_error("Layout not supported.");
+        }
 
-            std::ptrdiff_t offset = 0;
+        // Number of strided lanes gathered at once in a buffer, so that
+        // reading them walks contiguous rows instead of one element per row.
+        template <class T>
+        inline std::size_t lanes_block_size(std::size_t size, std::size_t inner)
+        {
+            std::size_t n = detail::cache_chunk_size<T>() / std::max(size, std::size_t(1));
+            return std::max(std::size_t(1), std::min(n, inner));
+        }
 
-            for (std::size_t i = 0; i < n_iters; ++i, offset += secondary_stride)
+        template <class T>
+        inline void gather_lanes(const T* src, std::size_t size, std::size_t inner, std::size_t n, T* dst)
+        {
+            for (std::size_t k = 0; k < size; ++k, src += inner)
             {
-                size_t adj_secondary_stride = static_cast<size_t>((std::max)(secondary_stride, std::ptrdiff_t(1)));
-                fct(ev.data() + offset, ev.data() + offset + adj_secondary_stride);
+                for (std::size_t b = 0; b < n; ++b)
+                {
+                    dst[b * size + k] = src[b];
+                }
             }
         }
 
-        template <class E>
-        inline std::size_t leading_axis(const E& e)
+        template <class T>
+        inline void scatter_lanes(const T* src, std::size_t size, std::size_t inner, std::size_t n, T* dst)
         {
-            if (e.layout() == layout_type::row_major)
-            {
-                return e.dimension() - 1;
-            }
-            else if (e.layout() == layout_type::column_major)
+            for (std::size_t k = 0; k < size; ++k, dst += inner)
             {
-                return 0;
+                for (std::size_t b = 0; b < n; ++b)
+                {
+                    dst[b] = src[b * size + k];
+                }
             }
-            throw std::runtime_error("Layout not supported.");
         }
 
-        // get permutations to transpose and reverse-transpose array
-        inline std::pair<dynamic_shape<std::size_t>, dynamic_shape<std::size_t>>
-        get_permutations(std::size_t dim, std::size_t ax, layout_type layout)
+        // Calls fct(begin, end) on each lane of ev along axis, in place.
+        // Strided lanes are gathered in a small buffer and scattered back.
+        template <class E, class F>
+        inline void call_over_axis(E& ev, std::size_t axis, F&& fct)
         {
-            dynamic_shape<std::size_t> permutation(dim);
-            std::iota(permutation.begin(), permutation.end(), std::size_t(0));
-            permutation.erase(permutation.begin() + std::ptrdiff_t(ax));
+            using value_type = typename E::value_type;
 
-            if (layout == layout_type::row_major)
-            {
-                permutation.push_back(ax);
-            }
-            else
+            auto ls = lanes_shape(ev, axis);
+            std::size_t outer = ls[0], size = ls[1], inner = ls[2];
+            value_type* data = ev.data();
+
+            if (inner == 1)
             {
-                permutation.insert(permutation.begin(), ax);
+                for (std::size_t o = 0; o < outer; ++o, data += size)
+                {
+                    fct(data, data + size);
+                }
+                return;
             }
 
-            // TODO find a more clever way to get reverse permutation?
-            dynamic_shape<std::size_t> reverse_permutation;
-            for (std::size_t i = 0; i < dim; ++i)
+            std::size_t block = lanes_block_size<value_type>(size, inner);
+            uvector<value_type> buffer(block * size);
+            for (std::size_t o = 0; o < outer; ++o, data += size * inner)
             {
-                auto it = std::find(permutation.begin(), permutation.end(), i);
-                reverse_permutation.push_back(std::size_t(std::distance(permutation.begin(), it)));
+                for (std::size_t i = 0; i < inner; i += block)
+                {
+                    std::size_t n = std::min(block, inner - i);
+                    gather_lanes<value_type>(data + i, size, inner, n, buffer.data());
+                    for (std::size_t b = 0; b < n; ++b)
+                    {
+                        fct(buffer.data() + b * size, buffer.data() + (b + 1) * size);
+                    }
+                    scatter_lanes<value_type>(buffer.data(), size, inner, n, data + i);
+                }
             }
-
-            return std::make_pair(std::move(permutation), std::move(reverse_permutation));
         }
 
         template <class E, class R, class F>
-        inline auto run_lambda_over_axis(const E& e, R& res, std::size_t axis, F&& lambda)
+        inline void run_lambda_over_axis(const E& e, R& res, std::size_t axis, F&& lambda)
         {
-            if (axis != detail::leading_axis(res))
-            {
-                dynamic_shape<std::size_t> permutation, reverse_permutation;
-                std::tie(permutation, reverse_permutation) = get_permutations(e.dimension(), axis, e.layout());
-
-                res = transpose(e, permutation);
-                detail::call_over_leading_axis(res, std::forward<F>(lambda));
-                res = transpose(res, reverse_permutation);
-            }
-            else
-            {
-                res = e;
-                detail::call_over_leading_axis(res, std::forward<F>(lambda));
-            }
+            res = e;
+            detail::call_over_axis(res, axis, std::forward<F>(lambda));
         }
 
         template <class VT>
@@ -134,6 +167,287 @@ namespace xt
         };
 
 
+        /*************************
+         * parallel sort kernels *
+         *************************/
+
+        // Maps arithmetic values to unsigned keys having the same order,
+        // so that they can be sorted digit by digit.
+        template <class T, class = void>
+        struct radix_traits : std::false_type
+        {
+        };
+
+        template <class T>
+        struct radix_traits<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>>
+            : std::true_type
+        {
+            using key_type = std::make_unsigned_t<T>;
+
+            static key_type key(T v) noexcept
+            {
+                constexpr key_type sign_mask = std::is_signed<T>::value ? key_type(key_type(1) << (8 * sizeof(T) - 1)) : key_type(0);
+                return key_type(static_cast<key_type>(v) ^ sign_mask);
+            }
+        };
+
+        template <class T, class K>
+        struct radix_floating_traits : std::true_type
+        {
+            using key_type = K;
+
+            static key_type key(T v) noexcept
+            {
+                constexpr key_type sign_mask = key_type(1) << (8 * sizeof(K) - 1);
+                // -0 and +0 compare equal and must get the same key
+                key_type bits = 0;
+                if (v != T(0))
+                {
+                    std::memcpy(&bits, &v, sizeof(K));
+                }
+                return (bits & sign_mask) ? key_type(~bits) : key_type(bits | sign_mask);
+            }
+        };
+
+        template <>
+        struct radix_traits<float> : radix_floating_traits<float, std::uint32_t>
+        {
+        };
+
+        template <>
+        struct radix_traits<double> : radix_floating_traits<double, std::uint64_t>
+        {
+        };
+
+        // Stable LSD radix sort of values, one byte per pass, moving indices
+        // along with the values when indices is not null. Each pass counts
+        // the digits of every chunk in parallel, then scatters the chunks in
+        // parallel at their offsets. Passes where all the values share the
+        // same digit are skipped.
+        template <class T, class I>
+        inline void parallel_radix_sort(T* values, I* indices, std::size_t n)
+        {
+            using traits = radix_traits<T>;
+            using key_type = typename traits::key_type;
+            constexpr std::size_t radix_bits = 8;
+            constexpr std::size_t n_buckets = std::size_t(1) << radix_bits;
+
+            std::size_t grain = balanced_grain(n);
+            std::size_t n_chunks = (n + grain - 1) / grain;
+            uvector<std::size_t> offsets(n_chunks * n_buckets);
+            uvector<T> value_buffer(n);
+            uvector<I> index_buffer(indices != nullptr ? n : std::size_t(0));
+
+            T* src = values;
+            T* dst = value_buffer.data();
+            I* index_src = indices;
+            I* index_dst = index_buffer.data();
+
+            for (std::size_t shift = 0; shift < 8 * sizeof(key_type); shift += radix_bits)
+            {
+                auto digit = [shift](const T& v) {
+                    return static_cast<std::size_t>(traits::key(v) >> shift) & (n_buckets - 1);
+                };
+
+                parallel_for(0, n, grain, [&](std::size_t first, std::size_t last) {
+                    std::size_t* count = offsets.data() + (first / grain) * n_buckets;
+                    std::fill(count, count + n_buckets, std::size_t(0));
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        ++count[digit(src[i])];
+                    }
+                });
+
+                bool skip = false;
+                std::size_t total = 0;
+                for (std::size_t d = 0; d < n_buckets && !skip; ++d)
+                {
+                    std::size_t bucket_first = total;
+                    for (std::size_t c = 0; c < n_chunks; ++c)
+                    {
+                        std::size_t count = offsets[c * n_buckets + d];
+                        offsets[c * n_buckets + d] = total;
+                        total += count;
+                    }
+                    skip = (total - bucket_first == n);
+                }
+                if (skip)
+                {
+                    continue;
+                }
+
+                parallel_for(0, n, grain, [&](std::size_t first, std::size_t last) {
+                    std::size_t* offset = offsets.data() + (first / grain) * n_buckets;
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        std::size_t pos = offset[digit(src[i])]++;
+                        dst[pos] = src[i];
+                        if (index_src != nullptr)
+                        {
+                            index_dst[pos] = index_src[i];
+                        }
+                    }
+                });
+                std::swap(src, dst);
+                std::swap(index_src, index_dst);
+            }
+
+            if (src != values)
+            {
+                parallel_for(0, n, grain, [&](std::size_t first, std::size_t last) {
+                    std::copy(src + first, src + last, values + first);
+                    if (indices != nullptr)
+                    {
+                        std::copy(index_src + first, index_src + last, indices + first);
+                    }
+                });
+            }
+        }
+
+        // Returns the number of elements taken from [a, a + na) in the
+        // first d elements of the stable merge of [a, a + na) and
+        // [b, b + nb).
+        template <class T, class Compare>
+        inline std::size_t merge_split(const T* a, std::size_t na, const T* b, std::size_t nb,
+                                       std::size_t d, Compare& comp)
+        {
+            std::size_t lo = d > nb ? d - nb : std::size_t(0);
+            std::size_t hi = std::min(d, na);
+            while (lo < hi)
+            {
+                std::size_t i = lo + (hi - lo) / 2;
+                std::size_t j = d - i;
+                if (j > 0 && !comp(b[j - 1], a[i]))
+                {
+                    lo = i + 1;
+                }
+                else
+                {
+                    hi = i;
+                }
+            }
+            return lo;
+        }
+
+        // Stable merge of [a, a + na) and [b, b + nb) into out, each thread
+        // producing a slice of the output.
+        template <class T, class Compare>
+        inline void parallel_merge(const T* a, std::size_t na, const T* b, std::size_t nb, T* out, Compare& comp)
+        {
+            std::size_t n = na + nb;
+            std::size_t grain = std::max(cache_chunk_size<T>(), balanced_grain(n));
+            parallel_for(0, n, grain, [&](std::size_t first, std::size_t last) {
+                std::size_t ia = merge_split(a, na, b, nb, first, comp);
+                std::size_t ja = merge_split(a, na, b, nb, last, comp);
+                std::merge(a + ia, a + ja, b + (first - ia), b + (last - ja), out + first, comp);
+            });
+        }
+
+        // Sorts one run per thread, then merges the runs pairwise.
+        template <class T, class Compare>
+        inline void parallel_merge_sort(T* first, std::size_t n, Compare comp, bool stable)
+        {
+            std::size_t width = (n + num_threads() - 1) / num_threads();
+            parallel_for(0, n, width, [&](std::size_t run_first, std::size_t run_last) {
+                if (stable)
+                {
+                    std::stable_sort(first + run_first, first + run_last, comp);
+                }
+                else
+                {
+                    std::sort(first + run_first, first + run_last, comp);
+                }
+            });
+
+            uvector<T> buffer(n);
+            T* src = first;
+            T* dst = buffer.data();
+            for (; width < n; width *= 2)
+            {
+                for (std::size_t lo = 0; lo < n; lo += 2 * width)
+                {
+                    std::size_t mid = std::min(lo + width, n);
+                    std::size_t hi = std::min(lo + 2 * width, n);
+                    parallel_merge(src + lo, mid - lo, src + mid, hi - mid, dst + lo, comp);
+                }
+                std::swap(src, dst);
+            }
+
+            if (src != first)
+            {
+                parallel_for(0, n, cache_chunk_size<T>(), [&](std::size_t chunk_first, std::size_t chunk_last) {
+                    std::copy(src + chunk_first, src + chunk_last, first + chunk_first);
+                });
+            }
+        }
+
+        template <class T>
+        inline void parallel_sort_values(T* first, std::size_t n, std::true_type /*radix*/)
+        {
+            parallel_radix_sort(first, static_cast<std::size_t*>(nullptr), n);
+        }
+
+        template <class T>
+        inline void parallel_sort_values(T* first, std::size_t n, std::false_type /*radix*/)
+        {
+            parallel_merge_sort(first, n, std::less<T>(), false);
+        }
+
+        // Sorts the n values starting at first in ascending order.
+        template <class T>
+        inline void sort_values(T* first, std::size_t n)
+        {
+            if (use_parallel(n))
+            {
+                parallel_sort_values(first, n, radix_traits<T>());
+            }
+            else
+            {
+                std::sort(first, first + n);
+            }
+        }
+
+        template <class T, class I>
+        inline void parallel_argsort_values(T* values, I* inds, std::size_t n, bool /*stable*/, std::true_type /*radix*/)
+        {
+            parallel_radix_sort(values, inds, n);
+        }
+
+        template <class T, class I>
+        inline void parallel_argsort_values(T* values, I* inds, std::size_t n, bool stable, std::false_type /*radix*/)
+        {
+            auto comp = [values](I x, I y) { return values[x] < values[y]; };
+            parallel_merge_sort(inds, n, comp, stable);
+        }
+
+        // Fills inds with the indices that sort the n values starting at
+        // values. The values may be reordered.
+        template <class T, class I>
+        inline void argsort_values(T* values, I* inds, std::size_t n, sorting_method method)
+        {
+            bool stable = method == sorting_method::stable;
+            if (use_parallel(n))
+            {
+                parallel_for(0, n, cache_chunk_size<I>(), [inds](std::size_t first, std::size_t last) {
+                    std::iota(inds + first, inds + last, static_cast<I>(first));
+                });
+                parallel_argsort_values(values, inds, n, stable, radix_traits<T>());
+            }
+            else
+            {
+                std::iota(inds, inds + n, I(0));
+                auto comp = [values](I x, I y) { return values[x] < values[y]; };
+                if (stable)
+                {
+                    std::stable_sort(inds, inds + n, comp);
+                }
+                else
+                {
+                    std::sort(inds, inds + n, comp);
+                }
+            }
+        }
+
         template <class E, class R = typename flatten_sort_result_type<E>::type>
         inline auto flat_sort_impl(const xexpression<E>& e)
         {
@@ -142,7 +456,7 @@ namespace xt
             ev.resize({de.size()});
 
             std::copy(de.cbegin(), de.cend(), ev.begin());
-            std::sort(ev.begin(), ev.end());
+            sort_values(ev.data(), ev.size());
 
             return ev;
         }
@@ -171,7 +485,9 @@ namespace xt
 
     /**
      * Sort xexpression (optionally along axis)
-     * The sort is performed using the ``std::sort`` functions.
+     * The sort is performed using the ``std::sort`` functions. Large 1-D
+     * arrays are sorted in parallel when a parallel backend is enabled,
+     * with a radix sort for integral and floating point values.
      * A copy of the xexpression is created and returned.
      *
      * @param e xexpression to sort
@@ -256,65 +572,142 @@ namespace xt
                                                             typename T::temporary_type>::type;
         };
 
-        template <class Ed, class Ei>
-        inline void argsort_over_leading_axis(const Ed& data, Ei& inds)
+        // Fills inds with the indices of each lane of data along axis, then
+        // calls fct(begin, end, comp) on them, comp comparing the elements of
+        // the lane at the given indices. data and inds have the same shape and
+        // layout.
+        template <class Ed, class Ei, class F>
+        inline void argfunc_over_axis_impl(const Ed& data, Ei& inds, std::size_t axis, F&& fct)
         {
-            std::size_t n_iters = 1;
-            std::ptrdiff_t data_secondary_stride;
-            std::ptrdiff_t inds_secondary_stride;
-            if (data.layout() == layout_type::row_major)
-            {
-                n_iters = std::accumulate(data.shape().begin(), data.shape().end() - 1,
-                                          std::size_t(1), std::multiplies<>());
-                data_secondary_stride = static_cast<std::ptrdiff_t>(data.strides()[data.dimension() - 2]);
-                inds_secondary_stride = static_cast<std::ptrdiff_t>(inds.strides()[inds.dimension() - 2]);
-            }
-            else
+            using value_type = typename Ed::value_type;
+            using index_type = typename Ei::value_type;
+
+            auto ls = lanes_shape(data, axis);
+            std::size_t outer = ls[0], size = ls[1], inner = ls[2];
+            const value_type* src = data.data();
+            index_type* dst = inds.data();
+
+            if (inner == 1)
             {
-                n_iters = std::accumulate(data.shape().begin() + 1, data.shape().end(),
-                                          std::size_t(1), std::multiplies<>());
-                data_secondary_stride = static_cast<std::ptrdiff_t>(data.strides()[1]);
-                inds_secondary_stride = static_cast<std::ptrdiff_t>(inds.strides()[1]);
+                for (std::size_t o = 0; o < outer; ++o, src += size, dst += size)
+                {
+                    auto comp = [src](std::size_t x, std::size_t y) { return src[x] < src[y]; };
+                    std::iota(dst, dst + size, index_type(0));
+                    fct(dst, dst + size, comp);
+                }
+                return;
             }
 
-            std::ptrdiff_t data_offset = 0;
-            std::ptrdiff_t inds_offset = 0;
-
-            for (std::size_t i = 0; i < n_iters; ++i, data_offset += data_secondary_stride,
-                    inds_offset += inds_secondary_stride)
+            std::size_t block = lanes_block_size<value_type>(size, inner);
+            uvector<value_type> values(block * size);
+            uvector<index_type> indices(block * size);
+            for (std::size_t o = 0; o < outer; ++o, src += size * inner, dst += size * inner)
             {
-                auto comp = [&data, &data_offset](std::size_t x, std::size_t y) {
-                    return (*(data.data() + data_offset + x) <
-                            *(data.data() + data_offset + y));
-                };
-                std::iota(inds.data() + inds_offset, inds.data() + inds_offset + inds_secondary_stride, 0);
-                std::sort(inds.data() + inds_offset, inds.data() + inds_offset + inds_secondary_stride, comp);
+                for (std::size_t i = 0; i < inner; i += block)
+                {
+                    std::size_t n = std::min(block, inner - i);
+                    gather_lanes<value_type>(src + i, size, inner, n, values.data());
+                    for (std::size_t b = 0; b < n; ++b)
+                    {
+                        const value_type* lane = values.data() + b * size;
+                        auto comp = [lane](std::size_t x, std::size_t y) { return lane[x] < lane[y]; };
+                        index_type* lane_inds = indices.data() + b * size;
+                        std::iota(lane_inds, lane_inds + size, index_type(0));
+                        fct(lane_inds, lane_inds + size, comp);
+                    }
+                    scatter_lanes<index_type>(indices.data(), size, inner, n, dst + i);
+                }
             }
         }
 
-        template <class E, class R = typename detail::linear_argsort_result_type<E>::type>
-        inline auto flatten_argsort_impl(const xexpression<E>& e)
+        template <class R, class E, class F>
+        inline R flatten_argfunc_impl(const xexpression<E>& e, F&& fct)
         {
-            using result_type = R;
+            using value_type = typename E::value_type;
 
             const auto& de = e.derived_cast();
+            uvector<value_type> values(de.size());
+            std::copy(de.cbegin(), de.cend(), values.begin());
 
-            result_type result;
+            R result;
             result.resize({de.size()});
-            auto comp = [&de](std::size_t x, std::size_t y) {
-                return de[x] < de[y];
+            const value_type* data = values.data();
+            auto comp = [data](std::size_t x, std::size_t y) {
+                return data[x] < data[y];
             };
             std::iota(result.begin(), result.end(), 0);
-            std::sort(result.begin(), result.end(), comp);
+            fct(result.begin(), result.end(), comp);
 
             return result;
         }
+
+        template <class E, class R = typename detail::linear_argsort_result_type<E>::type>
+        inline auto flatten_argsort_impl(const xexpression<E>& e, sorting_method method = sorting_method::quick)
+        {
+            using value_type = typename E::value_type;
+
+            const auto& de = e.derived_cast();
+            uvector<value_type> values(de.size());
+            std::copy(de.cbegin(), de.cend(), values.begin());
+
+            R result;
+            result.resize({de.size()});
+            argsort_values(values.data(), result.data(), values.size(), method);
+            return result;
+        }
+
+        template <class It, class Compare>
+        inline void sort_indices(It first, It last, Compare comp, sorting_method method)
+        {
+            if (method == sorting_method::stable)
+            {
+                std::stable_sort(first, last, comp);
+            }
+            else
+            {
+                std::sort(first, last, comp);
+            }
+        }
+
+        // Runs fct(begin, end, comp) on the indices of each lane of de along
+        // axis, comp comparing the elements of the lane at given indices.
+        template <class R, class E, class F>
+        inline R argfunc_over_axis(const E& de, std::size_t ax, F&& fct)
+        {
+            auto&& ev = eval(de);
+            R res = R::from_shape(ev.shape());
+            if (ev.layout() == res.layout())
+            {
+                detail::argfunc_over_axis_impl(ev, res, ax, std::forward<F>(fct));
+            }
+            else
+            {
+                // The indices are computed in the memory order of the data
+                xarray<typename R::value_type, layout_type::dynamic> inds;
+                inds.resize(ev.shape(), ev.layout());
+                detail::argfunc_over_axis_impl(ev, inds, ax, std::forward<F>(fct));
+                res = inds;
+            }
+            return res;
+        }
     }
 
+    /**
+     * Argsort the flattened xexpression. Returns a 1-D array of the indices
+     * that sort the flattened xexpression. Large arrays are sorted in
+     * parallel when a parallel backend is enabled.
+     *
+     * @param e xexpression to argsort
+     * @param method the sorting algorithm, sorting_method::stable keeps
+     * equal elements in their original order
+     *
+     * @return argsorted index array
+     */
     template <class E>
-    inline auto argsort(const xexpression<E>& e, placeholders::xtuph /*t*/)
+    inline auto argsort(const xexpression<E>& e, placeholders::xtuph /*t*/,
+                        sorting_method method = sorting_method::quick)
     {
-        return detail::flatten_argsort_impl(e);
+        return detail::flatten_argsort_impl(e, method);
     }
 
     /**
@@ -325,11 +718,14 @@ namespace xt
      *
      * @param e xexpression to argsort
      * @param axis axis along which argsort is performed
+     * @param method the sorting algorithm, sorting_method::stable keeps
+     * equal elements in their original order
      *
      * @return argsorted index array
      */
     template <class E>
-    inline auto argsort(const xexpression<E>& e, std::ptrdiff_t axis = -1)
+    inline auto argsort(const xexpression<E>& e, std::ptrdiff_t axis = -1,
+                        sorting_method method = sorting_method::quick)
     {
         using eval_type = typename detail::sort_eval_type<E>::type;
         using result_type = typename detail::argsort_result_type<eval_type>::type;
@@ -340,26 +736,399 @@ namespace xt
 
         if (de.dimension() == 1)
         {
-            return detail::flatten_argsort_impl<E, result_type>(e);
+            return detail::flatten_argsort_impl<E, result_type>(e, method);
+        }
+
+        return detail::argfunc_over_axis<result_type>(de, ax, [method](auto begin, auto end, auto comp) {
+            detail::sort_indices(begin, end, comp, method);
+        });
+    }
+
+    /************************************
+     * partition and quantile functions *
+     ************************************/
+
+    namespace detail
+    {
+        template <class E>
+        using flatten_partition_result_type = typename flatten_sort_result_type<typename sort_eval_type<E>::type>::type;
+
+        template <class C>
+        inline std::vector<std::size_t> sorted_kth(const C& kth_container, std::size_t size)
+        {
+            std::vector<std::size_t> kth(kth_container.begin(), kth_container.end());
+            std::sort(kth.begin(), kth.end());
+            if (kth.empty() || kth.back() >= size)
+            {
+                throw std::runtime_error("Partition index out of bounds.");
+            }
+            return kth;
+        }
+
+        // Partially sorts [first, last) so that the elements at the (sorted)
+        // kth positions are the ones that would be there in a sorted range,
+        // smaller elements being before them and greater elements after.
+        template <class It, class Compare>
+        inline void multi_nth_element(It first, It last, const std::vector<std::size_t>& kth, Compare comp)
+        {
+            for (auto it = kth.crbegin(); it != kth.crend(); ++it)
+            {
+                It nth = first + static_cast<std::ptrdiff_t>(*it);
+                std::nth_element(first, nth, last, comp);
+                last = nth;
+            }
+        }
+
+        template <class It>
+        inline void multi_nth_element(It first, It last, const std::vector<std::size_t>& kth)
+        {
+            multi_nth_element(first, last, kth, std::less<>());
+        }
+
+        template <class R, class E, class C>
+        inline R flat_partition_impl(const xexpression<E>& e, const C& kth_container)
+        {
+            const auto& de = e.derived_cast();
+            R ev;
+            ev.resize({de.size()});
+            std::copy(de.cbegin(), de.cend(), ev.begin());
+            multi_nth_element(ev.begin(), ev.end(), sorted_kth(kth_container, ev.size()));
+            return ev;
+        }
+
+        // Position of the lower and upper order statistics interpolated by
+        // the linear method for the quantile p of n samples.
+        inline std::pair<std::size_t, std::size_t> quantile_bounds(double p, std::size_t n, double& frac)
+        {
+            if (!(p >= 0. && p <= 1.))
+            {
+                throw std::runtime_error("Quantiles should be in the range [0, 1].");
+            }
+            double h = p * static_cast<double>(n - 1);
+            double lo = std::floor(h);
+            frac = h - lo;
+            std::size_t ilo = static_cast<std::size_t>(lo);
+            return std::make_pair(ilo, (std::min)(ilo + 1, n - 1));
+        }
+
+        template <class P>
+        inline std::vector<std::size_t> quantile_kth(const P& probas, std::size_t n)
+        {
+            std::vector<std::size_t> kth;
+            double frac;
+            for (const auto& p : probas)
+            {
+                auto bounds = quantile_bounds(static_cast<double>(p), n, frac);
+                kth.push_back(bounds.first);
+                kth.push_back(bounds.second);
+            }
+            return kth;
+        }
+
+        // Writes the quantile p of the partitioned values along axis ax in out.
+        template <class T, class V, class R>
+        inline void assign_quantile(const V& values, std::size_t ax, double p, R&& out)
+        {
+            double frac;
+            auto bounds = quantile_bounds(p, values.shape()[ax], frac);
+            xstrided_slice_vector sv(values.dimension(), all());
+            sv[ax] = static_cast<std::ptrdiff_t>(bounds.first);
+            auto lo = strided_view(values, sv);
+            sv[ax] = static_cast<std::ptrdiff_t>(bounds.second);
+            auto hi = strided_view(values, sv);
+            noalias(out) = xt::cast<T>(lo) + static_cast<T>(frac) * (xt::cast<T>(hi) - xt::cast<T>(lo));
+        }
+
+        template <class E>
+        inline auto shape_without_axis(const E& e, std::size_t ax, std::size_t leading = 0)
+        {
+            std::vector<std::size_t> shape(leading);
+            std::copy(e.shape().cbegin(), e.shape().cbegin() + std::ptrdiff_t(ax), std::back_inserter(shape));
+            std::copy(e.shape().cbegin() + std::ptrdiff_t(ax) + 1, e.shape().cend(), std::back_inserter(shape));
+            return shape;
+        }
+    }
+
+    /**
+     * Partially sorts the flattened xexpression. The elements at the positions
+     * given in \c kth_container are the ones that would be there in the sorted
+     * array, all the elements before them are smaller and all the elements
+     * after them are greater. The selection runs in linear time per index.
+     *
+     * @param e xexpression to partition
+     * @param kth_container the positions of the elements in sorted position
+     *
+     * @return partitioned 1-D array (copy)
+     */
+    template <class E, class C, class = std::enable_if_t<!std::is_integral<C>::value, int>>
+    inline auto partition(const xexpression<E>& e, const C& kth_container, placeholders::xtuph /*t*/)
+    {
+        return detail::flat_partition_impl<detail::flatten_partition_result_type<E>>(e, kth_container);
+    }
+
+    template <class E>
+    inline auto partition(const xexpression<E>& e, std::size_t kth, placeholders::xtuph t)
+    {
+        return partition(e, std::array<std::size_t, 1>({kth}), t);
+    }
+
+    /**
+     * Partially sorts xexpression along axis. In each lane along \c axis, the
+     * elements at the positions given in \c kth_container are the ones that
+     * would be there in the sorted lane, all the elements before them are
+     * smaller and all the elements after them are greater. The selection runs
+     * in linear time per index.
+     *
+     * @param e xexpression to partition
+     * @param kth_container the positions of the elements in sorted position
+     * @param axis axis along which partition is performed
+     *
+     * @return partitioned array (copy)
+     */
+    template <class E, class C, class = std::enable_if_t<!std::is_integral<C>::value, int>>
+    inline auto partition(const xexpression<E>& e, const C& kth_container, std::ptrdiff_t axis = -1)
+    {
+        using eval_type = typename detail::sort_eval_type<E>::type;
+
+        const auto& de = e.derived_cast();
+
+        if (de.dimension() == 1)
+        {
+            return detail::flat_partition_impl<eval_type>(de, kth_container);
+        }
+
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+        auto kth = detail::sorted_kth(kth_container, de.shape()[ax]);
+
+        eval_type res;
+        detail::run_lambda_over_axis(de, res, ax, [&kth](auto begin, auto end) { detail::multi_nth_element(begin, end, kth); });
+        return res;
+    }
+
+    template <class E>
+    inline auto partition(const xexpression<E>& e, std::size_t kth, std::ptrdiff_t axis = -1)
+    {
+        return partition(e, std::array<std::size_t, 1>({kth}), axis);
+    }
+
+    /**
+     * Indirect partition of the flattened xexpression. Returns the indices
+     * that would partition the flattened array (see partition).
+     *
+     * @param e xexpression to argpartition
+     * @param kth_container the positions of the elements in sorted position
+     *
+     * @return 1-D index array
+     */
+    template <class E, class C, class = std::enable_if_t<!std::is_integral<C>::value, int>>
+    inline auto argpartition(const xexpression<E>& e, const C& kth_container, placeholders::xtuph /*t*/)
+    {
+        using result_type = typename detail::linear_argsort_result_type<typename detail::sort_eval_type<E>::type>::type;
+
+        auto kth = detail::sorted_kth(kth_container, e.derived_cast().size());
+        return detail::flatten_argfunc_impl<result_type>(e, [&kth](auto begin, auto end, auto comp) {
+            detail::multi_nth_element(begin, end, kth, comp);
+        });
+    }
+
+    template <class E>
+    inline auto argpartition(const xexpression<E>& e, std::size_t kth, placeholders::xtuph t)
+    {
+        return argpartition(e, std::array<std::size_t, 1>({kth}), t);
+    }
+
+    /**
+     * Indirect partition of xexpression along axis. Returns an array of indices
+     * of the same shape as e that index data along the given axis in
+     * partitioned order (see partition).
+     *
+     * @param e xexpression to argpartition
+     * @param kth_container the positions of the elements in sorted position
+     * @param axis axis along which argpartition is performed
+     *
+     * @return index array
+     */
+    template <class E, class C, class = std::enable_if_t<!std::is_integral<C>::value, int>>
+    inline auto argpartition(const xexpression<E>& e, const C& kth_container, std::ptrdiff_t axis = -1)
+    {
+        using eval_type = typename detail::sort_eval_type<E>::type;
+        using result_type = typename detail::argsort_result_type<eval_type>::type;
+
+        const auto& de = e.derived_cast();
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+        auto kth = detail::sorted_kth(kth_container, de.shape()[ax]);
+        auto fct = [&kth](auto begin, auto end, auto comp) { detail::multi_nth_element(begin, end, kth, comp); };
+
+        if (de.dimension() == 1)
+        {
+            return detail::flatten_argfunc_impl<result_type>(e, fct);
+        }
+        return detail::argfunc_over_axis<result_type>(de, ax, fct);
+    }
+
+    template <class E>
+    inline auto argpartition(const xexpression<E>& e, std::size_t kth, std::ptrdiff_t axis = -1)
+    {
+        return argpartition(e, std::array<std::size_t, 1>({kth}), axis);
+    }
+
+    /**
+     * Computes the quantiles of the flattened xexpression, linearly
+     * interpolating between order statistics (the default method of NumPy).
+     * The order statistics are found by partitioning, in linear time.
+     *
+     * @param e xexpression
+     * @param probas the quantiles to compute, in the range [0, 1]
+     *
+     * @return 1-D array with one element per quantile
+     */
+    template <class T = double, class E, class P>
+    inline auto quantile(const xexpression<E>& e, const P& probas)
+    {
+        const auto& de = e.derived_cast();
+        std::size_t n = de.size();
+        if (n == 0)
+        {
+            throw std::runtime_error("Cannot compute the quantiles of an empty array.");
         }
+        auto values = partition(e, detail::quantile_kth(probas, n), xnone());
 
-        if (ax != detail::leading_axis(de))
+        std::size_t n_probas = static_cast<std::size_t>(std::distance(probas.begin(), probas.end()));
+        xtensor<T, 1> res = xtensor<T, 1>::from_shape({n_probas});
+        auto out = res.begin();
+        double frac;
+        for (const auto& p : probas)
         {
-            dynamic_shape<std::size_t> permutation, reverse_permutation;
-            std::tie(permutation, reverse_permutation) = detail::get_permutations(de.dimension(), ax, de.layout());
+            auto bounds = detail::quantile_bounds(static_cast<double>(p), n, frac);
+            T lo = static_cast<T>(values[bounds.first]);
+            T hi = static_cast<T>(values[bounds.second]);
+            *out++ = lo + static_cast<T>(frac) * (hi - lo);
+        }
+        return res;
+    }
 
-            eval_type ev = transpose(de, permutation);
-            result_type res = result_type::from_shape(ev.shape());
-            detail::argsort_over_leading_axis(ev, res);
-            res = transpose(res, reverse_permutation);
-            return res;
+    /**
+     * Computes the quantiles of xexpression along axis, linearly interpolating
+     * between order statistics (the default method of NumPy). The order
+     * statistics are found by partitioning, in linear time per lane.
+     *
+     * @param e xexpression
+     * @param probas the quantiles to compute, in the range [0, 1]
+     * @param axis axis along which the quantiles are computed
+     *
+     * @return array whose first dimension indexes the quantiles, the
+     * remaining ones being the dimensions of e except \c axis.
+     */
+    template <class T = double, class E, class P>
+    inline auto quantile(const xexpression<E>& e, const P& probas, std::ptrdiff_t axis)
+    {
+        using eval_type = typename detail::sort_eval_type<E>::type;
+        using result_type = typename detail::rebind_value_type<T, eval_type>::type;
+
+        const auto& de = e.derived_cast();
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+        if (de.shape()[ax] == 0)
+        {
+            throw std::runtime_error("Cannot compute the quantiles of an empty array.");
         }
-        else
+        auto values = partition(e, detail::quantile_kth(probas, de.shape()[ax]), axis);
+
+        std::size_t n_probas = static_cast<std::size_t>(std::distance(probas.begin(), probas.end()));
+        auto shape = detail::shape_without_axis(de, ax, 1);
+        shape[0] = n_probas;
+        result_type res = result_type::from_shape(shape);
+
+        xstrided_slice_vector sv(res.dimension(), all());
+        std::size_t i = 0;
+        for (const auto& p : probas)
         {
-            result_type res = result_type::from_shape(de.shape());
-            detail::argsort_over_leading_axis(de, res);
-            return res;
+            sv[0] = static_cast<std::ptrdiff_t>(i++);
+            detail::assign_quantile<T>(values, ax, static_cast<double>(p), strided_view(res, sv));
+        }
+        return res;
+    }
+
+    /**
+     * Computes the percentiles of the flattened xexpression.
+     *
+     * @param e xexpression
+     * @param q the percentiles to compute, in the range [0, 100]
+     *
+     * @return 1-D array with one element per percentile
+     * @sa quantile
+     */
+    template <class T = double, class E, class P>
+    inline auto percentile(const xexpression<E>& e, const P& q)
+    {
+        std::vector<double> probas;
+        for (const auto& v : q)
+        {
+            probas.push_back(static_cast<double>(v) / 100.);
         }
+        return quantile<T>(e, probas);
+    }
+
+    /**
+     * Computes the percentiles of xexpression along axis.
+     *
+     * @param e xexpression
+     * @param q the percentiles to compute, in the range [0, 100]
+     * @param axis axis along which the percentiles are computed
+     *
+     * @return array whose first dimension indexes the percentiles
+     * @sa quantile
+     */
+    template <class T = double, class E, class P>
+    inline auto percentile(const xexpression<E>& e, const P& q, std::ptrdiff_t axis)
+    {
+        std::vector<double> probas;
+        for (const auto& v : q)
+        {
+            probas.push_back(static_cast<double>(v) / 100.);
+        }
+        return quantile<T>(e, probas, axis);
+    }
+
+    /**
+     * Computes the median of the flattened xexpression. For an even number
+     * of elements, the median is the mean of the two middle elements.
+     *
+     * @param e xexpression
+     *
+     * @return the median
+     */
+    template <class T = double, class E>
+    inline T median(const xexpression<E>& e)
+    {
+        return quantile<T>(e, std::array<double, 1>({0.5}))[0];
+    }
+
+    /**
+     * Computes the median of xexpression along axis.
+     *
+     * @param e xexpression
+     * @param axis axis along which the median is computed
+     *
+     * @return array with the dimensions of e except \c axis
+     */
+    template <class T = double, class E>
+    inline auto median(const xexpression<E>& e, std::ptrdiff_t axis)
+    {
+        using eval_type = typename detail::sort_eval_type<E>::type;
+        using result_type = typename xreducer_result_container<eval_type, std::array<std::size_t, 1>, T>::type;
+
+        const auto& de = e.derived_cast();
+        std::size_t ax = detail::normalize_axis(axis, de.dimension());
+        if (de.shape()[ax] == 0)
+        {
+            throw std::runtime_error("Cannot compute the median of an empty array.");
+        }
+        std::size_t n = de.shape()[ax];
+        auto values = partition(e, detail::quantile_kth(std::array<double, 1>({0.5}), n), axis);
+
+        result_type res = result_type::from_shape(detail::shape_without_axis(de, ax));
+        detail::assign_quantile<T>(values, ax, 0.5, res);
+        return res;
     }
 
     namespace detail
@@ -401,12 +1170,53 @@ namespace xt
                            std::forward<F>(f));
         }
 
+        // Writes in out the position of the first element satisfying cmp
+        // against all the others in each lane of data, the lanes having
+        // the shape returned by lanes_shape. Lanes are scanned in place,
+        // the inner lanes of an outer index being compared row by row.
+        template <class T, class F>
+        inline void arg_func_over_lanes(const T* data, std::size_t* out, const std::array<std::size_t, 3>& ls, F&& cmp)
+        {
+            std::size_t outer = ls[0], size = ls[1], inner = ls[2];
+            if (inner == 1)
+            {
+                for (std::size_t o = 0; o < outer; ++o, data += size)
+                {
+                    out[o] = cmp_idx(data, data + size, 1, cmp);
+                }
+                return;
+            }
+
+            std::size_t block = std::min(detail::cache_chunk_size<T>(), inner);
+            uvector<T> best(block);
+            for (std::size_t o = 0; o < outer; ++o, data += size * inner, out += inner)
+            {
+                for (std::size_t i = 0; i < inner; i += block)
+                {
+                    std::size_t n = std::min(block, inner - i);
+                    std::copy(data + i, data + i + n, best.begin());
+                    std::fill(out + i, out + i + n, std::size_t(0));
+                    const T* row = data + i;
+                    for (std::size_t k = 1; k < size; ++k)
+                    {
+                        row += inner;
+                        for (std::size_t b = 0; b < n; ++b)
+                        {
+                            if (cmp(row[b], best[b]))
+                            {
+                                best[b] = row[b];
+                                out[i + b] = k;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
         template <class E, class F>
         inline typename argfunc_result_type<E>::type
         arg_func_impl(const E& e, std::size_t axis, F&& cmp)
         {
-            using eval_type = typename detail::sort_eval_type<E>::type;
-            using value_type = typename E::value_type;
             using result_type = typename argfunc_result_type<E>::type;
             using result_shape_type = typename result_type::shape_type;
 
@@ -423,40 +1233,25 @@ namespace xt
             std::copy(e.shape().cbegin() + std::ptrdiff_t(axis) + 1, e.shape().cend(), alt_shape.begin() + std::ptrdiff_t(axis));
 
             result_type result = result_type::from_shape(std::move(alt_shape));
-            auto result_iter = result.begin();
-
-            auto arg_func_lambda = [&result_iter, &cmp](auto begin, auto end) {
-                std::size_t idx = 0;
-                value_type val = *begin;
-                ++begin;
-                for (std::size_t i = 1; begin != end; ++begin, ++i)
-                {
-                    if (cmp(*begin, val))
-                    {
-                        val = *begin;
-                        idx = i;
-                    }
-                }
-                *result_iter = idx;
-                ++result_iter;
-            };
-
-            if (axis != detail::leading_axis(e))
+            if (e.size() == 0)
             {
-                dynamic_shape<std::size_t> permutation, reverse_permutation;
-                std::tie(permutation, reverse_permutation) = detail::get_permutations(e.dimension(), axis, e.layout());
-
-                // note: creating copy
-                eval_type input = transpose(e, permutation);
-                detail::call_over_leading_axis(input, arg_func_lambda);
                 return result;
             }
+
+            auto ls = lanes_shape(e, axis);
+            if (e.layout() == result.layout())
+            {
+                arg_func_over_lanes(e.data(), result.data(), ls, cmp);
+            }
             else
             {
-                auto&& input = eval(e);
-                detail::call_over_leading_axis(input, arg_func_lambda);
-                return result;
+                // The lanes are reduced in the memory order of e
+                xarray<std::size_t, layout_type::dynamic> tmp;
+                tmp.resize(result.shape(), e.layout());
+                arg_func_over_lanes(e.data(), tmp.data(), ls, cmp);
+                result = tmp;
             }
+            return result;
         }
     }
 
@@ -32,6 +32,22 @@
 namespace xt
 {
 
+    /*****************
+     * uninitialized *
+     *****************/
+
+    /**
+     * Tag requesting containers whose elements are default-initialized
+     * instead of value-initialized. The elements of trivial types are left
+     * uninitialized; it is meant for buffers that are entirely overwritten
+     * right after their allocation, such as the result of an assignment.
+     */
+    struct uninitialized_t
+    {
+    };
+
+    constexpr uninitialized_t uninitialized = {};
+
     namespace detail
     {
         template <class It>
@@ -64,6 +80,7 @@ namespace xt
         explicit uvector(const allocator_type& alloc) noexcept;
         explicit uvector(size_type count, const allocator_type& alloc = allocator_type());
         uvector(size_type count, const_reference value, const allocator_type& alloc = allocator_type());
+        uvector(size_type count, uninitialized_t, const allocator_type& alloc = allocator_type());
 
         template <class InputIt, class = detail::require_input_iter<InputIt>>
         uvector(InputIt first, InputIt last, const allocator_type& alloc = allocator_type());
@@ -85,6 +102,7 @@ namespace xt
         bool empty() const noexcept;
         size_type size() const noexcept;
         void resize(size_type size);
+        void resize(size_type size, uninitialized_t);
 
         reference operator[](size_type i);
         const_reference operator[](size_type i) const;
@@ -124,6 +142,7 @@ namespace xt
         void init_data(I first, I last);
 
         void resize_impl(size_type new_size);
+        void resize_impl(size_type new_size, uninitialized_t);
 
         allocator_type m_allocator;
 
@@ -176,6 +195,50 @@ namespace xt
             return res;
         }
 
+        // Default-initializes the elements instead of value-initializing them,
+        // without going through the construct method of the allocator, which
+        // value-initializes when it is given no argument.
+        template <class A>
+        inline typename A::pointer default_init_allocate(A& alloc, typename A::size_type size)
+        {
+            using pointer = typename A::pointer;
+            using value_type = typename A::value_type;
+            pointer res = alloc.allocate(size);
+            if (!xtrivially_default_constructible<value_type>::value)
+            {
+                pointer p = res;
+                try
+                {
+                    for (; p != res + size; ++p)
+                    {
+                        ::new (static_cast<void*>(std::addressof(*p))) value_type;
+                    }
+                }
+                catch (...)
+                {
+                    for (pointer q = res; q != p; ++q)
+                    {
+                        alloc.destroy(q);
+                    }
+                    alloc.deallocate(res, size);
+                    throw;
+                }
+            }
+            return res;
+        }
+
+        template <class A>
+        inline void move_assign_allocator(A& lhs, const A& rhs, std::true_type)
+        {
+            // rhs keeps an allocator able to grow its inline buffer
+            lhs = rhs;
+        }
+
+        template <class A>
+        inline void move_assign_allocator(A&, const A&, std::false_type)
+        {
+        }
+
         template <class A>
         inline void safe_destroy_deallocate(A& alloc, typename A::pointer ptr, typename A::size_type size)
         {
@@ -221,6 +284,19 @@ namespace xt
         }
     }
 
+    template <class T, class A>
+    inline void uvector<T, A>::resize_impl(size_type new_size, uninitialized_t)
+    {
+        size_type old_size = size();
+        pointer old_begin = p_begin;
+        if (new_size != old_size)
+        {
+            p_begin = detail::default_init_allocate(m_allocator, new_size);
+            p_end = p_begin + new_size;
+            detail::safe_destroy_deallocate(m_allocator, old_begin, old_size);
+        }
+    }
+
     template <class T, class A>
     inline uvector<T, A>::uvector() noexcept
         : uvector(allocator_type())
@@ -256,6 +332,17 @@ namespace xt
         }
     }
 
+    template <class T, class A>
+    inline uvector<T, A>::uvector(size_type count, uninitialized_t, const allocator_type& alloc)
+        : m_allocator(alloc), p_begin(nullptr), p_end(nullptr)
+    {
+        if (count != 0)
+        {
+            p_begin = detail::default_init_allocate(m_allocator, count);
+            p_end = p_begin + count;
+        }
+    }
+
     template <class T, class A>
     template <class InputIt, class>
     inline uvector<T, A>::uvector(InputIt first, InputIt last, const allocator_type& alloc)
@@ -358,12 +445,26 @@ namespace xt
         return static_cast<size_type>(p_end - p_begin);
     }
 
+    /**
+     * Resizes the uvector. The elements are not preserved; the elements of
+     * trivial types are left uninitialized, the other ones are value-initialized.
+     */
     template <class T, class A>
     inline void uvector<T, A>::resize(size_type size)
     {
         resize_impl(size);
     }
 
+    /**
+     * Resizes the uvector. The elements are not preserved, and are
+     * default-initialized whatever their type and the allocator.
+     */
+    template <class T, class A>
+    inline void uvector<T, A>::resize(size_type size, uninitialized_t)
+    {
+        resize_impl(size, uninitialized);
+    }
+
     template <class T, class A>
     inline auto uvector<T, A>::operator[](size_type i) -> reference
     {
@@ -624,6 +725,7 @@ namespace xt
         const_pointer data() const;
 
         void resize(size_type n);
+        void resize(size_type n, uninitialized_t);
 
         size_type capacity() const;
         void push_back(const T& elt);
@@ -678,6 +780,7 @@ namespace xt
 
         void grow(size_type min_capacity = 0);
         void destroy_range(T* begin, T* end);
+        void steal(svector& rhs);
     };
 
     template <class T, std::size_t N, class A, bool Init>
@@ -761,7 +864,19 @@ namespace xt
     template <class T, std::size_t N, class A, bool Init>
     inline svector<T, N, A, Init>& svector<T, N, A, Init>::operator=(svector&& rhs)
     {
-        assign(rhs.begin(), rhs.end());
+        using traits = std::allocator_traits<allocator_type>;
+        if (this != &rhs)
+        {
+            // The heap buffer of rhs can only be freed by an equal allocator
+            if (!rhs.on_stack() && (traits::propagate_on_container_move_assignment::value || m_allocator == rhs.m_allocator))
+            {
+                steal(rhs);
+            }
+            else
+            {
+                assign(std::make_move_iterator(rhs.begin()), std::make_move_iterator(rhs.end()));
+            }
+        }
         return *this;
     }
 
@@ -797,8 +912,16 @@ namespace xt
 
     template <class T, std::size_t N, class A, bool Init>
     inline svector<T, N, A, Init>::svector(svector&& rhs)
+        : m_allocator(rhs.m_allocator)
     {
-        this->swap(rhs);
+        if (rhs.on_stack())
+        {
+            assign(rhs.begin(), rhs.end());
+        }
+        else
+        {
+            steal(rhs);
+        }
     }
 
     template <class T, std::size_t N, class A, bool Init>
@@ -870,6 +993,22 @@ namespace xt
         }
     }
 
+    /**
+     * Resizes the svector without preserving nor initializing its elements.
+     * When the new size exceeds the capacity, the new buffer is allocated
+     * without copying the current elements.
+     */
+    template <class T, std::size_t N, class A, bool Init>
+    void svector<T, N, A, Init>::resize(size_type n, uninitialized_t)
+    {
+        if (n > N && n > capacity())
+        {
+            m_end = m_begin;
+            grow(n);
+        }
+        m_end = m_begin + n;
+    }
+
     template <class T, std::size_t N, class A, bool Init>
     inline auto svector<T, N, A, Init>::capacity() const -> size_type
     {
@@ -1171,6 +1310,26 @@ namespace xt
         m_capacity = new_alloc + new_capacity;
     }
 
+    // Takes over the heap buffer of rhs, which falls back to its inline buffer.
+    // The allocators must compare equal, or be propagated on move assignment.
+    template <class T, std::size_t N, class A, bool Init>
+    inline void svector<T, N, A, Init>::steal(svector& rhs)
+    {
+        destroy_range(m_begin, m_end);
+        if (!on_stack())
+        {
+            m_allocator.deallocate(m_begin, std::size_t(m_capacity - m_begin));
+        }
+        detail::move_assign_allocator(m_allocator, rhs.m_allocator,
+                                      typename std::allocator_traits<allocator_type>::propagate_on_container_move_assignment());
+        m_begin = rhs.m_begin;
+        m_end = rhs.m_end;
+        m_capacity = rhs.m_capacity;
+        rhs.m_begin = std::begin(rhs.m_data);
+        rhs.m_end = std::begin(rhs.m_data);
+        rhs.m_capacity = std::end(rhs.m_data);
+    }
+
     template <class T, std::size_t N, class A, bool Init>
     inline bool operator==(const std::vector<T>& lhs, const svector<T, N, A, Init>& rhs)
     {
@@ -106,12 +106,15 @@ namespace xt
         xtensor_container(nested_initializer_list_t<value_type, N> t);
         explicit xtensor_container(const shape_type& shape, layout_type l = L);
         explicit xtensor_container(const shape_type& shape, const_reference value, layout_type l = L);
+        explicit xtensor_container(const shape_type& shape, uninitialized_t, layout_type l = L);
         explicit xtensor_container(const shape_type& shape, const strides_type& strides);
         explicit xtensor_container(const shape_type& shape, const strides_type& strides, const_reference value);
         explicit xtensor_container(storage_type&& storage, inner_shape_type&& shape, inner_strides_type&& strides);
 
         template <class S = shape_type>
         static xtensor_container from_shape(S&& s);
+        template <class S = shape_type>
+        static xtensor_container from_shape(S&& s, uninitialized_t);
 
         ~xtensor_container() = default;
 
@@ -287,6 +290,20 @@ namespace xt
         std::fill(m_storage.begin(), m_storage.end(), value);
     }
 
+    /**
+     * Allocates an xtensor_container with the specified shape and layout_type.
+     * Elements are default-initialized rather than value-initialized, see
+     * uninitialized_t.
+     * @param shape the shape of the xtensor_container
+     * @param l the layout_type of the xtensor_container
+     */
+    template <class EC, std::size_t N, layout_type L, class Tag>
+    inline xtensor_container<EC, N, L, Tag>::xtensor_container(const shape_type& shape, uninitialized_t, layout_type l)
+        : base_type()
+    {
+        base_type::resize(shape, l, uninitialized);
+    }
+
     /**
      * Allocates an uninitialized xtensor_container with the specified shape and strides.
      * @param shape the shape of the xtensor_container
@@ -360,6 +377,19 @@ namespace xt
         shape_type shape = xtl::forward_sequence<shape_type, S>(s);
         return self_type(shape);
     }
+
+    /**
+     * Allocates and returns an xtensor_container with the specified shape,
+     * without value-initializing its elements.
+     * @param s the shape of the xtensor_container
+     */
+    template <class EC, std::size_t N, layout_type L, class Tag>
+    template <class S>
+    inline xtensor_container<EC, N, L, Tag> xtensor_container<EC, N, L, Tag>::from_shape(S&& s, uninitialized_t)
+    {
+        shape_type shape = xtl::forward_sequence<shape_type, S>(s);
+        return self_type(shape, uninitialized);
+    }
     //@}
 
     /**
@@ -75,4 +75,20 @@
 #define XTENSOR_DEFAULT_LAYOUT ::xt::layout_type::row_major
 #endif
 
+// Minimal number of elements for an evaluation to be split across threads
+// when XTENSOR_USE_THREADS or XTENSOR_USE_TBB is defined.
+#ifndef XTENSOR_PARALLEL_THRESHOLD
+#define XTENSOR_PARALLEL_THRESHOLD 65536
+#endif
+
+// Size in bytes of the chunks processed by a thread in linear assignments.
+#ifndef XTENSOR_PARALLEL_CHUNK_BYTES
+#define XTENSOR_PARALLEL_CHUNK_BYTES 65536
+#endif
+
+// Size of the square blocks of the cache-blocked assignment of transposed expressions.
+#ifndef XTENSOR_TRANSPOSE_BLOCK_SIZE
+#define XTENSOR_TRANSPOSE_BLOCK_SIZE 32
+#endif
+
 #endif
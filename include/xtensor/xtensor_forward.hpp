@@ -134,6 +134,31 @@ namespace xt
               class A = XTENSOR_DEFAULT_ALLOCATOR(T)>
     using xtensor = xtensor_container<XTENSOR_DEFAULT_DATA_CONTAINER(T, A), N, L>;
 
+    /**
+     * @typedef xtensor_small
+     * Alias template on xtensor_container whose elements are held in an
+     * svector. Up to \c C elements are stored inline in the container,
+     * bigger tensors fall back to a heap-allocated buffer. This avoids the
+     * dynamic memory allocation of small tensors whose shape is only known
+     * at runtime:
+     *
+     * \code{.cpp}
+     * xt::xtensor_small<double, 2, 16> m = xt::zeros<double>({n, n});
+     * \endcode
+     *
+     * @tparam T The value type of the elements.
+     * @tparam N The dimension of the tensor.
+     * @tparam C The number of elements stored inline (default: 16).
+     * @tparam L The layout_type of the tensor (default: row_major).
+     * @tparam A The allocator of the heap buffer.
+     */
+    template <class T,
+              std::size_t N,
+              std::size_t C = 16,
+              layout_type L = XTENSOR_DEFAULT_LAYOUT,
+              class A = XTENSOR_DEFAULT_ALLOCATOR(T)>
+    using xtensor_small = xtensor_container<svector<T, C, A, false>, N, L>;
+
     template <class EC, std::size_t N, layout_type L = XTENSOR_DEFAULT_LAYOUT, class Tag = xtensor_expression_tag>
     class xtensor_adaptor;
 
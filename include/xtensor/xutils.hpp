@@ -11,11 +11,16 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <complex>
 #include <cstddef>
 #include <initializer_list>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -1086,8 +1091,251 @@ namespace xt
         enum policy
         {
             print,
-            assert
+            assert,
+            statistics
         };
+
+        /**
+         * Number of buckets of the size histogram of the allocation
+         * statistics. Bucket \c i counts the allocations of at least
+         * \c 2^i bytes and less than \c 2^(i+1) bytes (bucket 0 also
+         * counts the empty allocations).
+         */
+        constexpr std::size_t histogram_size = 64;
+
+        /**
+         * Snapshot of the statistics gathered by the tracking_allocator
+         * with the statistics policy. live_bytes can be negative when
+         * buffers allocated before the last reset have been deallocated
+         * since (see reset).
+         */
+        struct allocation_statistics
+        {
+            std::size_t allocations = 0;
+            std::size_t deallocations = 0;
+            std::size_t bytes_allocated = 0;
+            std::size_t bytes_deallocated = 0;
+            std::ptrdiff_t live_bytes = 0;
+            std::ptrdiff_t peak_live_bytes = 0;
+            std::array<std::size_t, histogram_size> histogram = {};
+        };
+
+        namespace detail
+        {
+            inline std::size_t histogram_bucket(std::size_t bytes) noexcept
+            {
+                std::size_t bucket = 0;
+                while (bytes > 1 && bucket + 1 < histogram_size)
+                {
+                    bytes >>= 1;
+                    ++bucket;
+                }
+                return bucket;
+            }
+
+            // Lock-free counters, updated with relaxed atomics: the snapshots
+            // of counters updated concurrently are approximate.
+            class allocation_counters
+            {
+            public:
+
+                allocation_counters() noexcept;
+
+                void record_allocation(std::size_t bytes) noexcept;
+                void record_deallocation(std::size_t bytes) noexcept;
+
+                allocation_statistics snapshot() const noexcept;
+                void reset() noexcept;
+
+            private:
+
+                std::atomic<std::size_t> m_allocations;
+                std::atomic<std::size_t> m_deallocations;
+                std::atomic<std::size_t> m_bytes_allocated;
+                std::atomic<std::size_t> m_bytes_deallocated;
+                std::atomic<std::ptrdiff_t> m_live_bytes;
+                std::atomic<std::ptrdiff_t> m_peak_live_bytes;
+                std::array<std::atomic<std::size_t>, histogram_size> m_histogram;
+            };
+
+            inline allocation_counters::allocation_counters() noexcept
+            {
+                reset();
+            }
+
+            inline void allocation_counters::record_allocation(std::size_t bytes) noexcept
+            {
+                m_allocations.fetch_add(1, std::memory_order_relaxed);
+                m_bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+                m_histogram[histogram_bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+                std::ptrdiff_t live = m_live_bytes.fetch_add(static_cast<std::ptrdiff_t>(bytes), std::memory_order_relaxed)
+                                      + static_cast<std::ptrdiff_t>(bytes);
+                std::ptrdiff_t peak = m_peak_live_bytes.load(std::memory_order_relaxed);
+                while (live > peak && !m_peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+                {
+                }
+            }
+
+            inline void allocation_counters::record_deallocation(std::size_t bytes) noexcept
+            {
+                m_deallocations.fetch_add(1, std::memory_order_relaxed);
+                m_bytes_deallocated.fetch_add(bytes, std::memory_order_relaxed);
+                m_live_bytes.fetch_sub(static_cast<std::ptrdiff_t>(bytes), std::memory_order_relaxed);
+            }
+
+            inline allocation_statistics allocation_counters::snapshot() const noexcept
+            {
+                allocation_statistics res;
+                res.allocations = m_allocations.load(std::memory_order_relaxed);
+                res.deallocations = m_deallocations.load(std::memory_order_relaxed);
+                res.bytes_allocated = m_bytes_allocated.load(std::memory_order_relaxed);
+                res.bytes_deallocated = m_bytes_deallocated.load(std::memory_order_relaxed);
+                res.live_bytes = m_live_bytes.load(std::memory_order_relaxed);
+                res.peak_live_bytes = m_peak_live_bytes.load(std::memory_order_relaxed);
+                for (std::size_t i = 0; i < histogram_size; ++i)
+                {
+                    res.histogram[i] = m_histogram[i].load(std::memory_order_relaxed);
+                }
+                return res;
+            }
+
+            inline void allocation_counters::reset() noexcept
+            {
+                m_allocations.store(0, std::memory_order_relaxed);
+                m_deallocations.store(0, std::memory_order_relaxed);
+                m_bytes_allocated.store(0, std::memory_order_relaxed);
+                m_bytes_deallocated.store(0, std::memory_order_relaxed);
+                m_live_bytes.store(0, std::memory_order_relaxed);
+                m_peak_live_bytes.store(0, std::memory_order_relaxed);
+                for (auto& bucket : m_histogram)
+                {
+                    bucket.store(0, std::memory_order_relaxed);
+                }
+            }
+
+            inline allocation_counters& global_counters() noexcept
+            {
+                static allocation_counters counters;
+                return counters;
+            }
+
+            inline std::mutex& tags_mutex() noexcept
+            {
+                static std::mutex m;
+                return m;
+            }
+
+            inline std::map<std::string, std::unique_ptr<allocation_counters>>& tag_counters()
+            {
+                static std::map<std::string, std::unique_ptr<allocation_counters>> counters;
+                return counters;
+            }
+
+            inline allocation_counters& find_tag_counters(const std::string& tag)
+            {
+                std::lock_guard<std::mutex> lock(tags_mutex());
+                auto& counters = tag_counters()[tag];
+                if (counters == nullptr)
+                {
+                    counters.reset(new allocation_counters());
+                }
+                return *counters;
+            }
+
+            inline allocation_counters*& current_tag() noexcept
+            {
+                static thread_local allocation_counters* p_tag = nullptr;
+                return p_tag;
+            }
+        }
+
+        /**
+         * @class tag_scope
+         * @brief Attributes the allocations of a thread to a tag.
+         *
+         * While a tag_scope is alive, the allocations of the calling thread
+         * tracked with the statistics policy are also counted in the
+         * statistics of its tag, e.g. the name of a call site. Scopes can be
+         * nested, the innermost one is used. Deallocations are not attributed
+         * to tags, the live bytes of a tag are not tracked.
+         */
+        class tag_scope
+        {
+        public:
+
+            explicit tag_scope(const std::string& tag);
+            ~tag_scope();
+
+            tag_scope(const tag_scope&) = delete;
+            tag_scope& operator=(const tag_scope&) = delete;
+
+        private:
+
+            detail::allocation_counters* p_previous;
+        };
+
+        inline tag_scope::tag_scope(const std::string& tag)
+            : p_previous(detail::current_tag())
+        {
+            detail::current_tag() = &detail::find_tag_counters(tag);
+        }
+
+        inline tag_scope::~tag_scope()
+        {
+            detail::current_tag() = p_previous;
+        }
+
+        /**
+         * Returns a snapshot of the statistics of all the tracked allocations.
+         */
+        inline allocation_statistics snapshot() noexcept
+        {
+            return detail::global_counters().snapshot();
+        }
+
+        /**
+         * Returns a snapshot of the statistics of the allocations made under
+         * the given tag.
+         */
+        inline allocation_statistics snapshot(const std::string& tag)
+        {
+            std::lock_guard<std::mutex> lock(detail::tags_mutex());
+            auto it = detail::tag_counters().find(tag);
+            return it != detail::tag_counters().end() ? it->second->snapshot() : allocation_statistics();
+        }
+
+        /**
+         * Returns the tags that have been used by a tag_scope.
+         */
+        inline std::vector<std::string> tags()
+        {
+            std::lock_guard<std::mutex> lock(detail::tags_mutex());
+            std::vector<std::string> res;
+            for (const auto& tag : detail::tag_counters())
+            {
+                res.push_back(tag.first);
+            }
+            return res;
+        }
+
+        /**
+         * Resets the global statistics and the statistics of all the tags.
+         * The allocations are not recorded individually, so the buffers
+         * allocated before a reset are still subtracted from the live bytes
+         * when they are deallocated: live_bytes and peak_live_bytes are only
+         * meaningful if no tracked buffer is alive when reset is called.
+         * The same holds for the buffers allocated while the tracking is
+         * disabled.
+         */
+        inline void reset()
+        {
+            detail::global_counters().reset();
+            std::lock_guard<std::mutex> lock(detail::tags_mutex());
+            for (auto& tag : detail::tag_counters())
+            {
+                tag.second->reset();
+            }
+        }
     }
 
     template <class T, class A, alloc_tracking::policy P>
@@ -1117,11 +1365,27 @@ namespace xt
                 {
                     throw std::runtime_error("xtensor allocation of " + std::to_string(n) + " elements detected");
                 }
+                else if (P == alloc_tracking::statistics)
+                {
+                    alloc_tracking::detail::global_counters().record_allocation(n * sizeof(T));
+                    if (alloc_tracking::detail::current_tag() != nullptr)
+                    {
+                        alloc_tracking::detail::current_tag()->record_allocation(n * sizeof(T));
+                    }
+                }
             }
             return base_type::allocate(n);
         }
 
-        using base_type::deallocate;
+        void deallocate(T* p, std::size_t n)
+        {
+            if (P == alloc_tracking::statistics && alloc_tracking::enabled())
+            {
+                alloc_tracking::detail::global_counters().record_deallocation(n * sizeof(T));
+            }
+            base_type::deallocate(p, n);
+        }
+
         using base_type::construct;
         using base_type::destroy;
 
@@ -14,6 +14,8 @@
 #include "xtensor/xmath.hpp"
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xfixed.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xview.hpp"
 
 namespace xt
 {
@@ -212,4 +214,132 @@ namespace xt
         truth = std::is_same<typename decltype(res_0)::shape_type, xshape<4, 3>>::value;
         EXPECT_TRUE(truth);
     }
-}
\ No newline at end of file
+
+    TEST(xaccumulator, long_axes)
+    {
+        // Line scan along a contiguous axis
+        std::size_t n = 2000;
+        xtensor<long long, 2> a = xt::ones<long long>({std::size_t(3), n});
+        a(1, 17) = 5;
+        auto res = cumsum(a, 1);
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            ASSERT_EQ(res(0, j), static_cast<long long>(j + 1));
+            ASSERT_EQ(res(1, j), static_cast<long long>(j + 1 + (j >= 17 ? 4 : 0)));
+        }
+
+        // Transposed input, copied before being scanned
+        auto res_t = cumsum(transpose(a), 0);
+        EXPECT_EQ(res_t, transpose(res));
+
+        // nan functors, along the contiguous axis and flattened
+        xarray<double, layout_type::column_major> c = xt::ones<double>({n, std::size_t(2)});
+        c(n - 1, 1) = std::numeric_limits<double>::quiet_NaN();
+        auto res_c = nancumsum(c, 0);
+        EXPECT_EQ(res_c(n - 1, 0), double(n));
+        EXPECT_EQ(res_c(n - 1, 1), double(n - 1));
+        auto flat = nancumsum(c);
+        EXPECT_EQ(flat(2 * n - 1), double(2 * n - 1));
+        EXPECT_EQ(flat(n), double(n + 1));
+
+        xtensor<double, 1> halves = 0.5 * xt::ones<double>({n});
+        halves(3) = std::numeric_limits<double>::quiet_NaN();
+        auto prod = nancumprod(halves + 0.5);
+        EXPECT_EQ(prod(n - 1), 1.);
+
+        auto empty = cumsum(xtensor<double, 2>::from_shape({0, 3}), 1);
+        EXPECT_EQ(empty.size(), 0u);
+    }
+
+    TEST(xaccumulator, lazy)
+    {
+        xarray<double> a = xt::random::rand<double>({3, 4, 5});
+        for (std::ptrdiff_t axis = 0; axis < 3; ++axis)
+        {
+            auto lazy = cumsum(a, axis, evaluation_strategy::lazy());
+            xarray<double> expected = cumsum(a, axis);
+            xarray<double> res = lazy;
+            EXPECT_TRUE(allclose(res, expected));
+            xarray<double, layout_type::column_major> res_c = lazy;
+            EXPECT_TRUE(allclose(res_c, expected));
+            EXPECT_NEAR(lazy(2, 3, 4), expected(2, 3, 4), 1e-12);
+            std::array<std::size_t, 2> idx = {1, 2};
+            EXPECT_NEAR(lazy.element(idx.cbegin(), idx.cend()), expected(0, 1, 2), 1e-12);
+        }
+
+        xarray<double> flat = cumprod(a + 1., evaluation_strategy::lazy());
+        EXPECT_TRUE(allclose(flat, cumprod(a + 1.)));
+
+        xarray<double, layout_type::column_major> c = a;
+        EXPECT_TRUE(allclose(xarray<double>(cumsum(c, 1, evaluation_strategy::lazy())), cumsum(a, 1)));
+        EXPECT_TRUE(allclose(xarray<double>(cumsum(c, evaluation_strategy::lazy())), cumsum(a)));
+
+        xarray<double> n = {{1., std::numeric_limits<double>::quiet_NaN()}, {3., 4.}};
+        xarray<double> n_expected = {{1., 1.}, {4., 8.}};
+        EXPECT_EQ(nancumsum(n, evaluation_strategy::lazy())[3], 8.);
+        EXPECT_EQ(xarray<double>(nancumsum(n, 1, evaluation_strategy::lazy())), xarray<double>(nancumsum(n, 1)));
+        EXPECT_EQ(xarray<double>(nancumprod(n, 0, evaluation_strategy::lazy())), xarray<double>({{1., 1.}, {3., 4.}}));
+    }
+
+    TEST(xaccumulator, lazy_element)
+    {
+        xtensor<double, 2> a = xt::random::rand<double>({50, 20});
+        std::size_t calls = 0;
+        auto counting_plus = [&calls](double x, double y) {
+            ++calls;
+            return x + y;
+        };
+
+        // Only the lane of the element is accumulated
+        auto lazy1 = accumulate(make_xaccumulator_functor(counting_plus), a, 1, evaluation_strategy::lazy());
+        xtensor<double, 2> expected1 = cumsum(a, 1);
+        EXPECT_NEAR(lazy1(30, 7), expected1(30, 7), 1e-12);
+        EXPECT_EQ(calls, 7u);
+
+        calls = 0;
+        auto lazy0 = accumulate(make_xaccumulator_functor(counting_plus), a, 0, evaluation_strategy::lazy());
+        xtensor<double, 2> expected0 = cumsum(a, 0);
+        EXPECT_NEAR(lazy0(30, 7), expected0(30, 7), 1e-10);
+        EXPECT_EQ(calls, 30u);
+    }
+
+    TEST(xaccumulator, lazy_composition)
+    {
+        std::size_t n = 100;
+        xtensor<double, 2> a = xt::random::rand<double>({std::size_t(7), n});
+        xtensor<double, 2> expected = cumsum(a, 1);
+
+        // Only the last 10 columns are computed
+        auto lazy = cumsum(a, 1, evaluation_strategy::lazy());
+        xtensor<double, 2> last = view(lazy, all(), range(n - 10, n));
+        EXPECT_TRUE(allclose(last, view(expected, all(), range(n - 10, n))));
+        xtensor<double, 1> col = view(cumsum(a, 0, evaluation_strategy::lazy()), all(), n - 1);
+        EXPECT_TRUE(allclose(col, view(cumsum(a, 0), all(), n - 1)));
+
+        auto total = cumsum(a, evaluation_strategy::lazy());
+        EXPECT_NEAR(total[7 * n - 1], sum(a)(), 1e-10);
+        EXPECT_NEAR(total(7 * n - 1), sum(a)(), 1e-10);
+
+        // Fused in the assignment of the function
+        xtensor<double, 2> y = xt::random::rand<double>({std::size_t(7), n});
+        xtensor<double, 2> res = a - cumsum(y, 1, evaluation_strategy::lazy());
+        EXPECT_TRUE(allclose(res, a - cumsum(y, 1)));
+        res = a - cumsum(y, 0, evaluation_strategy::lazy());
+        EXPECT_TRUE(allclose(res, a - cumsum(y, 0)));
+
+        // Broadcasting
+        xtensor<double, 1> v = {1., 2., 3.};
+        xtensor<double, 2> b = xt::ones<double>({std::size_t(2), std::size_t(3)});
+        xtensor<double, 2> bres = b + cumsum(v, evaluation_strategy::lazy());
+        xtensor<double, 2> bexpected = {{2., 4., 7.}, {2., 4., 7.}};
+        EXPECT_EQ(bres, bexpected);
+        xtensor<double, 2> col_v = {{1.}, {2.}};
+        bres = b * cumsum(col_v, 0, evaluation_strategy::lazy());
+        bexpected = {{1., 1., 1.}, {3., 3., 3.}};
+        EXPECT_EQ(bres, bexpected);
+
+        xtensor<double, 2> strided = view(cumsum(a, 1, evaluation_strategy::lazy()), range(0, 7, 2), range(1, n, 3));
+        EXPECT_TRUE(allclose(strided, view(expected, range(0, 7, 2), range(1, n, 3))));
+        EXPECT_THROW(cumsum(a, 2, evaluation_strategy::lazy()), std::runtime_error);
+    }
+}
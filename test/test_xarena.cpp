@@ -0,0 +1,102 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarena.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xsort.hpp"
+#include "xtensor/xtensor.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace xt
+{
+    using arena_array = xarray<double, XTENSOR_DEFAULT_LAYOUT, arena_allocator<double>>;
+    using arena_tensor = xtensor<int, 1, XTENSOR_DEFAULT_LAYOUT, arena_allocator<int>>;
+
+    TEST(xarena, arena)
+    {
+        xarena arena(256);
+        void* p1 = arena.allocate(10, 8);
+        void* p2 = arena.allocate(100, 64);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p2) % 64, 0u);
+        EXPECT_NE(p1, p2);
+        EXPECT_EQ(arena.bytes_used(), 110u);
+
+        // Allocations larger than the blocks
+        void* p3 = arena.allocate(1000, 16);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p3) % 16, 0u);
+        EXPECT_GE(arena.bytes_reserved(), 1256u);
+
+        arena.reset();
+        EXPECT_EQ(arena.bytes_used(), 0u);
+        EXPECT_GE(arena.bytes_reserved(), 1000u);
+        arena.allocate(500, 8);
+        EXPECT_EQ(arena.bytes_used(), 500u);
+    }
+
+    TEST(xarena, allocator)
+    {
+        // Without scope, the allocator uses the heap
+        arena_array a = {{1., 2., 3.}, {4., 5., 6.}};
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(a.data()) % detail::arena_alignment, 0u);
+
+        arena_array b;
+        {
+            arena_scope scope;
+            arena_array tmp = a + a;
+            EXPECT_GT(scope.bytes_used(), 0u);
+            std::size_t used = scope.bytes_used();
+
+            // The result outlives the scope, its buffer keeps the arena alive
+            b = tmp * 2.;
+            EXPECT_GT(scope.bytes_used(), used);
+            used = scope.bytes_used();
+
+            arena_tensor s = sort(arena_tensor({3, 1, 2}));
+            EXPECT_EQ(s, arena_tensor({1, 2, 3}));
+            EXPECT_GT(scope.bytes_used(), used);
+        }
+        EXPECT_EQ(b, arena_array({{4., 8., 12.}, {16., 20., 24.}}));
+    }
+
+    TEST(xarena, nested_scopes)
+    {
+        arena_scope outer;
+        arena_array a = {1., 2., 3.};
+        std::size_t outer_used = outer.bytes_used();
+        {
+            arena_scope inner;
+            arena_array b = {4., 5.};
+            EXPECT_EQ(outer.bytes_used(), outer_used);
+            EXPECT_GT(inner.bytes_used(), 0u);
+        }
+        arena_array c = {6.};
+        EXPECT_GT(outer.bytes_used(), outer_used);
+    }
+
+    TEST(xarena, escape)
+    {
+        arena_array res;
+        std::vector<int, arena_allocator<int>> v;
+        {
+            arena_scope scope(64);
+            arena_array tmp = {1., 2., 3., 4.};
+            res = std::move(tmp);
+            v.assign({1, 2, 3});
+        }
+        // The arena is kept alive by the buffers moved out of the scope
+        EXPECT_EQ(res, arena_array({1., 2., 3., 4.}));
+        EXPECT_EQ(v, (std::vector<int, arena_allocator<int>>({1, 2, 3})));
+        res.resize({100});
+        v.push_back(4);
+        EXPECT_EQ(v.size(), 4u);
+    }
+}
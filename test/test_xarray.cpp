@@ -148,6 +148,27 @@ namespace xt
         test_resize(a);
     }
 
+    TEST(xarray, uninitialized)
+    {
+        std::vector<std::size_t> shape = {3, 2, 4};
+        xarray_dynamic a(shape, uninitialized, layout_type::column_major);
+        EXPECT_EQ(shape, a.shape());
+        EXPECT_EQ(layout_type::column_major, a.layout());
+        EXPECT_EQ(std::size_t(24), a.size());
+
+        auto b = xarray<double>::from_shape({2, 5}, uninitialized);
+        EXPECT_EQ(std::size_t(10), b.size());
+
+        b.resize({4, 4}, uninitialized);
+        EXPECT_EQ(std::size_t(16), b.storage().size());
+        b.fill(2.);
+        EXPECT_EQ(2., b(3, 3));
+
+        xarray<double> c;
+        c.resize(std::vector<std::size_t>(), uninitialized, true);
+        EXPECT_EQ(std::size_t(1), c.size());
+    }
+
     TEST(xarray, reshape)
     {
         xarray_dynamic a;
@@ -0,0 +1,97 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xassign_plan.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    TEST(xassign_plan, linear)
+    {
+        xtensor<double, 2> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xtensor<double, 2> b = {{1., 1., 1.}, {2., 2., 2.}};
+        xarray<double> res;
+        auto plan = make_assign_plan(res, a + 2. * b);
+        EXPECT_EQ(plan.strategy(), assign_strategy::linear);
+        ASSERT_EQ(res.shape().size(), 2u);
+        EXPECT_EQ(res.shape()[1], 3u);
+
+        plan.run();
+        EXPECT_EQ(res, a + 2. * b);
+
+        a.fill(10.);
+        b(1, 2) = -1.;
+        plan.run();
+        xarray<double> expected = {{12., 12., 12.}, {14., 14., 8.}};
+        EXPECT_EQ(res, expected);
+        EXPECT_EQ(&plan.lhs(), &res);
+    }
+
+    TEST(xassign_plan, broadcast)
+    {
+        xtensor<double, 2> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xtensor<double, 1> b = {10., 20., 30.};
+        xtensor<double, 2> res;
+        auto plan = make_assign_plan(res, a + b);
+        EXPECT_NE(plan.strategy(), assign_strategy::linear);
+        plan.run();
+        EXPECT_EQ(res, a + b);
+
+        b(0) = 0.;
+        plan.run();
+        EXPECT_EQ(res(1, 0), 4.);
+        EXPECT_EQ(res(1, 1), 25.);
+    }
+
+    TEST(xassign_plan, strided)
+    {
+        xtensor<double, 2> a = {{1., 2., 3., 4.}, {5., 6., 7., 8.}};
+        xtensor<double, 2> t;
+        auto tplan = make_assign_plan(t, transpose(a));
+        EXPECT_EQ(tplan.strategy(), assign_strategy::transposed);
+        tplan.run();
+        EXPECT_EQ(t, transpose(a));
+
+        xtensor<double, 2> s;
+        auto splan = make_assign_plan(s, view(a, all(), range(0, 4, 2)));
+        EXPECT_EQ(splan.strategy(), assign_strategy::strided_data);
+        a(1, 2) = -7.;
+        tplan.run();
+        splan.run();
+        EXPECT_EQ(t(2, 1), -7.);
+        EXPECT_EQ(s, view(a, all(), range(0, 4, 2)));
+
+        // View as destination
+        xtensor<double, 1> row = {-1., -2.};
+        auto vplan = make_assign_plan(view(a, all(), 1), row);
+        vplan.run();
+        EXPECT_EQ(a(0, 1), -1.);
+        EXPECT_EQ(a(1, 1), -2.);
+        EXPECT_EQ(a(1, 2), -7.);
+
+        xtensor<double, 1> wrong = {1., 2., 3.};
+        EXPECT_THROW(make_assign_plan(view(a, all(), 1), wrong), broadcast_error);
+    }
+
+    TEST(xassign_plan, transposed_empty)
+    {
+        xtensor<double, 2> a = empty<double>({0, 4});
+        xtensor<double, 2> t;
+        auto plan = make_assign_plan(t, transpose(a));
+        EXPECT_NE(plan.strategy(), assign_strategy::transposed);
+        plan.run();
+        EXPECT_EQ(t.shape()[0], 4u);
+        EXPECT_EQ(t.size(), 0u);
+    }
+}
@@ -8,7 +8,9 @@
 
 #include "gtest/gtest.h"
 
+#include <limits>
 #include <sstream>
+#include <string>
 #include <iostream>
 
 #include "xtensor/xcsv.hpp"
@@ -45,4 +47,126 @@ namespace xt
         dump_csv(res, data);
         ASSERT_EQ("1,2,3,4\n10,12,15,18\n", res.str());
     }
+
+    TEST(xcsv, load_int)
+    {
+        std::string source =
+            "# comment\n"
+            "1,-2, +3\r\n"
+            "\n"
+            "-2147483648,2147483647,0\n";
+
+        std::stringstream source_stream(source);
+        xtensor<int, 2> res = load_csv<int>(source_stream);
+        xtensor<int, 2> exp
+            {{ 1, -2, 3},
+             {std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), 0}};
+        EXPECT_EQ(res, exp);
+
+        std::stringstream fraction_stream("1.0,-2.7, 3.");
+        xtensor<int, 2> exp_fraction = {{1, -2, 3}};
+        EXPECT_EQ(load_csv<int>(fraction_stream), exp_fraction);
+
+        std::stringstream overflow_stream("2147483648");
+        EXPECT_THROW(load_csv<int>(overflow_stream), std::out_of_range);
+        std::stringstream invalid_stream("1,2a");
+        EXPECT_THROW(load_csv<int>(invalid_stream), std::runtime_error);
+        std::stringstream empty_cell_stream("1,,2");
+        EXPECT_THROW(load_csv<double>(empty_cell_stream), std::runtime_error);
+        std::stringstream inconsistent_stream("1,2\n3");
+        EXPECT_THROW(load_csv<double>(inconsistent_stream), std::runtime_error);
+    }
+
+    TEST(xcsv, load_options)
+    {
+        std::string source =
+            "a;b;c;d\n"
+            "1.5;2;3;4\n"
+            "5;6e2;7;8\n"
+            "9;10;11;12";
+
+        std::stringstream source_stream(source);
+        xtensor<double, 2> res = load_csv<double>(source_stream, ';', 1, 2, "#", {3, 1});
+        xtensor<double, 2> exp
+            {{4., 2.},
+             {8., 600.}};
+        EXPECT_EQ(res, exp);
+
+        std::stringstream header_stream(source);
+        xtensor<std::string, 2> header = load_csv<std::string>(header_stream, ';', 0, 1);
+        xtensor<std::string, 2> exp_header = {{"a", "b", "c", "d"}};
+        EXPECT_EQ(header, exp_header);
+
+        std::stringstream out_of_range_stream(source);
+        EXPECT_THROW(load_csv<double>(out_of_range_stream, ';', 1, -1, "#", {4}), std::runtime_error);
+        std::stringstream duplicate_stream(source);
+        EXPECT_THROW(load_csv<double>(duplicate_stream, ';', 1, -1, "#", {1, 3, 1}), std::runtime_error);
+    }
+
+    TEST(xcsv, load_partial)
+    {
+        std::string source =
+            "1,2\n"
+            "  # indented comment\n"
+            "3,4\n"
+            "5,6\n"
+            "7,8\n";
+
+        std::stringstream source_stream(source);
+        xtensor<int, 2> first = load_csv<int>(source_stream, ',', 0, 2);
+        xtensor<int, 2> exp_first = {{1, 2}, {3, 4}};
+        EXPECT_EQ(first, exp_first);
+
+        // The stream is left after the last row read
+        xtensor<int, 2> rest = load_csv<int>(source_stream);
+        xtensor<int, 2> exp_rest = {{5, 6}, {7, 8}};
+        EXPECT_EQ(rest, exp_rest);
+    }
+
+    TEST(xcsv, load_long_lines)
+    {
+        std::size_t nbcols = 300000;
+        std::stringstream source_stream;
+        for (std::size_t r = 0; r < 3; ++r)
+        {
+            for (std::size_t c = 0; c < nbcols; ++c)
+            {
+                source_stream << r * nbcols + c << (c + 1 == nbcols ? '\n' : ',');
+            }
+        }
+
+        xtensor<std::size_t, 2> res = load_csv<std::size_t>(source_stream);
+        ASSERT_EQ(res.shape()[0], 3u);
+        ASSERT_EQ(res.shape()[1], nbcols);
+        for (std::size_t i = 0; i < res.size(); ++i)
+        {
+            ASSERT_EQ(res.storage()[i], i);
+        }
+    }
+
+    TEST(xcsv, dump_options)
+    {
+        xtensor<double, 2> data
+            {{ 1.5, -2.25},
+             {1e20, 0.1}};
+
+        std::stringstream res;
+        dump_csv(res, data, ';');
+        EXPECT_EQ("1.5;-2.25\n1e+20;0.1\n", res.str());
+
+        std::stringstream fixed_res;
+        fixed_res << std::fixed;
+        fixed_res.precision(2);
+        dump_csv(fixed_res, data);
+        EXPECT_EQ("1.50,-2.25\n100000000000000000000.00,0.10\n", fixed_res.str());
+
+        xtensor<long long, 2> ints = {{std::numeric_limits<long long>::min(), 0}, {-1, 42}};
+        std::stringstream int_res;
+        dump_csv(int_res, ints);
+        EXPECT_EQ("-9223372036854775808,0\n-1,42\n", int_res.str());
+
+        std::stringstream round_trip;
+        dump_csv(round_trip, ints);
+        EXPECT_EQ(ints, load_csv<long long>(round_trip));
+    }
 }
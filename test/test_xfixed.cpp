@@ -162,6 +162,16 @@ namespace xt
         EXPECT_EQ(a[0], 2);
     }
 
+    TEST(xtensor_fixed, uninitialized)
+    {
+        xtensorf3x4 a({3, 4}, uninitialized);
+        auto b = xtensorf3x4::from_shape({3, 4}, uninitialized);
+        b.resize({3, 4}, uninitialized);
+        a.fill(1.);
+        b.fill(1.);
+        EXPECT_EQ(a, b);
+    }
+
     TEST(xtensor_fixed, layout)
     {
         xtensor_fixed<double, xshape<2, 2>, layout_type::row_major> a;
@@ -10,6 +10,7 @@
 #include <limits>
 
 #include "gtest/gtest.h"
+#include "xtensor/xbuilder.hpp"
 #include "xtensor/xtensor.hpp"
 #include "xtensor/xhistogram.hpp"
 #include "xtensor/xrandom.hpp"
@@ -54,4 +55,63 @@ namespace xt
         EXPECT_EQ(bc3.size(), std::size_t(10));
         EXPECT_EQ(bc3(3), expc(3));
     }
+
+    namespace
+    {
+        // bin index following the semantics of histogram: the last bin is
+        // closed, values equal to an inner edge belong to the upper bin
+        template <class E>
+        std::size_t reference_bin(double v, const E& edges)
+        {
+            std::size_t ibin = 0;
+            while (ibin < edges.size() - 2 && v >= edges[ibin + 1])
+            {
+                ++ibin;
+            }
+            return ibin;
+        }
+    }
+
+    TEST(xhistogram, bin_lookup)
+    {
+        xt::xtensor<double, 1> data = xt::linspace<double>(0., 10., 1001);
+        xt::xtensor<double, 1> uniform_edges = xt::linspace<double>(0., 10., 8);
+        xt::xtensor<double, 1> irregular_edges = {0., 0.5, 0.5, 2., 3.25, 7., 9.99, 10.};
+
+        for (const auto& edges : {uniform_edges, irregular_edges})
+        {
+            xt::xtensor<double, 1> expected = xt::zeros<double>({edges.size() - 1});
+            for (auto v : data)
+            {
+                expected[reference_bin(v, edges)] += 1.;
+            }
+            xt::xtensor<double, 1> count = xt::histogram(data, edges);
+            EXPECT_EQ(count, expected);
+        }
+    }
+
+    TEST(xhistogram, large)
+    {
+        std::size_t n = 200000;
+        xt::xtensor<double, 1> data = xt::xtensor<double, 1>::from_shape({n});
+        xt::xtensor<int, 1> idata = xt::xtensor<int, 1>::from_shape({n});
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            data[i] = double((i * 7919) % 1000) / 10.;
+            idata[i] = int((i * 7919) % 37);
+        }
+        xt::xtensor<double, 1> edges = xt::linspace<double>(0., 100., 21);
+
+        xt::xtensor<double, 1> expected = xt::zeros<double>({std::size_t(20)});
+        xt::xtensor<int, 1> expected_bc = xt::zeros<int>({std::size_t(37)});
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            expected[reference_bin(data[i], edges)] += 1.;
+            expected_bc[std::size_t(idata[i])] += 1;
+        }
+
+        xt::xtensor<double, 1> count = xt::histogram(data, edges);
+        EXPECT_EQ(count, expected);
+        EXPECT_EQ(bincount(idata), expected_bc);
+    }
 }
@@ -12,6 +12,7 @@
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xindex_view.hpp"
 #include "xtensor/xbroadcast.hpp"
+#include "xtensor/xtensor.hpp"
 #include "xtensor/xview.hpp"
 #include "test_common.hpp"
 
@@ -162,4 +163,56 @@ namespace xt
         xarray<double> expected = {{1, 2, 3}, {5, 7, 9}};
         EXPECT_EQ(expected, b);
     }
+
+    TEST(xindex_view, filter_flat)
+    {
+        xtensor<int, 2> a = {{1, 5, 3}, {4, 5, 6}};
+        auto v = filter(a, a >= 5);
+        bool flat = std::is_same<decltype(v)::indices_type, std::vector<xflat_index>>::value;
+        EXPECT_TRUE(flat);
+        ASSERT_EQ(v.size(), 3u);
+        EXPECT_EQ(v(0), 5);
+        EXPECT_EQ(v(2), 6);
+        v += 10;
+        xtensor<int, 2> expected = {{1, 15, 3}, {4, 15, 16}};
+        EXPECT_EQ(expected, a);
+
+        // Condition broadcast on the last dimensions
+        xtensor<int, 1> cond = {0, 1, 1};
+        auto vb = filter(a, cond);
+        ASSERT_EQ(vb.size(), 2u);
+        EXPECT_EQ(vb(0), 15);
+        EXPECT_EQ(vb(1), 3);
+
+        // Column-major containers use multi-dimensional indices
+        xarray<int, layout_type::column_major> c = {{1, 5, 3}, {4, 5, 6}};
+        auto vc = filter(c, c >= 5);
+        xarray<int> expected_c = {5, 5, 6};
+        EXPECT_EQ(vc, expected_c);
+
+        auto vs = filter(view(a, all(), range(1, 3)), view(a, all(), range(1, 3)) > 10);
+        xarray<int> expected_s = {15, 15, 16};
+        EXPECT_EQ(vs, expected_s);
+    }
+
+    TEST(xindex_view, extract)
+    {
+        xarray<double> a = {{1, 5, 3}, {4, 5, 6}};
+        xtensor<double, 1> res = extract(a >= 5, a);
+        xtensor<double, 1> expected = {5, 5, 6};
+        EXPECT_EQ(expected, res);
+        EXPECT_EQ(extract(a > 10, a).size(), 0u);
+
+        xarray<double, layout_type::column_major> c = a;
+        EXPECT_EQ(expected, extract(c >= 5, 2. * c - c));
+
+        xarray<double> large = arange<double>(1000.);
+        auto odd = extract(large - 2. * floor(large / 2.) > 0.5, large);
+        ASSERT_EQ(odd.size(), 500u);
+        EXPECT_EQ(odd(0), 1.);
+        EXPECT_EQ(odd(499), 999.);
+
+        xarray<double> wrong = {1., 2.};
+        EXPECT_THROW(extract(wrong > 0, a), std::runtime_error);
+    }
 }
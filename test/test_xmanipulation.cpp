@@ -14,6 +14,8 @@
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xmanipulation.hpp"
 
+#include <numeric>
+
 namespace xt
 {
     TEST(xstrided_view, transpose_assignment)
@@ -77,6 +79,65 @@ namespace xt
         EXPECT_EQ(fun2(1, 2), tr2(2, 1));
     }
 
+    TEST(xstrided_view, transpose_eval)
+    {
+        xtensor<double, 2> a = xt::zeros<double>({70, 45});
+        std::iota(a.begin(), a.end(), 0.);
+        xtensor<double, 2> at = transpose(a);
+        ASSERT_EQ(at.shape()[0], 45u);
+        bool equal = true;
+        for (std::size_t i = 0; i < 70; ++i)
+        {
+            for (std::size_t j = 0; j < 45; ++j)
+            {
+                equal = equal && at(j, i) == a(i, j);
+            }
+        }
+        EXPECT_TRUE(equal);
+
+        xarray<int> b = xt::arange<int>(5 * 40 * 3 * 37);
+        b.reshape({5, 40, 3, 37});
+        xarray<double> bt = transpose(b, {3, 0, 2, 1});
+        xarray<double, layout_type::column_major> bc = b;
+        equal = true;
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+            for (std::size_t j = 0; j < 40; ++j)
+            {
+                for (std::size_t k = 0; k < 3; ++k)
+                {
+                    for (std::size_t l = 0; l < 37; ++l)
+                    {
+                        equal = equal && bt(l, i, k, j) == b(i, j, k, l) && bc(i, j, k, l) == b(i, j, k, l);
+                    }
+                }
+            }
+        }
+        EXPECT_TRUE(equal);
+
+        xtensor<double, 2, layout_type::column_major> c = a;
+        EXPECT_EQ(c, a);
+        xtensor<double, 2> d = transpose(c);
+        EXPECT_EQ(d, at);
+    }
+
+    TEST(xstrided_view, transpose_eval_empty)
+    {
+        xarray<double> a = empty<double>({0, 5});
+        xarray<double> b = transpose(a);
+        EXPECT_EQ(b.shape()[0], 5u);
+        EXPECT_EQ(b.shape()[1], 0u);
+
+        xarray<double, layout_type::column_major> c = empty<double>({0, 3});
+        xarray<double, layout_type::row_major> d = c;
+        EXPECT_EQ(d.size(), 0u);
+
+        xtensor<double, 3> e = empty<double>({4, 0, 2});
+        xtensor<double, 3> et = transpose(e);
+        EXPECT_EQ(et.shape()[2], 4u);
+        EXPECT_EQ(et.size(), 0u);
+    }
+
     TEST(xstrided_view, ravel)
     {
         xarray<int, layout_type::row_major> a = { { 0, 1, 2 },{ 3, 4, 5 } };
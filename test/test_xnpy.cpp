@@ -9,7 +9,10 @@
 #include "gtest/gtest.h"
 
 #include "xtensor/xnpy.hpp"
+#include "xtensor/xnpy_mmap.hpp"
 #include "xtensor/xarray.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
 
 #include <fstream>
 #include <cstdint>
@@ -116,4 +119,143 @@ namespace xt
         xarray<char> adc = dc;
         EXPECT_EQ(adc(0, 0), 0);
     }
-}
\ No newline at end of file
+
+    TEST(xnpy, load_mmap)
+    {
+        auto darr = load_npy<double>("files/xnpy_files/double.npy");
+        auto darr_mapped = load_npy_mmap<double>("files/xnpy_files/double.npy");
+        EXPECT_EQ(darr.shape(), darr_mapped.shape());
+        EXPECT_TRUE(all(equal(darr, darr_mapped)));
+
+        auto dfarr = load_npy<double, layout_type::column_major>("files/xnpy_files/double_fortran.npy");
+        auto dfarr_mapped = load_npy_mmap<double, mmap_mode::read_only, layout_type::column_major>("files/xnpy_files/double_fortran.npy");
+        EXPECT_TRUE(all(equal(dfarr, dfarr_mapped)));
+
+        // The mapping outlives a copy of the allocator
+        auto ularr_mapped = load_npy_mmap<uint64_t>("files/xnpy_files/unsignedlong.npy");
+        xarray<uint64_t> ularr = ularr_mapped;
+        EXPECT_EQ(ularr(4), 1234321ul);
+
+        EXPECT_THROW(load_npy_mmap<float>("files/xnpy_files/double.npy"), std::runtime_error);
+        EXPECT_THROW(load_npy_mmap<double>("files/xnpy_files/unexisting.npy"), std::runtime_error);
+    }
+
+    TEST(xnpy, load_mmap_copy_on_write)
+    {
+        std::string filename = get_filename();
+        xtensor<double, 2> arr = {{1., 2., 3.}, {4., 5., 6.}};
+        dump_npy(filename, arr);
+
+        {
+            auto mapped = load_npy_mmap<double, mmap_mode::copy_on_write>(filename);
+            mapped(1, 1) = -5.;
+            mapped += 1.;
+            EXPECT_EQ(mapped(0, 0), 2.);
+            EXPECT_EQ(mapped(1, 1), -4.);
+
+            auto read_only = load_npy_mmap<double>(filename);
+            EXPECT_EQ(read_only(1, 1), 5.);
+
+            // A resize falls back to a heap allocated buffer
+            mapped.resize({4, 3});
+            mapped.fill(0.);
+            EXPECT_EQ(mapped(3, 2), 0.);
+        }
+
+        auto reloaded = load_npy<double>(filename);
+        EXPECT_TRUE(all(equal(arr, reloaded)));
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpy, reader)
+    {
+        auto darr = load_npy<double>("files/xnpy_files/double.npy");
+
+        npy_reader<double> reader("files/xnpy_files/double.npy", 2);
+        EXPECT_EQ(reader.shape(), std::vector<std::size_t>({3, 3, 3}));
+        EXPECT_EQ(reader.chunk_rows(), 2u);
+
+        EXPECT_EQ(reader.read_chunk(), 2u);
+        EXPECT_EQ(reader.chunk().shape(), std::vector<std::size_t>({2, 3, 3}));
+        EXPECT_TRUE(all(equal(reader.chunk(), view(darr, range(0, 2)))));
+
+        EXPECT_EQ(reader.read_chunk(), 1u);
+        EXPECT_EQ(reader.chunk().shape(), std::vector<std::size_t>({1, 3, 3}));
+        EXPECT_TRUE(all(equal(reader.chunk(), view(darr, range(2, 3)))));
+        EXPECT_EQ(reader.rows_read(), 3u);
+
+        EXPECT_EQ(reader.read_chunk(), 0u);
+
+        reader.rewind();
+        EXPECT_EQ(reader.read_chunk(), 2u);
+        EXPECT_EQ(reader.chunk()(1, 2, 0), darr(1, 2, 0));
+
+        EXPECT_THROW(npy_reader<float>("files/xnpy_files/double.npy"), std::runtime_error);
+        EXPECT_THROW(npy_reader<double>("files/xnpy_files/double_fortran.npy"), std::runtime_error);
+    }
+
+    TEST(xnpy, reader_fortran_1d)
+    {
+        std::string filename = get_filename();
+        std::vector<double> values = {1., 2., 3., 4., 5.};
+        {
+            std::ofstream stream(filename, std::ofstream::binary);
+            detail::write_header(stream, detail::build_typestring<double>(), true, std::vector<std::size_t>({5}));
+            stream.write(reinterpret_cast<const char*>(values.data()), std::streamsize(values.size() * sizeof(double)));
+        }
+
+        {
+            npy_reader<double> reader(filename, 3);
+            EXPECT_EQ(reader.read_chunk(), 3u);
+            EXPECT_EQ(reader.chunk()(2), 3.);
+            EXPECT_EQ(reader.read_chunk(), 2u);
+            EXPECT_EQ(reader.chunk()(1), 5.);
+        }
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpy, appender)
+    {
+        std::string filename = get_filename();
+        xtensor<int, 2> expected = {{0, 1, 2}, {3, 4, 5}, {6, 7, 8}, {9, 10, 11}};
+
+        {
+            npy_appender<int> appender(filename, std::vector<std::size_t>({3}));
+            xtensor<int, 1> row = {0, 1, 2};
+            appender.append(row);
+            appender.append(view(expected, range(1, 3)));
+            appender.append(xtensor<double, 2>({{9., 10., 11.}}));
+            EXPECT_EQ(appender.rows(), 4u);
+            EXPECT_THROW(appender.append(xtensor<int, 1>({1, 2})), std::runtime_error);
+        }
+
+        auto loaded = load_npy<int>(filename);
+        EXPECT_EQ(loaded.shape(), std::vector<std::size_t>({4, 3}));
+        EXPECT_TRUE(all(equal(loaded, expected)));
+
+        // The header of the closed file is the one written by dump_npy
+        std::string dumped = get_filename();
+        dump_npy(dumped, expected);
+        std::ifstream dumped_stream(dumped, std::ios::binary);
+        detail::npy_header dumped_header = detail::read_npy_header(dumped_stream);
+        std::ifstream appended_stream(filename, std::ios::binary);
+        detail::npy_header appended_header = detail::read_npy_header(appended_stream);
+        EXPECT_EQ(dumped_header.m_shape, appended_header.m_shape);
+        EXPECT_EQ(dumped_header.m_typestring, appended_header.m_typestring);
+        EXPECT_EQ(appended_stream.tellg() % 16, 0);
+
+        std::remove(filename.c_str());
+        std::remove(dumped.c_str());
+
+        filename = get_filename();
+        {
+            npy_appender<double> appender(filename);
+            appender.append(xtensor<double, 0>(3.5));
+            appender.append(xtensor<double, 1>({1.5, 2.5}));
+            appender.close();
+        }
+        auto scalars = load_npy<double>(filename);
+        EXPECT_EQ(scalars, xarray<double>({3.5, 1.5, 2.5}));
+        std::remove(filename.c_str());
+    }
+}
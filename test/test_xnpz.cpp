@@ -0,0 +1,111 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xnpz.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xtensor.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace xt
+{
+    namespace
+    {
+        std::string get_npz_filename()
+        {
+            std::string filename = std::tmpnam(nullptr);
+            filename += ".npz";
+            return filename;
+        }
+    }
+
+    TEST(xnpz, stored)
+    {
+        std::string filename = get_npz_filename();
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xtensor<int, 1> b = {7, 8, 9, 10};
+        xarray<bool> c = {true, false, true};
+
+        dump_npz(filename, npz_compression::stored, "a", a, "b", b, "c", c);
+
+        npz_archive archive = load_npz(filename);
+        EXPECT_EQ(archive.names(), std::vector<std::string>({"a", "b", "c"}));
+        EXPECT_TRUE(archive.contains("b"));
+        EXPECT_FALSE(archive.contains("d"));
+        EXPECT_EQ(archive.compression("a"), npz_compression::stored);
+
+        auto a_loaded = archive.load<double>("a");
+        EXPECT_EQ(a_loaded, a);
+        EXPECT_EQ(archive.load<int>("b"), b);
+        EXPECT_EQ(archive.load<bool>("c"), c);
+        EXPECT_EQ(load_npz<int>(filename, "b"), b);
+
+        // Stored members are aligned and can be mapped
+        auto a_mapped = archive.load_mmap<double>("a");
+        EXPECT_EQ(a_mapped, a);
+        auto b_mapped = archive.load_mmap<int, mmap_mode::copy_on_write>("b");
+        b_mapped(0) = 0;
+        EXPECT_EQ(archive.load<int>("b"), b);
+
+        EXPECT_THROW(archive.load<double>("d"), std::runtime_error);
+        EXPECT_THROW(archive.load<float>("a"), std::runtime_error);
+        std::remove(filename.c_str());
+    }
+
+    TEST(xnpz, writer)
+    {
+        std::string filename = get_npz_filename();
+        xarray<int> big = arange<int>(1000);
+        {
+            npz_writer writer(filename);
+            for (std::size_t i = 0; i < 20; ++i)
+            {
+                writer.add("a" + std::to_string(i), big + static_cast<int>(i));
+            }
+        }
+
+        npz_archive archive(filename);
+        EXPECT_EQ(archive.names().size(), 20u);
+        EXPECT_EQ(archive.load<int>("a13"), big + 13);
+        std::remove(filename.c_str());
+
+        EXPECT_THROW(npz_archive("files/xnpy_files/double.npy"), std::runtime_error);
+    }
+
+#if defined(XTENSOR_USE_ZLIB)
+    TEST(xnpz, deflated)
+    {
+        std::string filename = get_npz_filename();
+        xarray<double> a = {{1., 2., 3.}, {4., 5., 6.}};
+        xarray<std::int64_t> b = arange<std::int64_t>(10000) % 7;
+
+        // Members are compressed by batches of one member per thread
+        set_num_threads(4);
+        {
+            npz_writer writer(filename, npz_compression::deflated);
+            writer.add("a", a);
+            writer.add("b", b);
+        }
+        set_num_threads(0);
+
+        std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+        EXPECT_LT(static_cast<std::size_t>(stream.tellg()), b.size() * sizeof(std::int64_t) / 4);
+
+        npz_archive archive(filename);
+        EXPECT_EQ(archive.compression("b"), npz_compression::deflated);
+        EXPECT_EQ(archive.load<double>("a"), a);
+        EXPECT_EQ(archive.load<std::int64_t>("b"), b);
+        EXPECT_THROW(archive.load_mmap<double>("a"), std::runtime_error);
+        std::remove(filename.c_str());
+    }
+#endif
+}
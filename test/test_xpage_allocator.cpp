@@ -0,0 +1,63 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xpage_allocator.hpp"
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xmath.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace xt
+{
+    using huge_array = xarray<double, XTENSOR_DEFAULT_LAYOUT, huge_page_allocator<double>>;
+
+    TEST(xpage_allocator, allocate)
+    {
+        huge_page_allocator<double> alloc;
+        std::size_t huge_size = XTENSOR_HUGE_PAGE_THRESHOLD / sizeof(double);
+        EXPECT_FALSE(alloc.is_huge(0));
+        EXPECT_FALSE(alloc.is_huge(100));
+        EXPECT_TRUE(alloc.is_huge(huge_size));
+
+        double* small = alloc.allocate(100);
+        small[99] = 1.;
+        alloc.deallocate(small, 100);
+
+        double* large = alloc.allocate(huge_size + 3);
+#if defined(__linux__)
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) % XTENSOR_HUGE_PAGE_SIZE, 0u);
+#endif
+        large[0] = 1.;
+        large[huge_size + 2] = 2.;
+        EXPECT_EQ(large[0] + large[huge_size + 2], 3.);
+        alloc.deallocate(large, huge_size + 3);
+
+        huge_page_allocator<float>::rebind<int>::other int_alloc(alloc);
+        EXPECT_TRUE(int_alloc == huge_page_allocator<int>());
+    }
+
+    TEST(xpage_allocator, container)
+    {
+        std::size_t n = 2 * XTENSOR_HUGE_PAGE_THRESHOLD / sizeof(double);
+        set_num_threads(4);
+        huge_array a = arange<double>(static_cast<double>(n));
+        huge_array b = a * 2.;
+        set_num_threads(0);
+        EXPECT_EQ(b(n - 1), 2. * static_cast<double>(n - 1));
+        EXPECT_EQ(sum(b)(), static_cast<double>(n) * static_cast<double>(n - 1));
+
+        std::vector<int, huge_page_allocator<int>> v(10, 3);
+        v.resize(n);
+        EXPECT_EQ(v[9], 3);
+        EXPECT_EQ(v[n - 1], 0);
+    }
+}
@@ -0,0 +1,371 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xindex_view.hpp"
+#include "xtensor/xmanipulation.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xnoalias.hpp"
+#include "xtensor/xnorm.hpp"
+#include "xtensor/xparallel.hpp"
+#include "xtensor/xrandom.hpp"
+#include "xtensor/xreducer.hpp"
+#include "xtensor/xsort.hpp"
+#include "xtensor/xtensor.hpp"
+#include "xtensor/xview.hpp"
+
+namespace xt
+{
+    // Large enough to be above XTENSOR_PARALLEL_THRESHOLD
+    constexpr std::size_t parallel_rows = 300;
+    constexpr std::size_t parallel_cols = 500;
+
+    inline xtensor<double, 2> make_parallel_input()
+    {
+        xtensor<double, 2> a = xtensor<double, 2>::from_shape({parallel_rows, parallel_cols});
+        std::iota(a.storage().begin(), a.storage().end(), 0.);
+        return a;
+    }
+
+    TEST(xparallel, parallel_for)
+    {
+        std::vector<std::atomic<int>> hits(1003);
+        for (auto& h : hits)
+        {
+            h = 0;
+        }
+        parallel_for(3, hits.size(), 10, [&hits](std::size_t first, std::size_t last)
+        {
+            EXPECT_EQ((first - 3) % 10, 0u);
+            for (std::size_t i = first; i < last; ++i)
+            {
+                ++hits[i];
+            }
+        });
+        for (std::size_t i = 0; i < hits.size(); ++i)
+        {
+            EXPECT_EQ(hits[i].load(), i < 3 ? 0 : 1);
+        }
+    }
+
+    TEST(xparallel, num_threads)
+    {
+        std::size_t n = num_threads();
+        EXPECT_GE(n, 1u);
+        set_num_threads(2);
+#if defined(XTENSOR_PARALLEL)
+        EXPECT_EQ(num_threads(), 2u);
+#else
+        EXPECT_EQ(num_threads(), 1u);
+#endif
+        set_num_threads(0);
+        EXPECT_EQ(num_threads(), n);
+    }
+
+    TEST(xparallel, is_parallel_safe)
+    {
+        xarray<double> a = {1., 2.};
+        auto f = a + a;
+        EXPECT_TRUE(is_parallel_safe<decltype(f)>::value);
+        auto r = a + random::rand<double>({2});
+        EXPECT_FALSE(is_parallel_safe<decltype(r)>::value);
+    }
+
+    TEST(xparallel, linear_assign)
+    {
+        xtensor<double, 2> a = make_parallel_input();
+        xtensor<double, 2> b = 2. * a + 1.;
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            ASSERT_EQ(b.storage()[i], 2. * a.storage()[i] + 1.);
+        }
+
+        xarray<int> c = a;
+        c += 3;
+        EXPECT_EQ(c(parallel_rows - 1, parallel_cols - 1), int(parallel_rows * parallel_cols + 2));
+    }
+
+    TEST(xparallel, strided_assign)
+    {
+        xtensor<double, 2> a = make_parallel_input();
+        xtensor<double, 2> b = zeros<double>({parallel_rows, parallel_cols / 2});
+        noalias(b) = view(a, all(), range(0, parallel_cols / 2)) * 2.;
+        for (std::size_t i = 0; i < parallel_rows; ++i)
+        {
+            for (std::size_t j = 0; j < parallel_cols / 2; ++j)
+            {
+                ASSERT_EQ(b(i, j), 2. * a(i, j));
+            }
+        }
+    }
+
+    TEST(xparallel, stepper_assign)
+    {
+        xtensor<double, 2> a = make_parallel_input();
+        xtensor<double, 2> b = transpose(a);
+        xtensor<double, 2, layout_type::column_major> c = a;
+        xtensor<double, 1> v = arange<double>(parallel_cols);
+        xarray<double> d = a + v;
+        for (std::size_t i = 0; i < parallel_rows; ++i)
+        {
+            for (std::size_t j = 0; j < parallel_cols; ++j)
+            {
+                ASSERT_EQ(b(j, i), a(i, j));
+                ASSERT_EQ(c(i, j), a(i, j));
+                ASSERT_EQ(d(i, j), a(i, j) + v(j));
+            }
+        }
+    }
+
+    TEST(xparallel, transposed_assign)
+    {
+        set_num_threads(4);
+        xtensor<double, 2> a = make_parallel_input();
+        xtensor<double, 2> b = transpose(a);
+        xtensor<double, 3> a3 = xtensor<double, 3>::from_shape({parallel_rows / 3, 3, parallel_cols});
+        std::copy(a.storage().cbegin(), a.storage().cend(), a3.storage().begin());
+        xtensor<double, 3, layout_type::column_major> c = transpose(a3, {1, 2, 0});
+        for (std::size_t i = 0; i < parallel_rows; ++i)
+        {
+            for (std::size_t j = 0; j < parallel_cols; ++j)
+            {
+                ASSERT_EQ(b(j, i), a(i, j));
+                ASSERT_EQ(c(i % 3, j, i / 3), a(i, j));
+            }
+        }
+        set_num_threads(0);
+    }
+
+    TEST(xparallel, strided_data_assign)
+    {
+        set_num_threads(4);
+        xtensor<double, 2> a = make_parallel_input();
+        xtensor<double, 2> b = view(a, all(), range(0, parallel_cols, 2));
+        xtensor<double, 2> c = zeros<double>({parallel_rows, parallel_cols});
+        view(c, range(0, parallel_rows, 2), all()) = view(a, range(0, parallel_rows, 2), all());
+        for (std::size_t i = 0; i < parallel_rows; ++i)
+        {
+            for (std::size_t j = 0; j < parallel_cols; ++j)
+            {
+                ASSERT_EQ(c(i, j), i % 2 == 0 ? a(i, j) : 0.);
+                if (j % 2 == 0)
+                {
+                    ASSERT_EQ(b(i, j / 2), a(i, j));
+                }
+            }
+        }
+        set_num_threads(0);
+    }
+
+    TEST(xparallel, compaction)
+    {
+        set_num_threads(4);
+        xtensor<double, 2> a = make_parallel_input();
+        auto mask = a - 3. * floor(a / 3.) < 0.5;
+        std::vector<std::size_t> flat = flatnonzero<layout_type::row_major>(mask);
+        auto indices = argwhere(mask);
+        xtensor<double, 1> values = extract(mask, a);
+        auto v = filter(a, mask);
+        std::size_t n = (parallel_rows * parallel_cols + 2) / 3;
+        ASSERT_EQ(flat.size(), n);
+        ASSERT_EQ(indices.size(), n);
+        ASSERT_EQ(values.size(), n);
+        ASSERT_EQ(v.size(), n);
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            ASSERT_EQ(flat[k], 3 * k);
+            ASSERT_EQ(indices[k][0], 3 * k / parallel_cols);
+            ASSERT_EQ(indices[k][1], 3 * k % parallel_cols);
+            ASSERT_EQ(values(k), double(3 * k));
+            ASSERT_EQ(v(k), double(3 * k));
+        }
+        set_num_threads(0);
+    }
+
+    TEST(xparallel, accumulate)
+    {
+        set_num_threads(4);
+        xtensor<double, 2> a = make_parallel_input();
+        auto rows = cumsum(a, 1);
+        auto cols = cumsum(a, 0);
+        for (std::size_t i = 0; i < parallel_rows; ++i)
+        {
+            double first = a(i, 0);
+            for (std::size_t j = 0; j < parallel_cols; ++j)
+            {
+                ASSERT_EQ(rows(i, j), double(j + 1) * (first + double(j) / 2.));
+                ASSERT_EQ(cols(i, j), double(i + 1) * (double(j) + double(i * parallel_cols) / 2.));
+            }
+        }
+
+        // Few long lines, scanned with the two-phase block scan
+        xtensor<long long, 1> b = arange<long long>(static_cast<long long>(parallel_rows * parallel_cols));
+        auto flat = cumsum(b);
+        auto mul = cumprod(b - b + 1);
+        for (std::size_t k = 0; k < b.size(); ++k)
+        {
+            ASSERT_EQ(flat(k), static_cast<long long>(k * (k + 1) / 2));
+            ASSERT_EQ(mul(k), 1);
+        }
+        set_num_threads(0);
+    }
+
+    TEST(xparallel, computed_assign)
+    {
+        xtensor<double, 1> a = arange<double>(parallel_cols);
+        xtensor<double, 2> b = ones<double>({parallel_rows, std::size_t(1)});
+        // broadcasting b into a temporary of shape (parallel_rows, parallel_cols)
+        b += a;
+        ASSERT_EQ(b.shape()[1], parallel_cols);
+        for (std::size_t i = 0; i < parallel_rows; ++i)
+        {
+            for (std::size_t j = 0; j < parallel_cols; ++j)
+            {
+                ASSERT_EQ(b(i, j), a(j) + 1.);
+            }
+        }
+    }
+
+    TEST(xparallel, random_assign)
+    {
+        random::seed(0);
+        xtensor<double, 1> a = 2. * random::rand<double>({parallel_rows * parallel_cols});
+        random::seed(0);
+        xtensor<double, 1> b = random::rand<double>({parallel_rows * parallel_cols});
+        EXPECT_EQ(a, 2. * b);
+    }
+
+    TEST(xparallel, reduce_full)
+    {
+        xtensor<double, 2> a = make_parallel_input();
+        double n = double(a.size());
+        double expected = n * (n - 1.) / 2.;
+        EXPECT_EQ(sum(a, evaluation_strategy::immediate())(), expected);
+        EXPECT_EQ(sum(a)(), expected);
+        EXPECT_EQ(amax(a, evaluation_strategy::immediate())(), n - 1.);
+        EXPECT_EQ(amin(a)(), 0.);
+        EXPECT_EQ(mean(a, evaluation_strategy::immediate())(), (n - 1.) / 2.);
+        EXPECT_EQ(count_nonzero(a, evaluation_strategy::immediate())(), a.size() - 1);
+        EXPECT_NEAR(norm_l2(a)(), std::sqrt(sum(a * a)()), 1e-6);
+    }
+
+    template <layout_type L>
+    void check_parallel_axis_reductions()
+    {
+        using tensor_type = xtensor<double, 3, L>;
+        tensor_type a = tensor_type::from_shape({40, 50, 60});
+        std::iota(a.storage().begin(), a.storage().end(), 0.);
+
+        std::vector<std::vector<std::size_t>> all_axes = {{0}, {1}, {2}, {0, 1}, {0, 2}, {1, 2}};
+        for (const auto& axes : all_axes)
+        {
+            xarray<double> expected = sum(a, axes);
+            xarray<double> res = sum(a, axes, evaluation_strategy::immediate());
+            EXPECT_EQ(res, expected);
+
+            xarray<double> expected_max = amax(a, axes);
+            xarray<double> res_max = amax(a, axes, evaluation_strategy::immediate());
+            EXPECT_EQ(res_max, expected_max);
+        }
+
+        xtensor<double, 2> b = sum(a, {1}, evaluation_strategy::immediate());
+        for (std::size_t i = 0; i < 40; ++i)
+        {
+            for (std::size_t k = 0; k < 60; ++k)
+            {
+                double expected = 0.;
+                for (std::size_t j = 0; j < 50; ++j)
+                {
+                    expected += a(i, j, k);
+                }
+                ASSERT_EQ(b(i, k), expected);
+            }
+        }
+    }
+
+    TEST(xparallel, reduce_axes)
+    {
+        check_parallel_axis_reductions<layout_type::row_major>();
+        check_parallel_axis_reductions<layout_type::column_major>();
+    }
+
+    TEST(xparallel, lazy_reduce)
+    {
+        xtensor<double, 2> a = make_parallel_input();
+        xtensor<double, 3> b = xtensor<double, 3>::from_shape({2, parallel_rows, parallel_cols});
+        std::copy(a.storage().cbegin(), a.storage().cend(), b.storage().begin());
+        std::copy(a.storage().cbegin(), a.storage().cend(), b.storage().begin() + std::ptrdiff_t(a.size()));
+
+        xtensor<double, 1> res = sum(b + 1., {1, 2});
+        double n = double(a.size());
+        double expected = n * (n + 1.) / 2.;
+        EXPECT_EQ(res(0), expected);
+        EXPECT_EQ(res(1), expected);
+
+        xtensor<double, 1> res_max = amax(b, {1, 2});
+        EXPECT_EQ(res_max(0), n - 1.);
+        EXPECT_EQ(res_max(1), n - 1.);
+    }
+
+    template <class T>
+    void check_parallel_sort(const xtensor<T, 1>& a)
+    {
+        std::vector<T> expected(a.cbegin(), a.cend());
+        std::sort(expected.begin(), expected.end());
+
+        xtensor<T, 1> sa = sort(a, xnone());
+        EXPECT_TRUE(std::equal(sa.cbegin(), sa.cend(), expected.cbegin()));
+
+        xtensor<std::size_t, 1> ia = argsort(a, xnone(), sorting_method::stable);
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            ASSERT_EQ(a(ia(i)), expected[i]);
+            if (i > 0 && a(ia(i)) == a(ia(i - 1)))
+            {
+                ASSERT_LT(ia(i - 1), ia(i));
+            }
+        }
+
+        xtensor<std::size_t, 1> qa = argsort(a, xnone());
+        for (std::size_t i = 0; i < a.size(); ++i)
+        {
+            ASSERT_EQ(a(qa(i)), expected[i]);
+        }
+    }
+
+    TEST(xparallel, sort)
+    {
+        set_num_threads(4);
+        std::size_t n = parallel_rows * parallel_cols + 17;
+        random::seed(0);
+        xtensor<int, 1> ints = random::randint<int>({n}, -1000, 1000);
+        check_parallel_sort(ints);
+
+        xtensor<std::uint8_t, 1> bytes = cast<std::uint8_t>(random::randint<int>({n}, 0, 3));
+        check_parallel_sort(bytes);
+
+        xtensor<double, 1> doubles = random::randn<double>({n});
+        doubles(3) = 0.;
+        doubles(4) = -0.;
+        check_parallel_sort(doubles);
+
+        xtensor<float, 1> floats = cast<float>(doubles);
+        check_parallel_sort(floats);
+
+        xtensor<long double, 1> long_doubles = cast<long double>(ints);
+        check_parallel_sort(long_doubles);
+        set_num_threads(0);
+    }
+}
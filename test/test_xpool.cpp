@@ -0,0 +1,128 @@
+/***************************************************************************
+* Copyright (c) 2016, Johan Mabille, Sylvain Corlay and Wolf Vollprecht    *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "xtensor/xpool.hpp"
+#include "xtensor/xbuilder.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace xt
+{
+    TEST(xpool, recycling)
+    {
+        tensor_pool pool;
+        const float* data = nullptr;
+        {
+            auto a = pool.make_tensor<float, 3>({4, 5, 6});
+            EXPECT_EQ(a.size(), 120u);
+            EXPECT_EQ(a.strides()[0], 30u);
+            a.fill(1.f);
+            data = a.data();
+        }
+        pool_statistics st = pool.statistics();
+        EXPECT_EQ(st.misses, 1u);
+        EXPECT_EQ(st.releases, 1u);
+        EXPECT_EQ(st.cached_buffers, 1u);
+        EXPECT_EQ(st.cached_bytes, 120u * sizeof(float));
+
+        {
+            auto b = pool.make_tensor<float, 3, layout_type::column_major>({6, 5, 4});
+            EXPECT_EQ(b.data(), data);
+            EXPECT_EQ(b.strides()[1], 6u);
+            b = xt::ones<float>({6, 5, 4});
+            EXPECT_EQ(b(5, 4, 3), 1.f);
+
+            auto c = pool.make_array<int>({2, 3});
+            EXPECT_EQ(c.shape().size(), 2u);
+            c = xt::zeros<int>({2, 3});
+            EXPECT_EQ(c(1, 2), 0);
+
+            // Containers that are not made by a pool use the default pool
+            pooled_tensor<float, 3, layout_type::column_major> d = b + b;
+            EXPECT_EQ(d(1, 1, 1), 2.f);
+        }
+        st = pool.statistics();
+        EXPECT_EQ(st.hits, 1u);
+        EXPECT_EQ(st.misses, 2u);
+        EXPECT_EQ(st.cached_buffers, 2u);
+
+        pool.clear();
+        EXPECT_EQ(pool.statistics().cached_buffers, 0u);
+        EXPECT_EQ(pool.statistics().cached_bytes, 0u);
+
+        pool.reset_statistics();
+        EXPECT_EQ(pool.statistics().hits, 0u);
+    }
+
+    TEST(xpool, default_pool)
+    {
+        default_tensor_pool().clear();
+        default_tensor_pool().reset_statistics();
+        {
+            pooled_tensor<double, 2> a({3, 3}, 1.);
+            pooled_tensor<double, 2> b({3, 3}, 2.);
+        }
+        pooled_tensor<double, 2> c = pooled_tensor<double, 2>::from_shape({9, 1});
+        EXPECT_EQ(default_tensor_pool().statistics().hits, 1u);
+        EXPECT_EQ(default_tensor_pool().statistics().cached_buffers, 1u);
+    }
+
+    TEST(xpool, dimension_mismatch)
+    {
+        tensor_pool pool;
+        EXPECT_THROW(pool.make_tensor<float, 3>({2, 3, 4, 5}), std::runtime_error);
+        EXPECT_THROW(pool.make_tensor<float, 3>({2, 3}), std::runtime_error);
+        auto a = pool.make_array<float>({2, 3, 4, 5});
+        EXPECT_EQ(a.dimension(), 4u);
+    }
+
+    TEST(xpool, max_cached_bytes)
+    {
+        tensor_pool pool(100 * sizeof(double));
+        {
+            auto a = pool.make_tensor<double, 1>({60});
+            auto b = pool.make_tensor<double, 1>({60});
+        }
+        pool_statistics st = pool.statistics();
+        EXPECT_EQ(st.releases, 1u);
+        EXPECT_EQ(st.cached_bytes, 60 * sizeof(double));
+    }
+
+    TEST(xpool, threads)
+    {
+        tensor_pool pool;
+        std::vector<std::thread> threads;
+        for (std::size_t t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&pool]() {
+                for (std::size_t i = 0; i < 100; ++i)
+                {
+                    auto a = pool.make_tensor<float, 2>({8, 8});
+                    a.fill(float(i));
+                    auto b = pool.make_array<float>({8, 8});
+                    b = a + a;
+                }
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        pool_statistics st = pool.statistics();
+        EXPECT_EQ(st.hits + st.misses, st.releases);
+        EXPECT_EQ(st.hits + st.misses, 800u);
+        EXPECT_LE(st.steals, st.hits);
+
+        // Buffers released by the other threads are reused
+        auto a = pool.make_tensor<float, 2>({8, 8});
+        EXPECT_EQ(pool.statistics().hits, st.hits + 1);
+    }
+}
@@ -16,6 +16,7 @@
 #include "xtensor/xrandom.hpp"
 #endif
 #include "xtensor/xarray.hpp"
+#include "xtensor/xmath.hpp"
 #include "xtensor/xview.hpp"
 
 namespace xt
@@ -150,4 +151,145 @@ namespace xt
         auto r2 = xt::random::permutation(ac1);
         EXPECT_EQ(a1, r2);
     }
+
+    TEST(xrandom, counter_based_engine)
+    {
+        // Known answers from the reference implementation
+        using philox_bijection = detail::philox4x32_bijection;
+        philox_bijection::block_type p = philox_bijection::apply({{0, 0, 0, 0}}, {{0, 0}});
+        philox_bijection::block_type p_expected = {{0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u}};
+        EXPECT_EQ(p, p_expected);
+        p = philox_bijection::apply({{0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u}}, {{0xa4093822u, 0x299f31d0u}});
+        p_expected = {{0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u}};
+        EXPECT_EQ(p, p_expected);
+        using threefry_bijection = detail::threefry2x64_bijection;
+        threefry_bijection::block_type t = threefry_bijection::apply({{0, 0}}, {{0, 0}});
+        threefry_bijection::block_type t_expected = {{0xc2b6e3a8c2c69865ull, 0x6f81ed42f350084dull}};
+        EXPECT_EQ(t, t_expected);
+
+        random::philox4x32 e1(42);
+        random::philox4x32 e2(42);
+        auto b = e1.block(0, 1);
+        e2.discard(3);
+        EXPECT_EQ(e2(), e1.block(0, 0)[3]);
+        EXPECT_EQ(e2(), b[0]);
+        e2.discard(5);
+        EXPECT_EQ(e2(), e1.block(0, 2)[2]);
+        EXPECT_NE(e1, e2);
+        e2.seed(42);
+        EXPECT_EQ(e1, e2);
+
+        // Usable with the distributions of the standard library
+        random::threefry2x64 e3(7);
+        std::uniform_int_distribution<int> dist(0, 9);
+        int n = dist(e3);
+        EXPECT_TRUE(n >= 0 && n <= 9);
+        EXPECT_NE(e3.block(0, 0), random::threefry2x64(8).block(0, 0));
+    }
+
+    TEST(xrandom, counter_based)
+    {
+        random::philox4x32 engine(1234);
+        auto r = random::rand<double>({40, 50}, 0., 1., engine);
+        xtensor<double, 2> a = r;
+        xtensor<double, 2, layout_type::column_major> a_c = r;
+        EXPECT_EQ(a, a_c);
+        EXPECT_EQ(r(3, 4), a(3, 4));
+        std::array<std::size_t, 2> index = {{39, 49}};
+        EXPECT_EQ(r.element(index.cbegin(), index.cend()), a(39, 49));
+        xtensor<double, 1> row = view(r, 7, range(10, 20));
+        EXPECT_EQ(row, view(a, 7, range(10, 20)));
+        EXPECT_TRUE(all(a >= 0. && a < 1.));
+        EXPECT_NEAR(mean(a)(), 0.5, 0.05);
+
+        // The next expression uses the next streams
+        xtensor<double, 2> b = random::rand<double>({40, 50}, 0., 1., engine);
+        EXPECT_NE(a, b);
+        random::philox4x32 same(1234);
+        xtensor<double, 2> c = random::rand<double>({40, 50}, 0., 1., same);
+        EXPECT_EQ(a, c);
+
+        // The value at a flat index does not depend on the shape
+        random::philox4x32 flat_engine(1234);
+        xtensor<double, 1> flat = random::rand<double>({2000}, 0., 1., flat_engine);
+        EXPECT_EQ(flat(2 * 50 + 5), a(2, 5));
+
+        random::threefry2x64 t_engine(5);
+        auto n = random::randn<double>({200, 500}, 2., 3., t_engine);
+        xtensor<double, 2> n1 = n;
+        EXPECT_NEAR(mean(n1)(), 2., 0.05);
+        EXPECT_NEAR(std::sqrt(mean(square(n1 - 2.))()), 3., 0.05);
+
+        // Same values whatever the number of threads
+        set_num_threads(4);
+        xtensor<double, 2> n4 = n;
+        xtensor<float, 2> f4 = random::randn<float>({300, 300}, 0.f, 1.f, t_engine);
+        set_num_threads(0);
+        EXPECT_EQ(n1, n4);
+        xtensor<float, 2> f1 = random::randn<float>({300, 300}, 0.f, 1.f, t_engine);
+        EXPECT_NE(f1, f4);
+        t_engine.set_stream(t_engine.stream() - 2 * 300 * 300);
+        f1 = random::randn<float>({300, 300}, 0.f, 1.f, t_engine);
+        EXPECT_EQ(f1, f4);
+
+        random::philox4x32 engine_copy = engine;
+        xtensor<int, 2> i = random::randint<int>({30, 30}, 3, 8, engine);
+        EXPECT_TRUE(all(i >= 3 && i < 8));
+        EXPECT_EQ(i, random::randint<int>({30, 30}, 3, 8, engine_copy));
+
+        // An expression does not reuse the stream drawn sequentially
+        random::philox4x32 seq_engine(99);
+        std::uniform_real_distribution<double> dist(0., 1.);
+        dist(seq_engine);
+        EXPECT_EQ(seq_engine.position(), 1u);
+        xtensor<double, 1> s = random::rand<double>({10}, 0., 1., seq_engine);
+        EXPECT_EQ(seq_engine.stream(), 11u);
+        EXPECT_EQ(seq_engine.position(), 0u);
+        random::philox4x32 next_engine(99, 1);
+        EXPECT_EQ(s, random::rand<double>({10}, 0., 1., next_engine));
+    }
+
+    TEST(xrandom, distributions)
+    {
+        random::seed(0);
+        xtensor<double, 1> n = random::randn<double>({100000}, 1., 2.);
+        EXPECT_NEAR(mean(n)(), 1., 0.05);
+        EXPECT_NEAR(std::sqrt(mean(square(n - 1.))()), 2., 0.05);
+        // Symmetric, with tails
+        EXPECT_NEAR(mean(n > 1.)(), 0.5, 0.01);
+        EXPECT_NEAR(mean(abs(n - 1.) > 6.)(), 0.0027, 0.001);
+
+        xtensor<double, 1> e = random::exponential<double>({100000}, 4.);
+        EXPECT_TRUE(all(e >= 0.));
+        EXPECT_NEAR(mean(e)(), 0.25, 0.01);
+        EXPECT_NEAR(mean(e > 1.)(), std::exp(-4.), 0.002);
+
+        xtensor<double, 1> g = random::gamma<double>({100000}, 3., 2.);
+        EXPECT_TRUE(all(g > 0.));
+        EXPECT_NEAR(mean(g)(), 6., 0.1);
+        xtensor<float, 1> gs = random::gamma<float>({100000}, 0.5f, 1.f);
+        EXPECT_NEAR(mean(gs)(), 0.5f, 0.02f);
+
+        xtensor<int, 1> p = random::poisson<int>({100000}, 4.);
+        EXPECT_TRUE(all(p >= 0));
+        EXPECT_NEAR(mean(p)(), 4., 0.05);
+        EXPECT_NEAR(mean(equal(p, 0))(), std::exp(-4.), 0.005);
+        xtensor<long, 1> pl = random::poisson<long>({100000}, 250.);
+        EXPECT_NEAR(mean(pl)(), 250., 0.5);
+        EXPECT_NEAR(std::sqrt(mean(square(pl - 250.))()), std::sqrt(250.), 0.5);
+
+        // Same values when filling the container and drawing the elements
+        random::philox4x32 engine(3);
+        auto ce = random::exponential<double>({50, 40}, 1., engine);
+        auto cn = random::randn<float>({50, 40}, 0.f, 1.f, engine);
+        auto cp = random::poisson<int>({50, 40}, 30., engine);
+        xtensor<double, 2> ae = ce;
+        xtensor<float, 2> an = cn;
+        xtensor<int, 2> ap = cp;
+        EXPECT_EQ(ae(49, 39), ce(49, 39));
+        EXPECT_EQ(an(17, 3), cn(17, 3));
+        EXPECT_EQ(ap(8, 21), cp(8, 21));
+        xtensor<float, 2> vn = view(cn, all(), all());
+        EXPECT_EQ(an, vn);
+    }
 }
@@ -13,6 +13,7 @@
 #include "xtensor/xfixed.hpp"
 #include "xtensor/xbuilder.hpp"
 #include "xtensor/xmath.hpp"
+#include "xtensor/xnorm.hpp"
 #include "xtensor/xreducer.hpp"
 #include "xtensor/xview.hpp"
 #include "xtensor/xmanipulation.hpp"
@@ -512,4 +513,61 @@ namespace xt
         EXPECT_EQ(b.dimension(), 0u);
         EXPECT_EQ(minmax(b)(), (A{1.2, 1.2}));
     }
+
+    TEST(xreducer, simd_reducer_traits)
+    {
+        EXPECT_TRUE(simd_reducer_traits<std::plus<double>>::value);
+        EXPECT_TRUE(simd_reducer_traits<std::multiplies<double>>::value);
+        EXPECT_TRUE(simd_reducer_traits<math::maximum<double>>::value);
+        EXPECT_TRUE(simd_reducer_traits<math::minimum<double>>::value);
+        EXPECT_TRUE(simd_reducer_traits<xtl::identity>::value);
+        EXPECT_FALSE(simd_reducer_traits<std::minus<double>>::value);
+    }
+
+    TEST(xreducer, contiguous_kernels)
+    {
+        // sizes around multiples of the batch sizes exercise the
+        // vectorized loops as well as their scalar tails
+        for (std::size_t n = 1; n < 70; ++n)
+        {
+            xtensor<double, 2> a = xtensor<double, 2>::from_shape({3, n});
+            for (std::size_t i = 0; i < a.size(); ++i)
+            {
+                a.storage()[i] = double((i * 37) % 101) - 50.;
+            }
+
+            double s = 0., sq = 0., mx = a.storage()[0], l1 = 0.;
+            for (auto v : a.storage())
+            {
+                s += v;
+                sq += v * v;
+                mx = std::max(mx, v);
+                l1 += std::abs(v);
+            }
+            EXPECT_EQ(sum(a, evaluation_strategy::immediate())(), s);
+            EXPECT_EQ(sum(a)(), s);
+            EXPECT_EQ(amax(a, evaluation_strategy::immediate())(), mx);
+            EXPECT_EQ(amax(a)(), mx);
+            EXPECT_EQ(norm_sq(a, evaluation_strategy::immediate())(), sq);
+            EXPECT_EQ(norm_l1(a)(), l1);
+
+            xtensor<double, 1> s0 = sum(a, {0}, evaluation_strategy::immediate());
+            xtensor<double, 1> s1 = sum(a, {1}, evaluation_strategy::immediate());
+            xtensor<double, 1> m0 = amax(a, {0});
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                EXPECT_EQ(s0(j), a(0, j) + a(1, j) + a(2, j));
+                EXPECT_EQ(m0(j), std::max(std::max(a(0, j), a(1, j)), a(2, j)));
+            }
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                double expected = 0.;
+                for (std::size_t j = 0; j < n; ++j)
+                {
+                    expected += a(i, j);
+                }
+                EXPECT_EQ(s1(i), expected);
+            }
+        }
+    }
 }
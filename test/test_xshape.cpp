@@ -134,6 +134,104 @@ namespace xt
         }
     }
 
+    TEST(svector, move)
+    {
+        vector_type a(10);
+        std::iota(a.begin(), a.end(), std::size_t(0));
+        const std::size_t* data = a.data();
+        vector_type b(std::move(a));
+        EXPECT_EQ(data, b.data());
+        EXPECT_EQ(size_t(10), b.size());
+        EXPECT_TRUE(a.empty());
+
+        vector_type c = {1, 2};
+        c = std::move(b);
+        EXPECT_EQ(data, c.data());
+        EXPECT_EQ(size_t(9), c[9]);
+
+        vector_type d = {1, 2};
+        vector_type e(std::move(d));
+        EXPECT_EQ(size_t(2), e.size());
+        EXPECT_EQ(size_t(2), e[1]);
+        EXPECT_TRUE(e.on_stack());
+    }
+
+    namespace
+    {
+        template <class T>
+        struct id_allocator : std::allocator<T>
+        {
+            using propagate_on_container_move_assignment = std::false_type;
+
+            template <class U>
+            struct rebind
+            {
+                using other = id_allocator<U>;
+            };
+
+            id_allocator(int i = 0) noexcept
+                : id(i)
+            {
+            }
+
+            template <class U>
+            id_allocator(const id_allocator<U>& rhs) noexcept
+                : id(rhs.id)
+            {
+            }
+
+            int id;
+        };
+
+        template <class T, class U>
+        bool operator==(const id_allocator<T>& lhs, const id_allocator<U>& rhs) noexcept
+        {
+            return lhs.id == rhs.id;
+        }
+
+        template <class T, class U>
+        bool operator!=(const id_allocator<T>& lhs, const id_allocator<U>& rhs) noexcept
+        {
+            return lhs.id != rhs.id;
+        }
+    }
+
+    TEST(svector, move_stateful_allocator)
+    {
+        using alloc_vector_type = svector<std::size_t, 4, id_allocator<std::size_t>>;
+
+        alloc_vector_type a(10, id_allocator<std::size_t>(1));
+        std::iota(a.begin(), a.end(), std::size_t(0));
+        const std::size_t* data = a.data();
+
+        // Unequal allocators that are not propagated: elements are moved
+        alloc_vector_type b(2, id_allocator<std::size_t>(2));
+        b = std::move(a);
+        EXPECT_NE(data, b.data());
+        EXPECT_EQ(2, b.get_allocator().id);
+        EXPECT_EQ(size_t(10), b.size());
+        EXPECT_EQ(size_t(9), b[9]);
+
+        // Equal allocators: the buffer is stolen
+        alloc_vector_type c(2, id_allocator<std::size_t>(2));
+        const std::size_t* b_data = b.data();
+        c = std::move(b);
+        EXPECT_EQ(b_data, c.data());
+        EXPECT_EQ(size_t(9), c[9]);
+    }
+
+    TEST(svector, uninitialized_resize)
+    {
+        vector_type a = {1, 2, 3};
+        a.resize(2, uninitialized);
+        EXPECT_TRUE(a.on_stack());
+        EXPECT_EQ(size_t(2), a.size());
+        a.resize(100, uninitialized);
+        EXPECT_FALSE(a.on_stack());
+        EXPECT_EQ(size_t(100), a.size());
+        EXPECT_LE(size_t(100), a.capacity());
+    }
+
     TEST(svector, access)
     {
         vector_type a(10);
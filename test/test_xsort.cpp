@@ -16,6 +16,10 @@
 #include "xtensor/xrandom.hpp"
 #include "xtensor/xslice.hpp"
 #include "xtensor/xsort.hpp"
+#include "xtensor/xbuilder.hpp"
+#include "xtensor/xindex_view.hpp"
+#include "xtensor/xmath.hpp"
+#include "xtensor/xstrided_view.hpp"
 
 namespace xt
 {
@@ -70,6 +74,21 @@ namespace xt
         }
     }
 
+    TEST(xsort, argsort_stable)
+    {
+        xarray<int> a = {3, 1, 3, 2, 1, 3, 2, 1};
+        xarray<std::size_t> ex = {1, 4, 7, 3, 6, 0, 2, 5};
+        EXPECT_EQ(ex, argsort(a, xnone(), sorting_method::stable));
+        EXPECT_EQ(ex, argsort(a, 0, sorting_method::stable));
+
+        xarray<int> b = {{2, 1, 2, 1}, {0, 0, 0, 0}};
+        xarray<std::size_t> ex_b = {{1, 3, 0, 2}, {0, 1, 2, 3}};
+        EXPECT_EQ(ex_b, argsort(b, 1, sorting_method::stable));
+
+        xarray<std::size_t> ex_flat = {4, 5, 6, 7, 1, 3, 0, 2};
+        EXPECT_EQ(ex_flat, argsort(b, xnone(), sorting_method::stable));
+    }
+
     TEST(xsort, sort_easy)
     {
         xarray<double> a = {{5, 3, 1}, {4, 4, 4}};
@@ -128,6 +147,46 @@ namespace xt
 
     }
 
+    namespace
+    {
+        constexpr layout_type other_layout = XTENSOR_DEFAULT_LAYOUT == layout_type::row_major ?
+            layout_type::column_major : layout_type::row_major;
+    }
+
+    TEST(xsort, argmin_mixed_layout)
+    {
+        xtensor<double, 3> a = {{{5, 3}, {1, 7}, {4, 2}}, {{0, 9}, {8, 6}, {3, 11}}};
+        xtensor<double, 3, other_layout> b = a;
+
+        xarray<std::size_t> ex_1 = {{1, 2}, {0, 1}};
+        EXPECT_EQ(ex_1, argmin(b, 1));
+        EXPECT_EQ(argmin(a, 0), argmin(b, 0));
+        EXPECT_EQ(argmin(a, 2), argmin(b, 2));
+
+        xarray<std::size_t> ex_max = {{0, 1}, {1, 2}};
+        EXPECT_EQ(ex_max, argmax(b, 1));
+    }
+
+    TEST(xsort, argsort_dynamic_layout)
+    {
+        xtensor<double, 3> a = {{{5, 3}, {1, 7}, {4, 2}}, {{0, 9}, {8, 6}, {3, 11}}};
+        xarray<double, layout_type::dynamic> b;
+        b.resize({2, 3, 2}, other_layout);
+        b = a;
+
+        for (std::ptrdiff_t axis = 0; axis < 3; ++axis)
+        {
+            xarray<std::size_t> ex = argsort(a, axis);
+            xarray<std::size_t> res = argsort(b, axis);
+            EXPECT_EQ(ex, res);
+        }
+
+        xarray<std::size_t> ia = argpartition(b, 0, 1);
+        xarray<std::size_t> ex_min = argmin(a, 1);
+        xarray<std::size_t> res_min = view(ia, all(), 0, all());
+        EXPECT_EQ(ex_min, res_min);
+    }
+
     TEST(xsort, argmax)
     {
         xarray<double> a = {{5, 3, 1}, {4, 4, 4}};
@@ -142,7 +201,7 @@ namespace xt
 
         xt::xtensor<int, 2> b = {{ 1,2 }};
         auto res = xt::eval(xt::argmax(b, 1));
-        EXPECT_EQ(res(), 0u);
+        EXPECT_EQ(res(), 1u);
     }
 
     TEST(xsort, sort_large_prob)
@@ -205,6 +264,54 @@ namespace xt
         }
     }
 
+    template <layout_type L>
+    void check_axis_functions()
+    {
+        using tensor_type = xtensor<double, 3, L>;
+        random::seed(0);
+        tensor_type a = random::rand<double>({4, 1, 33});
+        tensor_type b = random::rand<double>({6, 5, 7});
+        for (const tensor_type& t : {a, b})
+        {
+            for (std::size_t axis = 0; axis < 3; ++axis)
+            {
+                xarray<double> st = sort(t, std::ptrdiff_t(axis));
+                xarray<std::size_t> ast = argsort(t, std::ptrdiff_t(axis));
+                xarray<std::size_t> amin = argmin(t, axis);
+                xarray<std::size_t> amax = argmax(t, axis);
+                xarray<double> tmax = xt::amax(t, {axis});
+                for (std::size_t i = 0; i < tmax.shape()[0]; ++i)
+                {
+                    for (std::size_t j = 0; j < tmax.shape()[1]; ++j)
+                    {
+                        xstrided_slice_vector sv({std::ptrdiff_t(i), std::ptrdiff_t(j)});
+                        sv.insert(sv.begin() + std::ptrdiff_t(axis), all());
+                        xtensor<double, 1> lane = strided_view(t, sv);
+                        xtensor<double, 1> slane = strided_view(st, sv);
+                        xtensor<std::size_t, 1> alane = strided_view(ast, sv);
+                        std::vector<double> expected(lane.cbegin(), lane.cend());
+                        std::sort(expected.begin(), expected.end());
+                        for (std::size_t k = 0; k < lane.size(); ++k)
+                        {
+                            EXPECT_EQ(slane(k), expected[k]);
+                            EXPECT_EQ(lane(alane(k)), expected[k]);
+                        }
+                        auto min_it = std::min_element(lane.cbegin(), lane.cend());
+                        auto max_it = std::max_element(lane.cbegin(), lane.cend());
+                        EXPECT_EQ(amin(i, j), std::size_t(std::distance(lane.cbegin(), min_it)));
+                        EXPECT_EQ(amax(i, j), std::size_t(std::distance(lane.cbegin(), max_it)));
+                    }
+                }
+            }
+        }
+    }
+
+    TEST(xsort, axis_functions)
+    {
+        check_axis_functions<layout_type::row_major>();
+        check_axis_functions<layout_type::column_major>();
+    }
+
     TEST(xsort, unique)
     {
         xarray<double> a = {1,2,3, 5,3,2,1,2,2,2,2,2,2, 45};
@@ -236,4 +343,139 @@ namespace xt
             EXPECT_EQ(setdiff1d(ar1, ar2), out);
         }
     }
+
+    template <class E, class K>
+    void check_partition(const E& part, const E& sorted, const K& kth)
+    {
+        for (auto k : kth)
+        {
+            EXPECT_EQ(part(k), sorted(k));
+            for (std::size_t i = 0; i < k; ++i)
+            {
+                EXPECT_LE(part(i), part(k));
+            }
+            for (std::size_t i = k + 1; i < part.size(); ++i)
+            {
+                EXPECT_GE(part(i), part(k));
+            }
+        }
+    }
+
+    TEST(xsort, partition)
+    {
+        random::seed(0);
+        xarray<double> a = random::rand<double>({17});
+        xarray<double> sa = sort(a);
+
+        std::vector<std::size_t> kth = {3, 0, 12, 16};
+        xarray<double> pa = partition(a, kth);
+        check_partition(pa, sa, kth);
+
+        xarray<double> pa1 = partition(a, 8);
+        check_partition(pa1, sa, std::vector<std::size_t>({8}));
+
+        xtensor<double, 1> fa = partition(xtensor<double, 2>(reshape_view(a, {1, 17})), kth, xnone());
+        check_partition(fa, xtensor<double, 1>(sa), kth);
+
+        xarray<std::size_t> ia = argpartition(a, kth);
+        xarray<double> ipa = index_view(a, ia);
+        check_partition(ipa, sa, kth);
+        xarray<std::size_t> sia = sort(ia);
+        EXPECT_EQ(sia, arange<std::size_t>(17));
+
+        EXPECT_THROW(partition(a, 17), std::runtime_error);
+    }
+
+    TEST(xsort, partition_axis)
+    {
+        random::seed(0);
+        xtensor<double, 3> a = random::rand<double>({5, 7, 6});
+        for (std::ptrdiff_t axis = 0; axis < 3; ++axis)
+        {
+            xtensor<double, 3> sa = sort(a, axis);
+            std::size_t k = std::size_t(a.shape()[std::size_t(axis)] / 2);
+            xtensor<double, 3> pa = partition(a, k, axis);
+            xtensor<std::size_t, 3> ia = argpartition(a, k, axis);
+            xtensor<double, 2> m = amax(a, {std::size_t(axis)});
+            for (std::size_t i = 0; i < m.shape()[0]; ++i)
+            {
+                for (std::size_t j = 0; j < m.shape()[1]; ++j)
+                {
+                    xstrided_slice_vector sv({std::ptrdiff_t(i), std::ptrdiff_t(j)});
+                    sv.insert(sv.begin() + axis, all());
+                    xtensor<double, 1> lane = strided_view(a, sv);
+                    xtensor<double, 1> plane = strided_view(pa, sv);
+                    xtensor<double, 1> slane = strided_view(sa, sv);
+                    xtensor<std::size_t, 1> ilane = strided_view(ia, sv);
+                    check_partition(plane, slane, std::vector<std::size_t>({k}));
+                    xtensor<double, 1> iplane = index_view(lane, ilane);
+                    check_partition(iplane, slane, std::vector<std::size_t>({k}));
+                }
+            }
+        }
+    }
+
+    inline double reference_quantile(xtensor<double, 1> sorted, double p)
+    {
+        double h = p * double(sorted.size() - 1);
+        std::size_t lo = std::size_t(std::floor(h));
+        std::size_t hi = std::min(lo + 1, sorted.size() - 1);
+        return sorted(lo) + (h - double(lo)) * (sorted(hi) - sorted(lo));
+    }
+
+    TEST(xsort, quantile)
+    {
+        xarray<int> a = {3, 1, 4, 1, 5, 9, 2, 6};
+        EXPECT_EQ(median(a), 3.5);
+        xarray<int> b = {3, 1, 4, 1, 5, 9, 2};
+        EXPECT_EQ(median(b), 3.);
+
+        std::vector<double> probas = {0., 0.1, 0.25, 0.5, 0.9, 1.};
+        xtensor<double, 1> q = quantile(a, probas);
+        xtensor<double, 1> sa = sort(a);
+        for (std::size_t i = 0; i < probas.size(); ++i)
+        {
+            EXPECT_DOUBLE_EQ(q(i), reference_quantile(sa, probas[i]));
+        }
+
+        std::vector<double> percents = {10., 50., 90.};
+        xtensor<double, 1> pc = percentile(a, percents);
+        EXPECT_DOUBLE_EQ(pc(0), q(1));
+        EXPECT_DOUBLE_EQ(pc(1), q(3));
+        EXPECT_DOUBLE_EQ(pc(2), q(4));
+
+        EXPECT_THROW(quantile(a, std::vector<double>({1.5})), std::runtime_error);
+    }
+
+    TEST(xsort, quantile_axis)
+    {
+        random::seed(0);
+        xtensor<double, 3> a = random::rand<double>({5, 8, 7});
+        std::vector<double> probas = {0.2, 0.5, 0.75};
+        for (std::ptrdiff_t axis = 0; axis < 3; ++axis)
+        {
+            xtensor<double, 3> sa = sort(a, axis);
+            xtensor<double, 3> q = quantile(a, probas, axis);
+            xtensor<double, 2> m = median(a, axis);
+            EXPECT_EQ(q.shape()[0], probas.size());
+            for (std::size_t i = 0; i < m.shape()[0]; ++i)
+            {
+                for (std::size_t j = 0; j < m.shape()[1]; ++j)
+                {
+                    xstrided_slice_vector sv({std::ptrdiff_t(i), std::ptrdiff_t(j)});
+                    sv.insert(sv.begin() + axis, all());
+                    xtensor<double, 1> slane = strided_view(sa, sv);
+                    EXPECT_DOUBLE_EQ(m(i, j), reference_quantile(slane, 0.5));
+                    for (std::size_t p = 0; p < probas.size(); ++p)
+                    {
+                        EXPECT_DOUBLE_EQ(q(p, i, j), reference_quantile(slane, probas[p]));
+                    }
+                }
+            }
+        }
+
+        xarray<double> b = a;
+        xarray<double> mb = median(b, 1);
+        EXPECT_EQ(mb, median(a, 1));
+    }
 }
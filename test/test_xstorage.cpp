@@ -47,6 +47,95 @@ namespace xt
         }
     }
 
+    namespace
+    {
+        struct init_counter
+        {
+            init_counter()
+            {
+                ++constructed;
+            }
+
+            init_counter(const init_counter&)
+            {
+                ++constructed;
+            }
+
+            ~init_counter()
+            {
+                ++destroyed;
+            }
+
+            static std::size_t constructed;
+            static std::size_t destroyed;
+        };
+
+        std::size_t init_counter::constructed = 0;
+        std::size_t init_counter::destroyed = 0;
+
+        template <class T>
+        struct construct_counting_allocator : std::allocator<T>
+        {
+            template <class U>
+            struct rebind
+            {
+                using other = construct_counting_allocator<U>;
+            };
+
+            construct_counting_allocator() = default;
+
+            template <class U>
+            construct_counting_allocator(const construct_counting_allocator<U>&) noexcept
+            {
+            }
+
+            template <class U, class... Args>
+            void construct(U* p, Args&&... args)
+            {
+                ++constructs;
+                ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+            }
+
+            static std::size_t constructs;
+        };
+
+        template <class T>
+        std::size_t construct_counting_allocator<T>::constructs = 0;
+    }
+
+    TEST(uvector, uninitialized)
+    {
+        using counter_vector = uvector<init_counter, construct_counting_allocator<init_counter>>;
+        using allocator_type = construct_counting_allocator<init_counter>;
+        init_counter::constructed = 0;
+        init_counter::destroyed = 0;
+        allocator_type::constructs = 0;
+        {
+            counter_vector a(10, uninitialized);
+            EXPECT_EQ(size_t(10), a.size());
+            EXPECT_EQ(size_t(10), init_counter::constructed);
+            EXPECT_EQ(size_t(0), allocator_type::constructs);
+
+            a.resize(20, uninitialized);
+            EXPECT_EQ(size_t(20), a.size());
+            EXPECT_EQ(size_t(30), init_counter::constructed);
+            EXPECT_EQ(size_t(10), init_counter::destroyed);
+            EXPECT_EQ(size_t(0), allocator_type::constructs);
+
+            a.resize(5);
+            EXPECT_EQ(size_t(5), a.size());
+            EXPECT_EQ(size_t(5), allocator_type::constructs);
+        }
+        EXPECT_EQ(init_counter::constructed, init_counter::destroyed);
+
+        vector_type b(10, uninitialized);
+        EXPECT_EQ(size_t(10), b.size());
+        b.resize(100, uninitialized);
+        EXPECT_EQ(size_t(100), b.size());
+        b[99] = 1.5;
+        EXPECT_EQ(1.5, b.back());
+    }
+
     TEST(uvector, access)
     {
         vector_type a(10);
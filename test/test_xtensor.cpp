@@ -171,6 +171,53 @@ namespace xt
         test_resize<xtensor_dynamic, storage_type>(a);
     }
 
+    TEST(xtensor, uninitialized)
+    {
+        xtensor<double, 2> a({3, 4}, uninitialized);
+        EXPECT_EQ(std::size_t(12), a.size());
+
+        auto b = xtensor<double, 3, layout_type::column_major>::from_shape({2, 3, 4}, uninitialized);
+        EXPECT_EQ(std::size_t(24), b.storage().size());
+        EXPECT_EQ(std::size_t(2), b.strides()[1]);
+
+        b.resize({4, 4, 4}, uninitialized);
+        EXPECT_EQ(std::size_t(64), b.storage().size());
+
+        xtensor<double, 0> c(std::array<std::size_t, 0>(), uninitialized);
+        EXPECT_EQ(std::size_t(1), c.size());
+    }
+
+    TEST(xtensor, small_buffer)
+    {
+        using small_type = xtensor_small<double, 2, 16>;
+        small_type a = {{1., 2., 3.}, {4., 5., 6.}, {7., 8., 9.}};
+        EXPECT_TRUE(a.storage().on_stack());
+
+        small_type b = a + a;
+        EXPECT_TRUE(b.storage().on_stack());
+        EXPECT_EQ(18., b(2, 2));
+
+        small_type c(b);
+        EXPECT_EQ(b, c);
+        small_type d(std::move(c));
+        EXPECT_EQ(b, d);
+
+        small_type e = small_type::from_shape({5, 5}, uninitialized);
+        EXPECT_FALSE(e.storage().on_stack());
+        e.fill(1.);
+        const double* data = e.data();
+        small_type f(std::move(e));
+        EXPECT_EQ(data, f.data());
+        EXPECT_EQ(1., f(4, 4));
+
+        f.resize({2, 2});
+        f = a * 2.;
+        EXPECT_EQ(b, f);
+
+        xtensor<double, 2> g = f;
+        EXPECT_EQ(g, b);
+    }
+
     TEST(xtensor, reshape)
     {
         xtensor_dynamic a;
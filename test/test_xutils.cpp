@@ -277,6 +277,51 @@ namespace xt
         EXPECT_NO_THROW(arr_t c = a);
     }
 
+    TEST(utils, allocation_statistics)
+    {
+        using arr_t = xarray<double, layout_type::row_major,
+                             tracking_allocator<double, std::allocator<double>, alloc_tracking::policy::statistics>>;
+
+        // No tracked buffer is alive when the statistics are reset
+        alloc_tracking::reset();
+        alloc_tracking::enable();
+        arr_t a = {{1, 2, 3}, {5, 6, 7}};
+        {
+            arr_t b = a + 123;
+            alloc_tracking::allocation_statistics stats = alloc_tracking::snapshot();
+            EXPECT_EQ(stats.allocations, 2u);
+            EXPECT_EQ(stats.bytes_allocated, 12 * sizeof(double));
+            EXPECT_EQ(stats.live_bytes, std::ptrdiff_t(12 * sizeof(double)));
+            EXPECT_EQ(stats.histogram[5], 2u);
+            {
+                alloc_tracking::tag_scope tag("resize");
+                a.resize({4, 100});
+            }
+            arr_t c = a;
+        }
+        alloc_tracking::disable();
+
+        alloc_tracking::allocation_statistics stats = alloc_tracking::snapshot();
+        EXPECT_EQ(stats.allocations, 4u);
+        EXPECT_EQ(stats.deallocations, 3u);
+        EXPECT_EQ(stats.bytes_allocated, (12 + 800) * sizeof(double));
+        // b, a after the resize and its copy c
+        EXPECT_EQ(stats.peak_live_bytes, std::ptrdiff_t(806 * sizeof(double)));
+        // The buffer of a before the resize is deallocated, c and b are destroyed
+        EXPECT_EQ(stats.live_bytes, std::ptrdiff_t(400 * sizeof(double)));
+        EXPECT_EQ(stats.histogram[11], 2u);
+
+        alloc_tracking::allocation_statistics tag_stats = alloc_tracking::snapshot("resize");
+        EXPECT_EQ(tag_stats.allocations, 1u);
+        EXPECT_EQ(tag_stats.bytes_allocated, 400 * sizeof(double));
+        std::vector<std::string> tags = alloc_tracking::tags();
+        EXPECT_NE(std::find(tags.begin(), tags.end(), "resize"), tags.end());
+
+        alloc_tracking::reset();
+        EXPECT_EQ(alloc_tracking::snapshot().allocations, 0u);
+        EXPECT_EQ(alloc_tracking::snapshot("resize").allocations, 0u);
+    }
+
     TEST(utils, static_dimension)
     {
         std::ptrdiff_t sdim = static_dimension<std::vector<int>>::value;
@@ -7,6 +7,7 @@
 ****************************************************************************/
 
 #include <algorithm>
+#include <numeric>
 
 #include "gtest/gtest.h"
 
@@ -1355,4 +1356,40 @@ namespace xt
         auto expv = xt::exp(xt::view(a, 1, xt::all(), xt::all(), xt::range(0, 3, 2)));
         EXPECT_EQ(assgment, expv);
     }
+
+    TEST(xview, strided_assign)
+    {
+        using namespace xt::placeholders;
+        xt::xtensor<double, 3> a = xt::xtensor<double, 3>::from_shape({4, 5, 6});
+        std::iota(a.storage().begin(), a.storage().end(), 0.);
+
+        // Constant step on the inner axis
+        auto v1 = xt::view(a, xt::all(), xt::all(), xt::range(0, 6, 2));
+        xt::xtensor<double, 3> r1 = v1;
+        // Negative step, the loops are reordered
+        auto v2 = xt::view(a, xt::range(3, _, -1), xt::all(), xt::range(1, 6, 2));
+        xt::xtensor<float, 3, xt::layout_type::column_major> r2 = v2;
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            for (std::size_t j = 0; j < 5; ++j)
+            {
+                for (std::size_t k = 0; k < 3; ++k)
+                {
+                    EXPECT_EQ(r1(i, j, k), a(i, j, 2 * k));
+                    EXPECT_EQ(r2(i, j, k), static_cast<float>(a(3 - i, j, 2 * k + 1)));
+                }
+            }
+        }
+
+        // Assignment to a view, with broadcasting
+        xt::xtensor<double, 1> row = {-1., -2., -3.};
+        v1 = row;
+        EXPECT_EQ(a(2, 3, 0), -1.);
+        EXPECT_EQ(a(2, 3, 1), 79.);
+        EXPECT_EQ(a(3, 4, 4), -3.);
+        xt::xtensor<double, 2> col = {{10.}, {11.}, {12.}, {13.}, {14.}};
+        xt::view(a, 1, xt::all(), xt::range(1, 6, 2)) = col;
+        EXPECT_EQ(a(1, 4, 5), 14.);
+        EXPECT_EQ(a(1, 4, 4), -3.);
+    }
 }